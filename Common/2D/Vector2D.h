@@ -10,7 +10,9 @@
 //
 //------------------------------------------------------------------------
 #include <math.h>
+#ifndef RAVEN_HEADLESS
 #include <windows.h>
+#endif
 #include <iosfwd>
 #include <limits>
 #include "misc/utils.h"
@@ -299,6 +301,7 @@ inline double Vec2DLengthSq(const Vector2D& v)
 }
 
 
+#ifndef RAVEN_HEADLESS
 inline Vector2D POINTStoVector(const POINTS& p)
 {
   return Vector2D(p.x, p.y);
@@ -326,6 +329,7 @@ inline POINT VectorToPOINT(const Vector2D& v)
 
   return p;
 }
+#endif
 
 
 
@@ -1,3 +1,5 @@
+#ifndef WALL_INTERSECTION_TESTS_H
+#define WALL_INTERSECTION_TESTS_H
 //-----------------------------------------------------------------------------
 //
 //  Name:   WallIntersectionTests.h
@@ -6,10 +8,15 @@
 //
 //  Desc:   a few functions for testing line segments against containers of
 //          walls
+//
+//          Each test is overloaded for a WallSpacePartition. Pass the
+//          partition instead of a plain container of walls to have the test
+//          examine only the walls near the query.
 //-----------------------------------------------------------------------------
 
-#include "2d/Vector2D.h"
-#include "2d/Wall2d.h"
+#include "2D/Vector2D.h"
+#include "2D/Wall2D.h"
+#include "2D/WallSpacePartition.h"
 
 
 //----------------------- doWallsObstructLineSegment --------------------------
@@ -24,7 +31,7 @@ inline bool doWallsObstructLineSegment(Vector2D from,
                                        const ContWall& walls)
 {
   //test against the walls
-  ContWall::const_iterator curWall = walls.begin();
+  typename ContWall::const_iterator curWall = walls.begin();
 
   for (curWall; curWall != walls.end(); ++curWall)
   {
@@ -38,6 +45,13 @@ inline bool doWallsObstructLineSegment(Vector2D from,
   return false;
 }
 
+inline bool doWallsObstructLineSegment(Vector2D                  from,
+                                       Vector2D                  to,
+                                       const WallSpacePartition& walls)
+{
+  return walls.isSegmentObstructed(from, to);
+}
+
 
 //----------------------- doWallsObstructCylinderSides -------------------------
 //
@@ -94,7 +108,7 @@ inline bool FindClosestPointOfIntersectionWithWalls(Vector2D        A,
 {
   distance = MaxDouble;
 
-  ContWall::const_iterator curWall = walls.begin();
+  typename ContWall::const_iterator curWall = walls.begin();
   for (curWall; curWall != walls.end(); ++curWall)
   {
     double dist = 0.0;
@@ -115,6 +129,15 @@ inline bool FindClosestPointOfIntersectionWithWalls(Vector2D        A,
   return false;
 }
 
+inline bool FindClosestPointOfIntersectionWithWalls(Vector2D                  A,
+                                                    Vector2D                  B,
+                                                    double&                   distance,
+                                                    Vector2D&                 ip,
+                                                    const WallSpacePartition& walls)
+{
+  return walls.FindClosestIntersection(A, B, distance, ip);
+}
+
 //------------------------ doWallsIntersectCircle -----------------------------
 //
 //  returns true if any walls intersect the circle of radius at point p
@@ -123,7 +146,7 @@ template <class ContWall>
 inline bool doWallsIntersectCircle(const ContWall& walls, Vector2D p, double r)
 {
   //test against the walls
-  ContWall::const_iterator curWall = walls.begin();
+  typename ContWall::const_iterator curWall = walls.begin();
 
   for (curWall; curWall != walls.end(); ++curWall)
   {
@@ -137,4 +160,10 @@ inline bool doWallsIntersectCircle(const ContWall& walls, Vector2D p, double r)
   return false;
 }
 
+inline bool doWallsIntersectCircle(const WallSpacePartition& walls, Vector2D p, double r)
+{
+  return walls.doesCircleIntersect(p, r);
+}
+
 
+#endif
@@ -0,0 +1,644 @@
+#ifndef WALLSPACEPARTITION_H
+#define WALLSPACEPARTITION_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   WallSpacePartition.h
+//
+//  Desc:   a uniform grid used to speed up line of sight, ray and proximity
+//          queries against the walls of a map. Each wall is stored in every
+//          cell it passes through. A line segment query walks the cells the
+//          segment crosses in order (a DDA traversal) and only tests the walls
+//          stored in those cells, so the cost of a query depends on its length
+//          rather than on the number of walls in the map.
+//
+//          Walls that lie partly outside the partitioned area are kept in a
+//          separate list that is tested by every query.
+//
+//          Walls that are able to move (such as those belonging to doors)
+//          must be moved by calling MoveWall. This refits the wall by taking
+//          it out of the cells it occupied and adding it to the cells it
+//          now passes through, so only the cells touched by the moving
+//          wall are updated.
+//
+//          The queries don't modify the partition so they may be made from
+//          more than one thread at a time, providing no wall is moved while
+//          they are being made.
+//
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "2D/Vector2D.h"
+#include "2D/Wall2D.h"
+#include "2D/geometry.h"
+#include "misc/utils.h"
+
+
+
+class WallSpacePartition
+{
+private:
+
+  typedef std::vector<Wall2D*> WallList;
+
+  //the walls passing through each cell
+  std::vector<WallList>  m_Cells;
+
+  //walls that are tested by every query
+  WallList               m_UnpartitionedWalls;
+
+  //the width and height of the partitioned space
+  double  m_dSpaceWidth;
+  double  m_dSpaceHeight;
+
+  int     m_iNumCellsX;
+  int     m_iNumCellsY;
+
+  double  m_dCellSizeX;
+  double  m_dCellSizeY;
+
+  //walls are added to any cell they pass within this distance of. This
+  //makes sure rounding errors can't cause a wall to be missed by a query
+  //that passes along the edge of a cell
+  static double CellMargin(){return 1.0;}
+
+  //given a coordinate these return the column/row of the cell it falls in,
+  //clamped to the grid
+  inline int  ClampCellX(double x)const;
+  inline int  ClampCellY(double y)const;
+
+  //clips the segment AB to the box (left, top)-(right, bottom). Returns
+  //false if the segment misses the box, else t0 and t1 are set to the
+  //parametric positions along AB of the clipped end points
+  static inline bool ClipSegment(Vector2D A, Vector2D B,
+                                 double left, double top,
+                                 double right, double bottom,
+                                 double& t0, double& t1);
+
+  //used by ClipSegment to clip against each edge of the box in turn
+  static inline bool ClipEdge(double p, double q, double& t0, double& t1);
+
+  //the range of cells a wall from A to B is stored in
+  inline void GetCellRange(Vector2D A, Vector2D B,
+                           int& left, int& top,
+                           int& right, int& bottom)const;
+
+  //returns true if the wall from A to B lies entirely within the
+  //partitioned area
+  inline bool isInside(Vector2D A, Vector2D B)const;
+
+  //removes a wall from the cells it is stored in
+  inline void RemoveWall(Wall2D* pWall);
+
+  //walks the cells crossed by the segment AB, in the order they are crossed,
+  //calling visitor.VisitCell for each. VisitCell is passed the walls in the
+  //cell and the parametric position along AB at which the segment leaves
+  //the cell. The walk stops if VisitCell returns true. Returns true if the
+  //walk was stopped early
+  template <class visitor_type>
+  bool WalkSegment(Vector2D A, Vector2D B, visitor_type& visitor)const;
+
+  //cell visitors used by the queries below
+  struct ObstructionTest;
+  struct ClosestIntersectionTest;
+
+public:
+
+  WallSpacePartition(double width,   //width of the environment
+                     double height,  //height ...
+                     int    cellsX,  //number of cells horizontally
+                     int    cellsY); //number of cells vertically
+
+  //adds a wall to the cells it passes through
+  inline void AddWall(Wall2D* pWall);
+
+  //moves a wall that has previously been added to the partition so that
+  //it runs from NewFrom to NewTo, updating the cells it is stored in
+  inline void MoveWall(Wall2D* pWall, Vector2D NewFrom, Vector2D NewTo);
+
+  //returns true if any wall intersects the line segment AB
+  inline bool isSegmentObstructed(Vector2D A, Vector2D B)const;
+
+  //finds the closest intersection of a wall with the line segment AB. The
+  //distance to the intersection from A is stored in distance, the point of
+  //intersection in ip and, if pClosestWall isn't NULL, the wall itself in
+  //*pClosestWall. Returns false if no intersection point is found
+  inline bool FindClosestIntersection(Vector2D        A,
+                                      Vector2D        B,
+                                      double&         distance,
+                                      Vector2D&       ip,
+                                      const Wall2D**  pClosestWall = NULL)const;
+
+  //returns true if any wall intersects the circle of radius r at point p
+  inline bool doesCircleIntersect(Vector2D p, double r)const;
+
+  //returns true if any wall passes within r of the line segment AB. This
+  //is the area a circle of radius r sweeps moving from A to B
+  inline bool doesCapsuleIntersect(Vector2D A, Vector2D B, double r)const;
+
+  //call this to use the gdi to render the cell edges
+  inline void RenderCells()const;
+};
+
+
+//----------------------------- ctor ------------------------------------------
+//-----------------------------------------------------------------------------
+inline WallSpacePartition::WallSpacePartition(double width,
+                                              double height,
+                                              int    cellsX,
+                                              int    cellsY):m_Cells(cellsX*cellsY),
+                                                             m_dSpaceWidth(width),
+                                                             m_dSpaceHeight(height),
+                                                             m_iNumCellsX(cellsX),
+                                                             m_iNumCellsY(cellsY)
+{
+  m_dCellSizeX = width  / cellsX;
+  m_dCellSizeY = height / cellsY;
+}
+
+//-------------------------- ClampCellX/ClampCellY ----------------------------
+//-----------------------------------------------------------------------------
+inline int WallSpacePartition::ClampCellX(double x)const
+{
+  int col = (int)floor(x / m_dCellSizeX);
+
+  if (col < 0) return 0;
+  if (col > m_iNumCellsX-1) return m_iNumCellsX-1;
+
+  return col;
+}
+
+inline int WallSpacePartition::ClampCellY(double y)const
+{
+  int row = (int)floor(y / m_dCellSizeY);
+
+  if (row < 0) return 0;
+  if (row > m_iNumCellsY-1) return m_iNumCellsY-1;
+
+  return row;
+}
+
+//------------------------------ ClipSegment ----------------------------------
+//
+//  Liang-Barsky line clipping
+//-----------------------------------------------------------------------------
+inline bool WallSpacePartition::ClipEdge(double p, double q, double& t0, double& t1)
+{
+  if (p == 0)
+  {
+    //parallel to this edge so either wholly inside or wholly outside
+    return q >= 0;
+  }
+
+  double t = q / p;
+
+  if (p < 0)
+  {
+    if (t > t1) return false;
+    if (t > t0) t0 = t;
+  }
+  else
+  {
+    if (t < t0) return false;
+    if (t < t1) t1 = t;
+  }
+
+  return true;
+}
+
+inline bool WallSpacePartition::ClipSegment(Vector2D A, Vector2D B,
+                                            double left, double top,
+                                            double right, double bottom,
+                                            double& t0, double& t1)
+{
+  double dx = B.x - A.x;
+  double dy = B.y - A.y;
+
+  t0 = 0.0;
+  t1 = 1.0;
+
+  return ClipEdge(-dx, A.x - left,   t0, t1) &&
+         ClipEdge( dx, right - A.x,  t0, t1) &&
+         ClipEdge(-dy, A.y - top,    t0, t1) &&
+         ClipEdge( dy, bottom - A.y, t0, t1);
+}
+
+//------------------------------ GetCellRange ---------------------------------
+//-----------------------------------------------------------------------------
+inline void WallSpacePartition::GetCellRange(Vector2D A, Vector2D B,
+                                             int& left, int& top,
+                                             int& right, int& bottom)const
+{
+  const double margin = CellMargin();
+
+  left   = ClampCellX(MinOf(A.x, B.x) - margin);
+  right  = ClampCellX(MaxOf(A.x, B.x) + margin);
+  top    = ClampCellY(MinOf(A.y, B.y) - margin);
+  bottom = ClampCellY(MaxOf(A.y, B.y) + margin);
+}
+
+//-------------------------------- isInside -----------------------------------
+//-----------------------------------------------------------------------------
+inline bool WallSpacePartition::isInside(Vector2D A, Vector2D B)const
+{
+  return MinOf(A.x, B.x) >= 0 && MaxOf(A.x, B.x) <= m_dSpaceWidth &&
+         MinOf(A.y, B.y) >= 0 && MaxOf(A.y, B.y) <= m_dSpaceHeight;
+}
+
+//-------------------------------- AddWall ------------------------------------
+//
+//  the wall is added to every cell it passes within CellMargin of. If any
+//  part of the wall is outside the partitioned area it is tested by every
+//  query instead
+//-----------------------------------------------------------------------------
+inline void WallSpacePartition::AddWall(Wall2D* pWall)
+{
+  Vector2D A = pWall->From();
+  Vector2D B = pWall->To();
+
+  if (!isInside(A, B))
+  {
+    m_UnpartitionedWalls.push_back(pWall);
+
+    return;
+  }
+
+  const double margin = CellMargin();
+
+  int left, top, right, bottom;
+  GetCellRange(A, B, left, top, right, bottom);
+
+  for (int y=top; y<=bottom; ++y)
+  {
+    for (int x=left; x<=right; ++x)
+    {
+      double t0, t1;
+
+      if (ClipSegment(A, B,
+                      x*m_dCellSizeX - margin,
+                      y*m_dCellSizeY - margin,
+                      (x+1)*m_dCellSizeX + margin,
+                      (y+1)*m_dCellSizeY + margin,
+                      t0, t1))
+      {
+        m_Cells[y*m_iNumCellsX + x].push_back(pWall);
+      }
+    }
+  }
+}
+
+//------------------------------- RemoveWall ----------------------------------
+//
+//  the cells the wall is stored in are found from its current position so
+//  this must be called before the wall is moved
+//-----------------------------------------------------------------------------
+inline void WallSpacePartition::RemoveWall(Wall2D* pWall)
+{
+  Vector2D A = pWall->From();
+  Vector2D B = pWall->To();
+
+  if (!isInside(A, B))
+  {
+    m_UnpartitionedWalls.erase(std::remove(m_UnpartitionedWalls.begin(),
+                                           m_UnpartitionedWalls.end(),
+                                           pWall),
+                               m_UnpartitionedWalls.end());
+    return;
+  }
+
+  int left, top, right, bottom;
+  GetCellRange(A, B, left, top, right, bottom);
+
+  for (int y=top; y<=bottom; ++y)
+  {
+    for (int x=left; x<=right; ++x)
+    {
+      WallList& walls = m_Cells[y*m_iNumCellsX + x];
+
+      walls.erase(std::remove(walls.begin(), walls.end(), pWall), walls.end());
+    }
+  }
+}
+
+//-------------------------------- MoveWall -----------------------------------
+//-----------------------------------------------------------------------------
+inline void WallSpacePartition::MoveWall(Wall2D*  pWall,
+                                         Vector2D NewFrom,
+                                         Vector2D NewTo)
+{
+  RemoveWall(pWall);
+
+  pWall->SetFrom(NewFrom);
+  pWall->SetTo(NewTo);
+
+  AddWall(pWall);
+}
+
+//------------------------------ WalkSegment ----------------------------------
+//
+//  the segment is first clipped to the partitioned area, then the cells it
+//  crosses are stepped through using the method described by Amanatides & Woo
+//  in "A Fast Voxel Traversal Algorithm for Ray Tracing"
+//-----------------------------------------------------------------------------
+template <class visitor_type>
+bool WallSpacePartition::WalkSegment(Vector2D      A,
+                                     Vector2D      B,
+                                     visitor_type& visitor)const
+{
+  double tStart, tEnd;
+
+  if (!ClipSegment(A, B, 0, 0, m_dSpaceWidth, m_dSpaceHeight, tStart, tEnd))
+  {
+    return false;
+  }
+
+  Vector2D ToB = B - A;
+  Vector2D Start = A + ToB * tStart;
+
+  int x = ClampCellX(Start.x);
+  int y = ClampCellY(Start.y);
+
+  int    StepX, StepY;
+  double tMaxX, tMaxY, tDeltaX, tDeltaY;
+
+  if (ToB.x > 0)
+  {
+    StepX   = 1;
+    tMaxX   = ((x+1)*m_dCellSizeX - A.x) / ToB.x;
+    tDeltaX = m_dCellSizeX / ToB.x;
+  }
+  else if (ToB.x < 0)
+  {
+    StepX   = -1;
+    tMaxX   = (x*m_dCellSizeX - A.x) / ToB.x;
+    tDeltaX = -m_dCellSizeX / ToB.x;
+  }
+  else
+  {
+    StepX   = 0;
+    tMaxX   = MaxDouble;
+    tDeltaX = MaxDouble;
+  }
+
+  if (ToB.y > 0)
+  {
+    StepY   = 1;
+    tMaxY   = ((y+1)*m_dCellSizeY - A.y) / ToB.y;
+    tDeltaY = m_dCellSizeY / ToB.y;
+  }
+  else if (ToB.y < 0)
+  {
+    StepY   = -1;
+    tMaxY   = (y*m_dCellSizeY - A.y) / ToB.y;
+    tDeltaY = -m_dCellSizeY / ToB.y;
+  }
+  else
+  {
+    StepY   = 0;
+    tMaxY   = MaxDouble;
+    tDeltaY = MaxDouble;
+  }
+
+  while (true)
+  {
+    double tExit = MinOf(MinOf(tMaxX, tMaxY), tEnd);
+
+    if (visitor.VisitCell(m_Cells[y*m_iNumCellsX + x], tExit)) return true;
+
+    if (tExit >= tEnd) return false;
+
+    //step into the next cell
+    if (tMaxX < tMaxY)
+    {
+      x     += StepX;
+      tMaxX += tDeltaX;
+    }
+    else
+    {
+      y     += StepY;
+      tMaxY += tDeltaY;
+    }
+
+    if (x < 0 || x >= m_iNumCellsX || y < 0 || y >= m_iNumCellsY) return false;
+  }
+}
+
+//---------------------------- ObstructionTest --------------------------------
+//-----------------------------------------------------------------------------
+struct WallSpacePartition::ObstructionTest
+{
+  Vector2D A, B;
+
+  ObstructionTest(Vector2D a, Vector2D b):A(a), B(b){}
+
+  bool VisitCell(const WallList& walls, double tExit)
+  {
+    WallList::const_iterator curWall = walls.begin();
+    for (curWall; curWall != walls.end(); ++curWall)
+    {
+      if (LineIntersection2D(A, B, (*curWall)->From(), (*curWall)->To()))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+};
+
+//------------------------- ClosestIntersectionTest ---------------------------
+//
+//  because the cells are visited in order the walk can stop as soon as the
+//  closest intersection found lies within the cells already visited
+//-----------------------------------------------------------------------------
+struct WallSpacePartition::ClosestIntersectionTest
+{
+  Vector2D       A, B;
+  double         Length;
+  double         Distance;
+  Vector2D       Point;
+  const Wall2D*  pWall;
+
+  ClosestIntersectionTest(Vector2D a, Vector2D b):A(a),
+                                                  B(b),
+                                                  Length(Vec2DDistance(a, b)),
+                                                  Distance(MaxDouble),
+                                                  pWall(NULL)
+  {}
+
+  void TestWalls(const WallList& walls)
+  {
+    WallList::const_iterator curWall = walls.begin();
+    for (curWall; curWall != walls.end(); ++curWall)
+    {
+      double   dist = 0.0;
+      Vector2D point;
+
+      if (LineIntersection2D(A, B, (*curWall)->From(), (*curWall)->To(), dist, point))
+      {
+        if (dist < Distance)
+        {
+          Distance = dist;
+          Point    = point;
+          pWall    = *curWall;
+        }
+      }
+    }
+  }
+
+  bool VisitCell(const WallList& walls, double tExit)
+  {
+    TestWalls(walls);
+
+    return Distance <= tExit * Length;
+  }
+};
+
+//--------------------------- isSegmentObstructed -----------------------------
+//-----------------------------------------------------------------------------
+inline bool WallSpacePartition::isSegmentObstructed(Vector2D A, Vector2D B)const
+{
+  ObstructionTest test(A, B);
+
+  if (test.VisitCell(m_UnpartitionedWalls, 0.0)) return true;
+
+  return WalkSegment(A, B, test);
+}
+
+//------------------------- FindClosestIntersection ---------------------------
+//-----------------------------------------------------------------------------
+inline bool
+WallSpacePartition::FindClosestIntersection(Vector2D        A,
+                                            Vector2D        B,
+                                            double&         distance,
+                                            Vector2D&       ip,
+                                            const Wall2D**  pClosestWall)const
+{
+  ClosestIntersectionTest test(A, B);
+
+  test.TestWalls(m_UnpartitionedWalls);
+
+  WalkSegment(A, B, test);
+
+  distance = test.Distance;
+
+  if (test.pWall == NULL) return false;
+
+  ip = test.Point;
+
+  if (pClosestWall) *pClosestWall = test.pWall;
+
+  return true;
+}
+
+//--------------------------- doesCircleIntersect -----------------------------
+//-----------------------------------------------------------------------------
+inline bool WallSpacePartition::doesCircleIntersect(Vector2D p, double r)const
+{
+  WallList::const_iterator curWall = m_UnpartitionedWalls.begin();
+  for (curWall; curWall != m_UnpartitionedWalls.end(); ++curWall)
+  {
+    if (LineSegmentCircleIntersection((*curWall)->From(), (*curWall)->To(), p, r))
+    {
+      return true;
+    }
+  }
+
+  //if the circle is entirely outside the partitioned area there's nothing
+  //more to test
+  if (p.x + r < 0 || p.x - r > m_dSpaceWidth ||
+      p.y + r < 0 || p.y - r > m_dSpaceHeight)
+  {
+    return false;
+  }
+
+  int left   = ClampCellX(p.x - r);
+  int right  = ClampCellX(p.x + r);
+  int top    = ClampCellY(p.y - r);
+  int bottom = ClampCellY(p.y + r);
+
+  for (int y=top; y<=bottom; ++y)
+  {
+    for (int x=left; x<=right; ++x)
+    {
+      const WallList& walls = m_Cells[y*m_iNumCellsX + x];
+
+      for (curWall = walls.begin(); curWall != walls.end(); ++curWall)
+      {
+        if (LineSegmentCircleIntersection((*curWall)->From(), (*curWall)->To(), p, r))
+        {
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+//-------------------------- doesCapsuleIntersect -----------------------------
+//-----------------------------------------------------------------------------
+inline bool WallSpacePartition::doesCapsuleIntersect(Vector2D A, Vector2D B, double r)const
+{
+  WallList::const_iterator curWall = m_UnpartitionedWalls.begin();
+  for (curWall; curWall != m_UnpartitionedWalls.end(); ++curWall)
+  {
+    if (DistBetweenLineSegmentsSq(A, B, (*curWall)->From(), (*curWall)->To()) < r*r)
+    {
+      return true;
+    }
+  }
+
+  //if the capsule is entirely outside the partitioned area there's nothing
+  //more to test
+  if (MaxOf(A.x, B.x) + r < 0 || MinOf(A.x, B.x) - r > m_dSpaceWidth ||
+      MaxOf(A.y, B.y) + r < 0 || MinOf(A.y, B.y) - r > m_dSpaceHeight)
+  {
+    return false;
+  }
+
+  //test the walls in the cells overlapped by the capsule's bounding box
+  int left   = ClampCellX(MinOf(A.x, B.x) - r);
+  int right  = ClampCellX(MaxOf(A.x, B.x) + r);
+  int top    = ClampCellY(MinOf(A.y, B.y) - r);
+  int bottom = ClampCellY(MaxOf(A.y, B.y) + r);
+
+  for (int y=top; y<=bottom; ++y)
+  {
+    for (int x=left; x<=right; ++x)
+    {
+      const WallList& walls = m_Cells[y*m_iNumCellsX + x];
+
+      for (curWall = walls.begin(); curWall != walls.end(); ++curWall)
+      {
+        if (DistBetweenLineSegmentsSq(A, B, (*curWall)->From(), (*curWall)->To()) < r*r)
+        {
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+//------------------------------- RenderCells ---------------------------------
+//-----------------------------------------------------------------------------
+inline void WallSpacePartition::RenderCells()const
+{
+  for (int x=0; x<=m_iNumCellsX; ++x)
+  {
+    gdi->Line(x*m_dCellSizeX, 0.0, x*m_dCellSizeX, m_dSpaceHeight);
+  }
+
+  for (int y=0; y<=m_iNumCellsY; ++y)
+  {
+    gdi->Line(0.0, y*m_dCellSizeY, m_dSpaceWidth, y*m_dCellSizeY);
+  }
+}
+
+
+
+#endif
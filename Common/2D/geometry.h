@@ -10,8 +10,8 @@
 //
 //------------------------------------------------------------------------
 #include "misc/utils.h"
-#include "2d/Vector2D.h"
-#include "2d/C2DMatrix.h"
+#include "2D/Vector2D.h"
+#include "2D/C2DMatrix.h"
 #include "Transformations.h"
 
 #include <math.h>
@@ -321,6 +321,23 @@ inline bool LineIntersection2D(Vector2D   A,
   }
 }
 
+//--------------------- DistBetweenLineSegmentsSq ------------------------
+//
+//  returns the square of the shortest distance between the line segments
+//  AB and CD
+//------------------------------------------------------------------------
+inline double DistBetweenLineSegmentsSq(Vector2D A,
+                                        Vector2D B,
+                                        Vector2D C,
+                                        Vector2D D)
+{
+  if (LineIntersection2D(A, B, C, D)) return 0;
+
+  //segments that don't cross are closest at an end point of one of them
+  return MinOf(MinOf(DistToLineSegmentSq(A, B, C), DistToLineSegmentSq(A, B, D)),
+               MinOf(DistToLineSegmentSq(C, D, A), DistToLineSegmentSq(C, D, B)));
+}
+
 //----------------------- ObjectIntersection2D ---------------------------
 //
 //  tests two polygons for intersection. *Does not check for enclosure*
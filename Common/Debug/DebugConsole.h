@@ -14,17 +14,21 @@
 //
 //        debug_con << "Hello World!" << "";
 //
+//         when RAVEN_HEADLESS is defined there is no console window and
+//         all debug output is sent to the sink.
+//
 // Author: Mat Buckland 2001 (fup@ai-junkie.com)
 //
 //------------------------------------------------------------------------
 #include <vector>
-#include <windows.h>
 #include <iosfwd>
 #include <fstream>
 
 #include "misc/utils.h"
-#include "misc/WindowUtils.h"
 
+#ifndef RAVEN_HEADLESS
+#include <windows.h>
+#include "misc/WindowUtils.h"
 
 //need to define a custom message
 const int UM_SETSCROLL = WM_USER + 32;
@@ -39,15 +43,19 @@ const int DEBUG_WINDOW_HEIGHT = 400;
 
 //undefine DEBUG to send all debug messages to hyperspace (a sink - see below)
 #define DEBUG
+#endif
+
 #ifdef DEBUG
 #define debug_con *(DebugConsole::Instance())
-#else
-#define debug_con *(CSink::Instance())
-#endif
 
 //use these in your code to toggle output to the console on/off
 #define debug_on  DebugConsole::On();
 #define debug_off DebugConsole::Off();
+#else
+#define debug_con *(CSink::Instance())
+#define debug_on
+#define debug_off
+#endif
 
 
 //this little class just acts as a sink for any input. Used in place
@@ -74,6 +82,7 @@ public:
 };
 
 
+#ifndef RAVEN_HEADLESS
 
 class DebugConsole
 {
@@ -174,6 +183,6 @@ public:
   }
 };
 
- 
+#endif //RAVEN_HEADLESS
 
 #endif
\ No newline at end of file
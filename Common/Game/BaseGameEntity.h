@@ -15,7 +15,7 @@
 #include <string>
 #include <iosfwd>
 #include "2D/Vector2D.h"
-#include "2D/Geometry.h"
+#include "2D/geometry.h"
 #include "misc/utils.h"
 
 
@@ -0,0 +1,149 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   CompactGraph.h
+//
+//  Desc:   a read only view of a SparseGraph laid out for fast searching.
+//
+//          SparseGraph keeps each node's edges in a std::list so a search
+//          expanding a node follows a pointer for every edge, and the edges
+//          of neighbouring nodes are scattered across the heap. A
+//          CompactGraph copies the edges into a single array in compressed
+//          sparse row form: the edges leading from node n are stored one
+//          after the other, immediately followed by those of node n+1.
+//
+//          It has the same ConstEdgeIterator, GetNode and NumNodes interface
+//          as SparseGraph so any of the search algorithms can be used with
+//          it in place of the graph it was created from. Nodes are read
+//          straight from that graph so changes to a node's extra info are
+//          seen at once, but if any edges are added, removed or have their
+//          cost changed Rebuild must be called. Pointers to edges obtained
+//          from the view (such as those in a search's shortest path tree)
+//          are invalidated by Rebuild.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+
+
+template <class graph_type>
+class CompactGraph
+{
+public:
+
+  typedef typename graph_type::NodeType  NodeType;
+  typedef typename graph_type::EdgeType  EdgeType;
+
+private:
+
+  const graph_type&      m_Graph;
+
+  //the edges leading from node n are m_Edges[m_EdgeOffsets[n]] to
+  //m_Edges[m_EdgeOffsets[n+1]-1]
+  std::vector<int>       m_EdgeOffsets;
+  std::vector<EdgeType>  m_Edges;
+
+  //copying a view makes no sense
+  CompactGraph(const CompactGraph&);
+  CompactGraph& operator=(const CompactGraph&);
+
+public:
+
+  explicit CompactGraph(const graph_type& G):m_Graph(G)
+  {
+    Rebuild();
+  }
+
+  //copies the edges from the graph. Call this whenever the graph's edges
+  //are changed
+  void Rebuild();
+
+  const graph_type& GetGraph()const{return m_Graph;}
+
+  const NodeType&   GetNode(int idx)const{return m_Graph.GetNode(idx);}
+
+  int               NumNodes()const{return m_Graph.NumNodes();}
+  int               NumEdges()const{return m_Edges.size();}
+
+  bool              isDigraph()const{return m_Graph.isDigraph();}
+
+
+  //iterates through the edges leading from a node. This is used in exactly
+  //the same way as SparseGraph's ConstEdgeIterator
+  class ConstEdgeIterator
+  {
+  private:
+
+    const EdgeType*  m_pFirst;
+    const EdgeType*  m_pLast;
+    const EdgeType*  m_pCurrent;
+
+  public:
+
+    ConstEdgeIterator(const CompactGraph<graph_type>& graph, int node)
+    {
+      assert (node >= 0 && node < graph.NumNodes() &&
+              "<CompactGraph::ConstEdgeIterator>: invalid node index");
+
+      m_pFirst   = graph.m_Edges.data() + graph.m_EdgeOffsets[node];
+      m_pLast    = graph.m_Edges.data() + graph.m_EdgeOffsets[node+1];
+      m_pCurrent = m_pFirst;
+    }
+
+    const EdgeType*  begin()
+    {
+      m_pCurrent = m_pFirst;
+
+      if (end()) return 0;
+
+      return m_pCurrent;
+    }
+
+    const EdgeType*  next()
+    {
+      ++m_pCurrent;
+
+      if (end()) return 0;
+
+      return m_pCurrent;
+    }
+
+    //return true if we are at the end of the edge list
+    bool end()
+    {
+      return m_pCurrent == m_pLast;
+    }
+  };
+
+  friend class ConstEdgeIterator;
+};
+
+
+//------------------------------ Rebuild --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void CompactGraph<graph_type>::Rebuild()
+{
+  m_EdgeOffsets.assign(m_Graph.NumNodes() + 1, 0);
+  m_Edges.clear();
+  m_Edges.reserve(m_Graph.NumEdges());
+
+  for (int n=0; n<m_Graph.NumNodes(); ++n)
+  {
+    m_EdgeOffsets[n] = m_Edges.size();
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, n);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      m_Edges.push_back(*pE);
+    }
+  }
+
+  m_EdgeOffsets[m_Graph.NumNodes()] = m_Edges.size();
+}
+
+
+
+#endif
@@ -0,0 +1,508 @@
+#ifndef GRAPH_COST_ORACLES_H
+#define GRAPH_COST_ORACLES_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   GraphCostOracles.h
+//
+//  Desc:   classes to answer the question "what is the cost of the cheapest
+//          path from node A to node B?" for a graph.
+//
+//          GraphCostOracle_Table pre-calculates the cost between every pair
+//          of nodes. Lookups are as fast as they can be but the table grows
+//          with the square of the number of nodes.
+//
+//          GraphCostOracle_Landmarks uses memory proportional to the number
+//          of nodes. It stores the cost from a small number of landmark nodes
+//          to every node, from which a lower bound on the cost between any
+//          pair of nodes can be quickly calculated (the ALT technique). Exact
+//          costs are calculated on demand with a Dijkstra search and the
+//          results of the most recently used searches are cached.
+//
+//          GraphCostOracle_MappedTable uses a table saved to disk by
+//          GraphCostOracle_Table. The file is memory mapped so opening it
+//          is almost free and its rows are paged in as they are used.
+//
+//          As with the all pairs table, the cost between two nodes with no
+//          path between them is reported as zero.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+
+#include "Graph/GraphAlgorithms.h"
+#include "Graph/HandyGraphFunctions.h"
+#include "Graph/NodeTypeEnumerations.h"
+#include "misc/utils.h"
+#include "misc/ThreadPool.h"
+#include "misc/MappedFile.h"
+
+
+
+//--------------------------- GraphCostOracle ---------------------------------
+//
+//  the interface
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class GraphCostOracle
+{
+public:
+
+  virtual ~GraphCostOracle(){}
+
+  //returns the cost of the cheapest path from nd1 to nd2
+  virtual double Cost(int nd1, int nd2)const = 0;
+
+  //returns a value that is never greater than Cost(nd1, nd2) but that
+  //may be much cheaper to calculate. Use this to discard candidates before
+  //asking for their exact cost
+  virtual double LowerBound(int nd1, int nd2)const = 0;
+};
+
+
+//------------------------- CostTableFileHeader -------------------------------
+//
+//  the start of a cost table file. It is followed by NumNodes rows of
+//  NumNodes doubles. GraphHash is the CalculateGraphHash of the graph the
+//  table was calculated from, so a table is never used with a graph it
+//  doesn't belong to
+//-----------------------------------------------------------------------------
+struct CostTableFileHeader
+{
+  enum {current_version = 1};
+
+  char               Magic[8];
+  unsigned int       Version;
+  unsigned int       NumNodes;
+  unsigned long long GraphHash;
+};
+
+const char CostTableFileMagic[8] = "RVNCOST";
+
+
+//------------------------- GraphCostOracle_Table -----------------------------
+//
+//  looks up costs in a table of the cost between every pair of nodes
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class GraphCostOracle_Table : public GraphCostOracle<graph_type>
+{
+private:
+
+  std::vector<std::vector<double> >  m_PathCosts;
+
+public:
+
+  GraphCostOracle_Table(const graph_type& G):m_PathCosts(CreateAllPairsCostsTable(G))
+  {}
+
+  //the table is calculated using the thread pool
+  GraphCostOracle_Table(const graph_type&        G,
+                        ThreadPool&              pool,
+                        ThreadPool::ProgressFunc ReportProgress = NULL):
+                             m_PathCosts(CreateAllPairsCostsTable(G, pool, ReportProgress))
+  {}
+
+  double Cost(int nd1, int nd2)const{return m_PathCosts[nd1][nd2];}
+
+  double LowerBound(int nd1, int nd2)const{return m_PathCosts[nd1][nd2];}
+
+  //writes the table to a file that can be opened by
+  //GraphCostOracle_MappedTable. Returns false if the file can't be written
+  bool   Save(const std::string& FileName, unsigned long long GraphHash)const;
+};
+
+//--------------------------------- Save --------------------------------------
+//
+//  the table is written to a temporary file of this process's own which is
+//  then renamed over the file, so another process opening the file never
+//  sees it half written, and two processes saving the same table at once
+//  don't write over each other
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool GraphCostOracle_Table<graph_type>::Save(const std::string& FileName,
+                                             unsigned long long GraphHash)const
+{
+  const std::string TempFileName = TempFileNameFor(FileName);
+
+  std::ofstream out(TempFileName.c_str(), std::ios::binary | std::ios::trunc);
+
+  if (!out) return false;
+
+  CostTableFileHeader header;
+
+  std::memcpy(header.Magic, CostTableFileMagic, sizeof(header.Magic));
+  header.Version   = CostTableFileHeader::current_version;
+  header.NumNodes  = m_PathCosts.size();
+  header.GraphHash = GraphHash;
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (unsigned int row=0; row<m_PathCosts.size(); ++row)
+  {
+    out.write(reinterpret_cast<const char*>(&m_PathCosts[row][0]),
+              m_PathCosts[row].size() * sizeof(double));
+  }
+
+  out.close();
+
+  if (!out)
+  {
+    std::remove(TempFileName.c_str());
+    return false;
+  }
+
+  if (!RenameOver(TempFileName, FileName))
+  {
+    std::remove(TempFileName.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+
+//---------------------- GraphCostOracle_MappedTable --------------------------
+//
+//  looks up costs in a cost table file written by GraphCostOracle_Table.
+//  Check isValid after construction: if the file is missing, damaged or was
+//  written for a different graph the oracle must not be used
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class GraphCostOracle_MappedTable : public GraphCostOracle<graph_type>
+{
+private:
+
+  MappedFile     m_File;
+
+  //the first element of the table, or NULL if the file couldn't be used
+  const double*  m_pCosts;
+
+  int            m_iNumNodes;
+
+public:
+
+  GraphCostOracle_MappedTable(const std::string& FileName,
+                              const graph_type&  G,
+                              unsigned long long GraphHash);
+
+  bool   isValid()const{return m_pCosts != NULL;}
+
+  double Cost(int nd1, int nd2)const{return m_pCosts[nd1*m_iNumNodes + nd2];}
+
+  double LowerBound(int nd1, int nd2)const{return Cost(nd1, nd2);}
+};
+
+//----------------------------- ctor ------------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+GraphCostOracle_MappedTable<graph_type>::GraphCostOracle_MappedTable(const std::string& FileName,
+                                                                     const graph_type&  G,
+                                                                     unsigned long long GraphHash):
+                                                m_pCosts(NULL),
+                                                m_iNumNodes(G.NumNodes())
+{
+  if (!m_File.Open(FileName)) return;
+
+  const std::size_t TableSize = (std::size_t)m_iNumNodes * m_iNumNodes * sizeof(double);
+
+  if (m_File.Size() != sizeof(CostTableFileHeader) + TableSize)
+  {
+    m_File.Close(); return;
+  }
+
+  CostTableFileHeader header;
+  std::memcpy(&header, m_File.Data(), sizeof(header));
+
+  if (std::memcmp(header.Magic, CostTableFileMagic, sizeof(header.Magic)) != 0 ||
+      header.Version   != CostTableFileHeader::current_version ||
+      header.NumNodes  != (unsigned int)m_iNumNodes ||
+      header.GraphHash != GraphHash)
+  {
+    m_File.Close(); return;
+  }
+
+  m_pCosts = reinterpret_cast<const double*>(m_File.Data() + sizeof(CostTableFileHeader));
+}
+
+
+//----------------------- GraphCostOracle_Landmarks ---------------------------
+//
+//  Landmarks are chosen so that they are spread out around the edges of the
+//  graph. For any landmark L the triangle inequality gives
+//
+//    Cost(A, B) >= |Cost(L, A) - Cost(L, B)|
+//
+//  and the largest of these over all the landmarks is the lower bound. This
+//  requires the graph's edges to cost the same in both directions, which is
+//  always true of a graph that isn't a digraph.
+//
+//  A cached exact search is a complete Dijkstra search. For an undirected
+//  graph the search is made from the second node of the query because that
+//  is usually the one repeated between queries (the position of an item,
+//  say, when finding the closest item to a moving bot).
+//
+//  Note: Cost updates the cache so it must not be called from more than one
+//  thread at a time.
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class GraphCostOracle_Landmarks : public GraphCostOracle<graph_type>
+{
+private:
+
+  const graph_type&                  m_Graph;
+
+  //the cost from each landmark to every node. Nodes that can't be reached
+  //from the landmark are marked with a negative cost
+  std::vector<std::vector<double> >  m_LandmarkCosts;
+
+  //the cache of exact searches. m_CachedCosts[i] holds the cost from (or,
+  //for an undirected graph, to) node m_CachedNode[i] to every other node
+  mutable std::vector<std::vector<double> >  m_CachedCosts;
+  mutable std::vector<int>                   m_CachedNode;
+
+  //used to find the least recently used cache entry
+  mutable std::vector<unsigned int>          m_LastUsed;
+  mutable unsigned int                       m_iNumLookups;
+
+  //indexed by node, this holds the index of the cache entry for the node
+  //or -1 if it isn't cached
+  mutable std::vector<int>                   m_CacheEntryOfNode;
+
+  //calculates the cost from the source node to every node. Nodes that
+  //can't be reached are given a negative cost
+  void CalculateCostsFrom(int source, std::vector<double>& costs)const;
+
+  //returns the cache entry for the node, searching from it and evicting
+  //the least recently used entry if necessary
+  const std::vector<double>& GetCachedCosts(int nd)const;
+
+  void ChooseLandmarks(int NumLandmarks);
+
+public:
+
+  GraphCostOracle_Landmarks(const graph_type& G,
+                            int               NumLandmarks,
+                            int               CacheSize);
+
+  double Cost(int nd1, int nd2)const;
+
+  double LowerBound(int nd1, int nd2)const;
+
+  int    NumLandmarks()const{return m_LandmarkCosts.size();}
+};
+
+
+//----------------------------- ctor ------------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+GraphCostOracle_Landmarks<graph_type>::GraphCostOracle_Landmarks(const graph_type& G,
+                                                                 int               NumLandmarks,
+                                                                 int               CacheSize):
+                                                m_Graph(G),
+                                                m_iNumLookups(0),
+                                                m_CacheEntryOfNode(G.NumNodes(), -1)
+{
+  assert (CacheSize > 0 && "<GraphCostOracle_Landmarks::ctor>: cache size must be positive");
+
+  //the size of m_LastUsed is the capacity of the cache. The other two are
+  //filled as entries are used
+  m_LastUsed.assign(CacheSize, 0);
+  m_CachedNode.reserve(CacheSize);
+  m_CachedCosts.reserve(CacheSize);
+
+  if (!G.isDigraph()) ChooseLandmarks(NumLandmarks);
+}
+
+//-------------------------- CalculateCostsFrom -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void GraphCostOracle_Landmarks<graph_type>::CalculateCostsFrom(int                  source,
+                                                               std::vector<double>& costs)const
+{
+  Graph_SearchDijkstra<graph_type> search(m_Graph, source);
+
+  std::vector<const typename graph_type::EdgeType*> spt = search.GetSPT();
+
+  costs.assign(m_Graph.NumNodes(), -1.0);
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (nd == source || spt[nd] != 0)
+    {
+      costs[nd] = search.GetCostToNode(nd);
+    }
+  }
+}
+
+//--------------------------- ChooseLandmarks ---------------------------------
+//
+//  the first landmark is the node furthest from the first valid node. Each
+//  subsequent landmark is the node furthest from all the landmarks chosen
+//  so far
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void GraphCostOracle_Landmarks<graph_type>::ChooseLandmarks(int NumLandmarks)
+{
+  //find the first valid node
+  int start = 0;
+
+  while (start < m_Graph.NumNodes() &&
+         m_Graph.GetNode(start).Index() == invalid_node_index)
+  {
+    ++start;
+  }
+
+  if (start == m_Graph.NumNodes()) return;
+
+  //this holds, for each node, the cost to the closest landmark chosen so far
+  std::vector<double> ClosestLandmark(m_Graph.NumNodes(), MaxDouble);
+
+  std::vector<double> costs;
+  CalculateCostsFrom(start, costs);
+
+  int next = start;
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (costs[nd] > costs[next]) next = nd;
+  }
+
+  while ((int)m_LandmarkCosts.size() < NumLandmarks)
+  {
+    m_LandmarkCosts.push_back(std::vector<double>());
+    CalculateCostsFrom(next, m_LandmarkCosts.back());
+
+    //update the distances to the closest landmark and pick the node
+    //furthest from all of them as the next landmark
+    const std::vector<double>& LandmarkCosts = m_LandmarkCosts.back();
+
+    int furthest = -1;
+    for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+    {
+      if (LandmarkCosts[nd] < 0) continue;
+
+      if (LandmarkCosts[nd] < ClosestLandmark[nd])
+      {
+        ClosestLandmark[nd] = LandmarkCosts[nd];
+      }
+
+      if (furthest < 0 || ClosestLandmark[nd] > ClosestLandmark[furthest])
+      {
+        furthest = nd;
+      }
+    }
+
+    //stop if every node is already a landmark
+    if (furthest < 0 || isEqual(ClosestLandmark[furthest], 0.0)) break;
+
+    next = furthest;
+  }
+}
+
+//---------------------------- GetCachedCosts ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+const std::vector<double>&
+GraphCostOracle_Landmarks<graph_type>::GetCachedCosts(int nd)const
+{
+  int entry = m_CacheEntryOfNode[nd];
+
+  if (entry < 0)
+  {
+    //use a free entry if there is one, else evict the least recently used
+    if (m_CachedNode.size() < m_LastUsed.size())
+    {
+      entry = m_CachedNode.size();
+
+      m_CachedNode.push_back(nd);
+      m_CachedCosts.push_back(std::vector<double>());
+    }
+    else
+    {
+      entry = 0;
+      for (unsigned int e=1; e<m_LastUsed.size(); ++e)
+      {
+        if (m_LastUsed[e] < m_LastUsed[entry]) entry = e;
+      }
+
+      m_CacheEntryOfNode[m_CachedNode[entry]] = -1;
+      m_CachedNode[entry] = nd;
+    }
+
+    m_CacheEntryOfNode[nd] = entry;
+
+    CalculateCostsFrom(nd, m_CachedCosts[entry]);
+  }
+
+  m_LastUsed[entry] = ++m_iNumLookups;
+
+  return m_CachedCosts[entry];
+}
+
+//--------------------------------- Cost --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+double GraphCostOracle_Landmarks<graph_type>::Cost(int nd1, int nd2)const
+{
+  assert (nd1>=0 && nd1<m_Graph.NumNodes() &&
+          nd2>=0 && nd2<m_Graph.NumNodes() &&
+          "<GraphCostOracle_Landmarks::Cost>: invalid index");
+
+  if (nd1 == nd2) return 0.0;
+
+  double cost;
+
+  if (m_Graph.isDigraph())
+  {
+    cost = GetCachedCosts(nd1)[nd2];
+  }
+
+  //for an undirected graph a search from either node will do
+  else if (m_CacheEntryOfNode[nd1] >= 0)
+  {
+    cost = GetCachedCosts(nd1)[nd2];
+  }
+  else
+  {
+    cost = GetCachedCosts(nd2)[nd1];
+  }
+
+  //no path
+  if (cost < 0) return 0.0;
+
+  return cost;
+}
+
+//------------------------------ LowerBound -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+double GraphCostOracle_Landmarks<graph_type>::LowerBound(int nd1, int nd2)const
+{
+  double bound = 0.0;
+
+  std::vector<std::vector<double> >::const_iterator curLandmark = m_LandmarkCosts.begin();
+  for (curLandmark; curLandmark != m_LandmarkCosts.end(); ++curLandmark)
+  {
+    double c1 = (*curLandmark)[nd1];
+    double c2 = (*curLandmark)[nd2];
+
+    //if the landmark can reach one node but not the other there is no path
+    //between them, so the cost is zero
+    if ((c1 < 0) != (c2 < 0)) return 0.0;
+
+    if (c1 < 0) continue;
+
+    double diff = c1 > c2 ? c1 - c2 : c2 - c1;
+
+    if (diff > bound) bound = diff;
+  }
+
+  return bound;
+}
+
+
+
+#endif
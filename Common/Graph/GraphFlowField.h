@@ -0,0 +1,153 @@
+#ifndef GRAPH_FLOW_FIELD_H
+#define GRAPH_FLOW_FIELD_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   GraphFlowField.h
+//
+//  Desc:   the cost from every node of a graph to the nearest of a set of
+//          goal nodes, and the edge to take from each node to get there.
+//
+//          A single Dijkstra search spreading out from all the goals at
+//          once answers for every node in the graph, so when many agents
+//          want to get to the nearest of the same goals one field replaces
+//          a search per agent. The field must be calculated again when the
+//          goals change.
+//
+//          The graph must be undirected and must conform to the same
+//          interface as SparseGraph.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+
+#include "misc/PriorityQueue.h"
+#include "misc/utils.h"
+#include "Graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class GraphFlowField
+{
+public:
+
+  typedef typename graph_type::EdgeType  EdgeType;
+
+private:
+
+  const graph_type&             m_Graph;
+
+  //the goals the field leads to
+  std::vector<int>              m_Goals;
+
+  //the cost from each node to the nearest goal. MaxDouble if no goal can
+  //be reached from the node
+  std::vector<double>           m_Cost;
+
+  //the first edge on the cheapest path from each node to the nearest goal.
+  //NULL for the goals themselves and for nodes that can't reach a goal
+  std::vector<const EdgeType*>  m_Next;
+
+  GraphFlowField(const GraphFlowField&);
+  GraphFlowField& operator=(const GraphFlowField&);
+
+public:
+
+  //the graph must outlive the field. No goal can be reached until
+  //Calculate is called
+  GraphFlowField(const graph_type& G):m_Graph(G),
+                                      m_Cost(G.NumNodes(), MaxDouble),
+                                      m_Next(G.NumNodes(), (const EdgeType*)NULL)
+  {
+    assert (!G.isDigraph() && "<GraphFlowField>: the graph must be undirected");
+  }
+
+  //makes the field lead to the given goals
+  void                      Calculate(const std::vector<int>& goals);
+
+  const std::vector<int>&   Goals()const{return m_Goals;}
+
+  bool                      isReachable(int nd)const{return m_Cost[nd] < MaxDouble;}
+
+  //the cost from nd to the nearest goal. MaxDouble if there isn't one
+  double                    Cost(int nd)const{return m_Cost[nd];}
+
+  //the edge to take from nd towards the nearest goal. NULL if nd is a goal
+  //or can't reach one
+  const EdgeType*           NextEdge(int nd)const{return m_Next[nd];}
+};
+
+
+//------------------------------- Calculate -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void GraphFlowField<graph_type>::Calculate(const std::vector<int>& goals)
+{
+  m_Goals = goals;
+
+  m_Cost.assign(m_Graph.NumNodes(), MaxDouble);
+  m_Next.assign(m_Graph.NumNodes(), (const EdgeType*)NULL);
+
+  //the node each node is reached from on the way out from the goals
+  std::vector<int> From(m_Graph.NumNodes(), invalid_node_index);
+
+  IndexedPriorityQLow<double> pq(m_Cost, m_Graph.NumNodes());
+
+  for (unsigned int g=0; g<m_Goals.size(); ++g)
+  {
+    if (m_Cost[m_Goals[g]] == 0) continue;
+
+    m_Cost[m_Goals[g]] = 0;
+
+    pq.insert(m_Goals[g]);
+  }
+
+  //the graph is undirected so the cheapest path from a node to its nearest
+  //goal is the reverse of the cheapest path out to it from the goals
+  while (!pq.empty())
+  {
+    int NextClosestNode = pq.Pop();
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, NextClosestNode);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      double NewCost = m_Cost[NextClosestNode] + pE->Cost();
+
+      if (m_Cost[pE->To()] == MaxDouble)
+      {
+        m_Cost[pE->To()] = NewCost;
+        From[pE->To()]   = NextClosestNode;
+
+        pq.insert(pE->To());
+      }
+
+      else if (NewCost < m_Cost[pE->To()])
+      {
+        m_Cost[pE->To()] = NewCost;
+        From[pE->To()]   = NextClosestNode;
+
+        pq.ChangePriority(pE->To());
+      }
+    }
+  }
+
+  //each node's next edge is the edge back the way it was reached
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (From[nd] == invalid_node_index) continue;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (pE->To() == From[nd])
+      {
+        m_Next[nd] = pE; break;
+      }
+    }
+  }
+}
+
+
+
+#endif
@@ -0,0 +1,268 @@
+#ifndef GRIDLAYOUT_H
+#define GRIDLAYOUT_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   GridLayout.h
+//
+//  Desc:   recognizes a graph whose nodes are laid out on a regular grid,
+//          such as one created with GraphHelper_CreateGrid, and maps
+//          between node indices and grid cells.
+//
+//          A graph is a grid if every node sits at the centre of a cell of
+//          a uniform grid, each node is joined to exactly the nodes in the
+//          eight cells around it, and each edge costs the distance between
+//          the nodes it joins. Nodes may have been removed, leaving holes.
+//          Searches can then treat the graph as an occupancy grid and skip
+//          the symmetric paths plain A* explores (see Graph_SearchJPS_TS).
+//
+//          The graph must conform to the same interface as SparseGraph.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "2D/Vector2D.h"
+#include "misc/utils.h"
+#include "Graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class GridLayout
+{
+public:
+
+  typedef typename graph_type::EdgeType  EdgeType;
+
+private:
+
+  const graph_type&  m_Graph;
+
+  bool               m_bIsGrid;
+
+  int                m_iNumColumns;
+  int                m_iNumRows;
+
+  double             m_dCellWidth;
+  double             m_dCellHeight;
+
+  //the position of the node in the first column and row
+  Vector2D           m_vOrigin;
+
+  //the node in each cell (invalid_node_index if there isn't one) and the
+  //cell each node is in
+  std::vector<int>   m_NodeOfCell;
+  std::vector<int>   m_CellOfNode;
+
+  //one byte per cell saying whether it holds a node, with a border of
+  //closed cells around the grid so searches stepping one cell off the edge
+  //don't need to check the bounds. Searches test this far more often than
+  //anything else, so it is kept compact
+  std::vector<char>  m_Occupancy;
+
+  bool isValidNode(int nd)const{return m_Graph.GetNode(nd).Index() != invalid_node_index;}
+
+  //works out the layout and returns false as soon as the graph turns out
+  //not to be a grid
+  bool Detect();
+
+  GridLayout(const GridLayout&);
+  GridLayout& operator=(const GridLayout&);
+
+public:
+
+  //the graph must outlive the layout and must not change
+  GridLayout(const graph_type& G):m_Graph(G),
+                                  m_bIsGrid(false),
+                                  m_iNumColumns(0),
+                                  m_iNumRows(0),
+                                  m_dCellWidth(0.0),
+                                  m_dCellHeight(0.0)
+  {
+    m_bIsGrid = Detect();
+
+    //don't hang on to the cells of a graph that isn't a grid
+    if (!m_bIsGrid)
+    {
+      std::vector<int>().swap(m_NodeOfCell);
+      std::vector<int>().swap(m_CellOfNode);
+      std::vector<char>().swap(m_Occupancy);
+    }
+  }
+
+  bool              isGrid()const{return m_bIsGrid;}
+
+  int               NumColumns()const{return m_iNumColumns;}
+  int               NumRows()const{return m_iNumRows;}
+  double            CellWidth()const{return m_dCellWidth;}
+  double            CellHeight()const{return m_dCellHeight;}
+
+  int               Column(int nd)const{return m_CellOfNode[nd] % m_iNumColumns;}
+  int               Row(int nd)const{return m_CellOfNode[nd] / m_iNumColumns;}
+
+  //returns the node in the given cell, or invalid_node_index if the cell is
+  //empty or outside the grid
+  int               NodeAt(int col, int row)const
+  {
+    if (col < 0 || row < 0 || col >= m_iNumColumns || row >= m_iNumRows)
+    {
+      return invalid_node_index;
+    }
+
+    return m_NodeOfCell[row * m_iNumColumns + col];
+  }
+
+  //returns true if the cell holds a node. The cell may be up to one column
+  //or row outside the grid
+  bool              isOpen(int col, int row)const
+  {
+    return m_Occupancy[(row + 1) * (m_iNumColumns + 2) + col + 1] != 0;
+  }
+
+  //returns the edge leading from one node to a neighbouring one
+  const EdgeType*   GetEdge(int from, int to)const
+  {
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, from);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (pE->To() == to) return pE;
+    }
+
+    return NULL;
+  }
+
+  const graph_type& GetGraph()const{return m_Graph;}
+};
+
+
+//------------------------------- Detect --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool GridLayout<graph_type>::Detect()
+{
+  if (m_Graph.isDigraph()) return false;
+
+  //the cell size is the smallest horizontal and vertical distance spanned
+  //by an edge, and the grid starts at the top left node
+  const double tolerance = 1e-3;
+
+  m_dCellWidth  = MaxDouble;
+  m_dCellHeight = MaxDouble;
+
+  int      NumNodes = 0;
+  Vector2D TopLeft(MaxDouble, MaxDouble);
+  Vector2D BottomRight(-MaxDouble, -MaxDouble);
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isValidNode(nd)) continue;
+
+    ++NumNodes;
+
+    const Vector2D& pos = m_Graph.GetNode(nd).Pos();
+
+    TopLeft.x     = std::min(TopLeft.x, pos.x);
+    TopLeft.y     = std::min(TopLeft.y, pos.y);
+    BottomRight.x = std::max(BottomRight.x, pos.x);
+    BottomRight.y = std::max(BottomRight.y, pos.y);
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      const Vector2D span = m_Graph.GetNode(pE->To()).Pos() - pos;
+
+      if (fabs(span.x) > tolerance) m_dCellWidth  = std::min(m_dCellWidth, fabs(span.x));
+      if (fabs(span.y) > tolerance) m_dCellHeight = std::min(m_dCellHeight, fabs(span.y));
+    }
+  }
+
+  if (m_dCellWidth == MaxDouble || m_dCellHeight == MaxDouble) return false;
+
+  m_vOrigin     = TopLeft;
+  m_iNumColumns = (int)floor((BottomRight.x - TopLeft.x) / m_dCellWidth + 0.5) + 1;
+  m_iNumRows    = (int)floor((BottomRight.y - TopLeft.y) / m_dCellHeight + 0.5) + 1;
+
+  //a grid with mostly empty cells isn't worth treating as one
+  if ((double)m_iNumColumns * m_iNumRows > 4.0 * NumNodes) return false;
+
+  //put each node in its cell
+  m_NodeOfCell.assign(m_iNumColumns * m_iNumRows, invalid_node_index);
+  m_CellOfNode.assign(m_Graph.NumNodes(), invalid_node_index);
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isValidNode(nd)) continue;
+
+    const Vector2D& pos = m_Graph.GetNode(nd).Pos();
+
+    const double x = (pos.x - m_vOrigin.x) / m_dCellWidth;
+    const double y = (pos.y - m_vOrigin.y) / m_dCellHeight;
+
+    const int col = (int)floor(x + 0.5);
+    const int row = (int)floor(y + 0.5);
+
+    //nodes must sit on the grid, one to a cell
+    if (fabs(x - col) > tolerance || fabs(y - row) > tolerance) return false;
+
+    if (m_NodeOfCell[row * m_iNumColumns + col] != invalid_node_index) return false;
+
+    m_NodeOfCell[row * m_iNumColumns + col] = nd;
+    m_CellOfNode[nd]                        = row * m_iNumColumns + col;
+  }
+
+  m_Occupancy.assign((m_iNumColumns + 2) * (m_iNumRows + 2), 0);
+
+  for (unsigned int cell=0; cell<m_NodeOfCell.size(); ++cell)
+  {
+    const int col = cell % m_iNumColumns;
+    const int row = cell / m_iNumColumns;
+
+    m_Occupancy[(row + 1) * (m_iNumColumns + 2) + col + 1] = m_NodeOfCell[cell] != invalid_node_index;
+  }
+
+  //every node must be joined to each of its neighbours and nothing else, at
+  //a cost equal to the distance between them
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isValidNode(nd)) continue;
+
+    int NumEdges = 0;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      const int dc = Column(pE->To()) - Column(nd);
+      const int dr = Row(pE->To()) - Row(nd);
+
+      if (abs(dc) > 1 || abs(dr) > 1 || (dc == 0 && dr == 0)) return false;
+
+      const double dist = Vec2DDistance(m_Graph.GetNode(nd).Pos(), m_Graph.GetNode(pE->To()).Pos());
+
+      if (fabs(pE->Cost() - dist) > tolerance * dist) return false;
+
+      ++NumEdges;
+    }
+
+    int NumNeighbours = 0;
+
+    for (int dr=-1; dr<2; ++dr)
+    {
+      for (int dc=-1; dc<2; ++dc)
+      {
+        if ((dc != 0 || dr != 0) && isOpen(Column(nd) + dc, Row(nd) + dr)) ++NumNeighbours;
+      }
+    }
+
+    if (NumEdges != NumNeighbours) return false;
+  }
+
+  return true;
+}
+
+
+
+#endif
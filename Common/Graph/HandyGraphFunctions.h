@@ -13,10 +13,13 @@
 //          with the SparseGraph class
 //-----------------------------------------------------------------------------
 #include <iostream>
+#include <sstream>
+#include <string>
 
 #include "misc/Cgdi.h"
 #include "misc/utils.h"
 #include "misc/Stream_Utility_Functions.h"
+#include "misc/ThreadPool.h"
 #include "Graph/GraphAlgorithms.h"
 #include "Graph/AStarHeuristicPolicies.h"
 
@@ -65,7 +68,7 @@ void GraphHelper_AddAllNeighboursToGridNode(graph_type& graph,
         double dist = PosNode.Distance(PosNeighbour);
 
         //this neighbour is okay so it can be added
-        graph_type::EdgeType NewEdge(row*NumCellsX+col,
+        typename graph_type::EdgeType NewEdge(row*NumCellsX+col,
                                      nodeY*NumCellsX+nodeX,
                                      dist);
         graph.AddEdge(NewEdge);
@@ -74,7 +77,7 @@ void GraphHelper_AddAllNeighboursToGridNode(graph_type& graph,
         //in the other direction
         if (!graph.isDigraph())
         {
-          graph_type::EdgeType NewEdge(nodeY*NumCellsX+nodeX,
+          typename graph_type::EdgeType NewEdge(nodeY*NumCellsX+nodeX,
                                        row*NumCellsX+col,
                                        dist);
           graph.AddEdge(NewEdge);
@@ -144,8 +147,8 @@ void GraphHelper_DrawUsingGDI(const graph_type& graph, int color, bool DrawNodeI
   gdi->SetPenColor(color);
 
   //draw the nodes 
-  graph_type::ConstNodeIterator NodeItr(graph);
-  for (const graph_type::NodeType* pN=NodeItr.begin();
+  typename graph_type::ConstNodeIterator NodeItr(graph);
+  for (const typename graph_type::NodeType* pN=NodeItr.begin();
       !NodeItr.end();
        pN=NodeItr.next())
   {
@@ -157,8 +160,8 @@ void GraphHelper_DrawUsingGDI(const graph_type& graph, int color, bool DrawNodeI
       gdi->TextAtPos((int)pN->Pos().x+5, (int)pN->Pos().y-5, ttos(pN->Index()));
     }
 
-    graph_type::ConstEdgeIterator EdgeItr(graph, pN->Index());
-    for (const graph_type::EdgeType* pE=EdgeItr.begin();
+    typename graph_type::ConstEdgeIterator EdgeItr(graph, pN->Index());
+    for (const typename graph_type::EdgeType* pE=EdgeItr.begin();
         !EdgeItr.end();
         pE=EdgeItr.next())
     {
@@ -181,8 +184,8 @@ void WeightNavGraphNodeEdges(graph_type& graph, int node, double weight)
   assert(node < graph.NumNodes());
 
   //set the cost for each edge
-  graph_type::ConstEdgeIterator ConstEdgeItr(graph, node);
-  for (const graph_type::EdgeType* pE=ConstEdgeItr.begin();
+  typename graph_type::ConstEdgeIterator ConstEdgeItr(graph, node);
+  for (const typename graph_type::EdgeType* pE=ConstEdgeItr.begin();
        !ConstEdgeItr.end();
        pE=ConstEdgeItr.next())
   {
@@ -202,6 +205,53 @@ void WeightNavGraphNodeEdges(graph_type& graph, int node, double weight)
 }
 
 
+//------------------------ CalculateShortestPathsRow --------------------------
+//
+//  fills ShortestPaths[source] with the first node to visit on the shortest
+//  path from source to each node. Used by CreateAllPairsTable. Only the
+//  source's own row is written so rows can be calculated concurrently
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void CalculateShortestPathsRow(const graph_type&                G,
+                               int                              source,
+                               std::vector<std::vector<int> >&  ShortestPaths)
+{
+  enum {no_path = -1};
+
+  //calculate the SPT for this node
+  Graph_SearchDijkstra<graph_type> search(G, source);
+
+  std::vector<const typename graph_type::EdgeType*> spt = search.GetSPT();
+
+  std::vector<int>& row = ShortestPaths[source];
+
+  row[source] = source;
+
+  //now we have the SPT it's easy to work backwards through it from each
+  //target to find the first node after the source. Every node passed on the
+  //way has the same first node so it is recorded for them too, which means
+  //no branch of the SPT is walked more than once
+  for (int target = 0; target<G.NumNodes(); ++target)
+  {
+    //skip nodes already done and nodes that can't be reached
+    if (row[target] != no_path || spt[target] == 0) continue;
+
+    int nd = target;
+
+    while ((spt[nd]->From() != source) && (row[nd] == no_path))
+    {
+      nd = spt[nd]->From();
+    }
+
+    const int first = (row[nd] == no_path) ? nd : row[nd];
+
+    for (nd = target; row[nd] == no_path; nd = spt[nd]->From())
+    {
+      row[nd] = first;
+    }
+  }//next target node
+}
+
 //----------------------- CreateAllPairsTable ---------------------------------
 //
 // creates a lookup table encoding the shortest path info between each node
@@ -218,39 +268,62 @@ std::vector<std::vector<int> > CreateAllPairsTable(const graph_type& G)
 
   for (int source=0; source<G.NumNodes(); ++source)
   {
-    //calculate the SPT for this node
-    Graph_SearchDijkstra<graph_type> search(G, source);
-
-    std::vector<const graph_type::EdgeType*> spt = search.GetSPT();
+    CalculateShortestPathsRow(G, source, ShortestPaths);
+  }
 
-    //now we have the SPT it's easy to work backwards through it to find
-    //the shortest paths from each node to this source node
-    for (int target = 0; target<G.NumNodes(); ++target)
-    {
-      //if the source node is the same as the target just set to target
-      if (source == target)
-      {
-        ShortestPaths[source][target] = target;
-      }
+  return ShortestPaths;
+}
 
-      else
-      {
-        int nd = target;
+//----------------------- CreateAllPairsTable ---------------------------------
+//
+//  as above but the search from each source node is run on the thread pool.
+//  ReportProgress, if given, is called on the calling thread with the number
+//  of source nodes searched so far
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::vector<std::vector<int> > CreateAllPairsTable(const graph_type&        G,
+                                                   ThreadPool&              pool,
+                                                   ThreadPool::ProgressFunc ReportProgress = NULL)
+{
+  enum {no_path = -1};
+  
+  std::vector<int> row(G.NumNodes(), no_path);
+  
+  std::vector<std::vector<int> > ShortestPaths(G.NumNodes(), row);
 
-        while ((nd != source) && (spt[nd] != 0))
-        {
-          ShortestPaths[spt[nd]->From][target]= nd;
-
-          nd = spt[nd]->From;
-        }
-      }
-    }//next target node
-  }//next source node
+  pool.ParallelFor(0, G.NumNodes(),
+                   [&](int source){CalculateShortestPathsRow(G, source, ShortestPaths);},
+                   ReportProgress);
 
   return ShortestPaths;
 }
 
 
+//--------------------------- CalculateCostsRow -------------------------------
+//
+//  fills PathCosts[source] with the cost of traveling from source to every
+//  other node. Used by CreateAllPairsCostsTable. Each call only writes to its
+//  own row so rows can be calculated concurrently
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void CalculateCostsRow(const graph_type&                   G,
+                       int                                 source,
+                       std::vector<std::vector<double> >&  PathCosts)
+{
+  //do the search
+  Graph_SearchDijkstra<graph_type> search(G, source);
+
+  //iterate through every node in the graph and grab the cost to travel to
+  //that node
+  for (int target = 0; target<G.NumNodes(); ++target)
+  {
+    if (source != target)
+    {
+      PathCosts[source][target]= search.GetCostToNode(target);
+    }
+  }//next target node
+}
+
 //----------------------- CreateAllPairsCostsTable -------------------------------
 //
 //  creates a lookup table of the cost associated from traveling from one
@@ -265,24 +338,64 @@ std::vector<std::vector<double> > CreateAllPairsCostsTable(const graph_type& G)
 
   for (int source=0; source<G.NumNodes(); ++source)
   {
-    //do the search
-    Graph_SearchDijkstra<graph_type> search(G, source);
+    CalculateCostsRow(G, source, PathCosts);
+  }
 
-    //iterate through every node in the graph and grab the cost to travel to
-    //that node
-    for (int target = 0; target<G.NumNodes(); ++target)
-    {
-      if (source != target)
-      {
-        PathCosts[source][target]= search.GetCostToNode(target);
-      }
-    }//next target node
-    
-  }//next source node
+  return PathCosts;
+}
+
+//----------------------- CreateAllPairsCostsTable -------------------------------
+//
+//  as above but the search from each source node is run on the thread pool.
+//  ReportProgress, if given, is called on the calling thread with the number
+//  of source nodes searched so far
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::vector<std::vector<double> > CreateAllPairsCostsTable(const graph_type&        G,
+                                                           ThreadPool&              pool,
+                                                           ThreadPool::ProgressFunc ReportProgress = NULL)
+{
+  //create a two dimensional vector
+  std::vector<double> row(G.NumNodes(), 0.0);
+  std::vector<std::vector<double> > PathCosts(G.NumNodes(), row);
+
+  pool.ParallelFor(0, G.NumNodes(),
+                   [&](int source){CalculateCostsRow(G, source, PathCosts);},
+                   ReportProgress);
 
   return PathCosts;
 }
 
+//------------------------- CalculateGraphHash --------------------------------
+//
+//  returns a 64 bit FNV-1a hash of the graph as written by its Save method.
+//  Use this to check that data calculated from a graph and stored elsewhere,
+//  such as a cached cost table, still belongs to the graph
+//-----------------------------------------------------------------------------
+template <class graph_type>
+unsigned long long CalculateGraphHash(const graph_type& G)
+{
+  std::ostringstream ss;
+
+  //write enough digits that graphs differing only slightly in their node
+  //positions or edge costs hash differently
+  ss.precision(17);
+
+  G.Save(ss);
+
+  const std::string s = ss.str();
+
+  unsigned long long hash = 14695981039346656037ULL;
+
+  for (unsigned int c=0; c<s.size(); ++c)
+  {
+    hash ^= (unsigned char)s[c];
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
 //---------------------- CalculateAverageGraphEdgeLength ----------------------
 //
 //  determines the average length of the edges in a navgraph (using the 
@@ -296,12 +409,12 @@ double CalculateAverageGraphEdgeLength(const graph_type& G)
   double TotalLength = 0;
   int NumEdgesCounted = 0;
 
-  graph_type::ConstNodeIterator NodeItr(G);
-  const graph_type::NodeType* pN;
+  typename graph_type::ConstNodeIterator NodeItr(G);
+  const typename graph_type::NodeType* pN;
   for (pN = NodeItr.begin(); !NodeItr.end(); pN=NodeItr.next())
   {
-    graph_type::ConstEdgeIterator EdgeItr(G, pN->Index());
-    for (const graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    typename graph_type::ConstEdgeIterator EdgeItr(G, pN->Index());
+    for (const typename graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
     {
       //increment edge counter
       ++NumEdgesCounted;
@@ -323,12 +436,12 @@ double GetCostliestGraphEdge(const graph_type& G)
 {
   double greatest = MinDouble;
 
-  graph_type::ConstNodeIterator NodeItr(G);
-  const graph_type::NodeType* pN;
+  typename graph_type::ConstNodeIterator NodeItr(G);
+  const typename graph_type::NodeType* pN;
   for (pN = NodeItr.begin(); !NodeItr.end(); pN=NodeItr.next())
   {
-    graph_type::ConstEdgeIterator EdgeItr(G, pN->Index());
-    for (const graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    typename graph_type::ConstEdgeIterator EdgeItr(G, pN->Index());
+    for (const typename graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
     {
       if (pE->Cost() > greatest)greatest = pE->Cost();
     }
@@ -0,0 +1,696 @@
+#ifndef HIERARCHICALGRAPH_H
+#define HIERARCHICALGRAPH_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   HierarchicalGraph.h
+//
+//  Desc:   an abstract graph built over a navigation graph for hierarchical
+//          path planning (HPA*).
+//
+//          The nodes are divided into square clusters by position. Where
+//          edges cross from one cluster into a neighbouring one, the edges
+//          that run side by side are treated as a single entrance and one
+//          of them is chosen to represent it. The nodes at either end of
+//          the chosen edges are the nodes of the abstract graph. Each pair
+//          of entrances in a cluster is joined by an abstract edge whose
+//          cost is that of the cheapest path between them which stays
+//          inside the cluster, and the chosen edges join the entrances of
+//          neighbouring clusters.
+//
+//          FindRoute plans a route across the abstract graph, which has far
+//          fewer nodes than the navigation graph. The route is a list of
+//          waypoints, and RefineSegment fills in the edges between a pair of
+//          them with a search confined to one cluster. A path can therefore
+//          be refined a stretch at a time as it is followed.
+//
+//          The graph must be undirected and must conform to the same
+//          interface as SparseGraph. Routes are close to the cheapest
+//          possible but are not guaranteed to be the cheapest.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "2D/Vector2D.h"
+#include "misc/PriorityQueue.h"
+#include "misc/utils.h"
+#include "Graph/NodeTypeEnumerations.h"
+
+
+template <class graph_type>
+class HierarchicalGraph
+{
+public:
+
+  typedef typename graph_type::NodeType  NodeType;
+  typedef typename graph_type::EdgeType  EdgeType;
+
+private:
+
+  struct AbstractEdge
+  {
+    int     To;
+    double  Cost;
+  };
+
+  const graph_type&               m_Graph;
+
+  double                          m_dClusterSize;
+
+  int                             m_iNumClustersX;
+  int                             m_iNumClustersY;
+
+  //the top left corner of the first cluster
+  Vector2D                        m_vOrigin;
+
+  //the cluster each node is in (-1 for nodes removed from the graph), the
+  //nodes in each cluster and the position of each node in its cluster's
+  //list. Searches confined to a cluster index their arrays with the latter
+  std::vector<int>                m_ClusterOfNode;
+  std::vector<std::vector<int> >  m_ClusterNodes;
+  std::vector<int>                m_LocalIndex;
+
+  //the abstract nodes in each cluster
+  std::vector<std::vector<int> >  m_ClusterEntrances;
+
+  //the node each abstract node stands for, and the abstract node standing
+  //for each node (-1 if the node isn't an entrance)
+  std::vector<int>                m_NodeOfAbstract;
+  std::vector<int>                m_AbstractOfNode;
+
+  //the edges leading from abstract node a are m_AbstractEdges[
+  //m_AbstractEdgeOffsets[a]] to m_AbstractEdges[m_AbstractEdgeOffsets[a+1]-1]
+  std::vector<int>                m_AbstractEdgeOffsets;
+  std::vector<AbstractEdge>       m_AbstractEdges;
+
+  bool  isValidNode(int nd)const{return m_Graph.GetNode(nd).Index() != invalid_node_index;}
+
+  int   CalculateCluster(Vector2D pos)const;
+
+  //returns true if there is an edge between the two nodes
+  bool  AreAdjacent(int nd1, int nd2)const;
+
+  void  CreateClusters();
+
+  //chooses the entrances and returns the edges chosen to join them
+  void  CreateEntrances(std::vector<const EdgeType*>& links);
+
+  void  CreateAbstractEdges(const std::vector<const EdgeType*>& links);
+
+  //searches from source without leaving its cluster. If target is -1 the
+  //cost to every node in the cluster is calculated, else the search stops
+  //at the target. costs and spt are indexed by position in the cluster's
+  //list of nodes and the cost to an unreachable node is MaxDouble
+  void  SearchCluster(int                            source,
+                      int                            target,
+                      std::vector<double>&           costs,
+                      std::vector<const EdgeType*>&  spt)const;
+
+  //copying makes no sense
+  HierarchicalGraph(const HierarchicalGraph&);
+  HierarchicalGraph& operator=(const HierarchicalGraph&);
+
+public:
+
+  //the graph must outlive the hierarchical graph and its edges must not
+  //change. ClusterSize is the width and height of each cluster
+  HierarchicalGraph(const graph_type& G, double ClusterSize);
+
+  //plans a route from source to target across the abstract graph. route is
+  //filled with the waypoints, the first being the source and the last the
+  //target, and cost with the cost of the route. Returns false if there is no
+  //route
+  bool  FindRoute(int source, int target, std::vector<int>& route, double& cost)const;
+
+  //fills edges with the edges leading from one waypoint of a route to the
+  //next. Returns false if there is no way between them
+  bool  RefineSegment(int from, int to, std::vector<const EdgeType*>& edges)const;
+
+  const graph_type& GetGraph()const{return m_Graph;}
+
+  int   ClusterOf(int nd)const{return m_ClusterOfNode[nd];}
+
+  int   NumClusters()const{return m_ClusterNodes.size();}
+  int   NumAbstractNodes()const{return m_NodeOfAbstract.size();}
+  int   NumAbstractEdges()const{return m_AbstractEdges.size();}
+};
+
+
+//-------------------------------- ctor ---------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+HierarchicalGraph<graph_type>::HierarchicalGraph(const graph_type& G,
+                                                 double            ClusterSize):m_Graph(G),
+                                                                                m_dClusterSize(ClusterSize),
+                                                                                m_iNumClustersX(1),
+                                                                                m_iNumClustersY(1)
+{
+  assert (ClusterSize > 0 && "<HierarchicalGraph::ctor>: cluster size must be positive");
+  assert (!G.isDigraph() && "<HierarchicalGraph::ctor>: the graph must be undirected");
+
+  CreateClusters();
+
+  std::vector<const EdgeType*> links;
+
+  CreateEntrances(links);
+
+  CreateAbstractEdges(links);
+}
+
+//-------------------------- CalculateCluster ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int HierarchicalGraph<graph_type>::CalculateCluster(Vector2D pos)const
+{
+  int x = (int)((pos.x - m_vOrigin.x) / m_dClusterSize);
+  int y = (int)((pos.y - m_vOrigin.y) / m_dClusterSize);
+
+  Clamp(x, 0, m_iNumClustersX-1);
+  Clamp(y, 0, m_iNumClustersY-1);
+
+  return y * m_iNumClustersX + x;
+}
+
+//----------------------------- AreAdjacent -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool HierarchicalGraph<graph_type>::AreAdjacent(int nd1, int nd2)const
+{
+  typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd1);
+
+  for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+  {
+    if (pE->To() == nd2) return true;
+  }
+
+  return false;
+}
+
+//---------------------------- CreateClusters ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::CreateClusters()
+{
+  //find the extent of the graph
+  bool     bFirst = true;
+  Vector2D TopLeft, BottomRight;
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isValidNode(nd)) continue;
+
+    const Vector2D& pos = m_Graph.GetNode(nd).Pos();
+
+    if (bFirst)
+    {
+      TopLeft = BottomRight = pos; bFirst = false;
+    }
+
+    TopLeft.x     = std::min(TopLeft.x, pos.x);
+    TopLeft.y     = std::min(TopLeft.y, pos.y);
+    BottomRight.x = std::max(BottomRight.x, pos.x);
+    BottomRight.y = std::max(BottomRight.y, pos.y);
+  }
+
+  m_vOrigin       = TopLeft;
+  m_iNumClustersX = (int)((BottomRight.x - TopLeft.x) / m_dClusterSize) + 1;
+  m_iNumClustersY = (int)((BottomRight.y - TopLeft.y) / m_dClusterSize) + 1;
+
+  m_ClusterOfNode.assign(m_Graph.NumNodes(), -1);
+  m_LocalIndex.assign(m_Graph.NumNodes(), -1);
+  m_ClusterNodes.assign(m_iNumClustersX * m_iNumClustersY, std::vector<int>());
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isValidNode(nd)) continue;
+
+    int cluster = CalculateCluster(m_Graph.GetNode(nd).Pos());
+
+    m_ClusterOfNode[nd] = cluster;
+    m_LocalIndex[nd]    = m_ClusterNodes[cluster].size();
+
+    m_ClusterNodes[cluster].push_back(nd);
+  }
+}
+
+//---------------------------- CreateEntrances -------------------------------
+//
+//  the edges crossing between each pair of clusters are grouped. Two edges
+//  are in the same group if the nodes they lead from are the same or are
+//  joined by an edge, and so are the nodes they lead to. A bot can then
+//  switch from one edge in a group to another without leaving either
+//  cluster, so only one edge of each group is needed in the abstract graph:
+//  the one nearest the middle of the group
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::CreateEntrances(std::vector<const EdgeType*>& links)
+{
+  //collect the edges that cross from one cluster into another. As the graph
+  //is undirected each crossing is only taken from the lower numbered cluster
+  std::vector<std::vector<const EdgeType*> > crossings;
+  std::vector<std::pair<int, int> >          ClusterPairs;
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isValidNode(nd)) continue;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      const int from = m_ClusterOfNode[pE->From()];
+      const int to   = m_ClusterOfNode[pE->To()];
+
+      if (to < 0 || from >= to) continue;
+
+      const std::pair<int, int> key(from, to);
+
+      unsigned int p = std::find(ClusterPairs.begin(), ClusterPairs.end(), key) - ClusterPairs.begin();
+
+      if (p == ClusterPairs.size())
+      {
+        ClusterPairs.push_back(key);
+        crossings.push_back(std::vector<const EdgeType*>());
+      }
+
+      crossings[p].push_back(pE);
+    }
+  }
+
+  std::vector<bool> isEntrance(m_Graph.NumNodes(), false);
+
+  for (unsigned int p=0; p<crossings.size(); ++p)
+  {
+    const std::vector<const EdgeType*>& edges = crossings[p];
+
+    //label the groups. group[i] is the lowest index of an edge in the same
+    //group as edge i
+    std::vector<int> group(edges.size());
+
+    for (unsigned int i=0; i<edges.size(); ++i)
+    {
+      group[i] = i;
+
+      for (unsigned int j=0; j<i; ++j)
+      {
+        const bool bFromJoined = edges[i]->From() == edges[j]->From() ||
+                                 AreAdjacent(edges[i]->From(), edges[j]->From());
+
+        const bool bToJoined   = edges[i]->To() == edges[j]->To() ||
+                                 AreAdjacent(edges[i]->To(), edges[j]->To());
+
+        if (!bFromJoined || !bToJoined) continue;
+
+        //merge the two groups
+        const int merged = std::min(group[i], group[j]);
+        const int old    = std::max(group[i], group[j]);
+
+        for (unsigned int k=0; k<=i; ++k)
+        {
+          if (group[k] == old) group[k] = merged;
+        }
+      }
+    }
+
+    //choose the edge closest to the middle of each group
+    for (unsigned int g=0; g<edges.size(); ++g)
+    {
+      Vector2D middle;
+      int      NumInGroup = 0;
+
+      for (unsigned int i=0; i<edges.size(); ++i)
+      {
+        if (group[i] != (int)g) continue;
+
+        middle += m_Graph.GetNode(edges[i]->From()).Pos() + m_Graph.GetNode(edges[i]->To()).Pos();
+
+        ++NumInGroup;
+      }
+
+      if (NumInGroup == 0) continue;
+
+      middle /= 2.0 * NumInGroup;
+
+      const EdgeType* pBest = NULL;
+      double          BestDistSq = MaxDouble;
+
+      for (unsigned int i=0; i<edges.size(); ++i)
+      {
+        if (group[i] != (int)g) continue;
+
+        const Vector2D EdgeMiddle = (m_Graph.GetNode(edges[i]->From()).Pos() +
+                                     m_Graph.GetNode(edges[i]->To()).Pos()) / 2.0;
+
+        const double DistSq = Vec2DDistanceSq(EdgeMiddle, middle);
+
+        if (DistSq < BestDistSq)
+        {
+          BestDistSq = DistSq;
+          pBest      = edges[i];
+        }
+      }
+
+      links.push_back(pBest);
+
+      isEntrance[pBest->From()] = true;
+      isEntrance[pBest->To()]   = true;
+    }
+  }
+
+  //number the abstract nodes
+  m_AbstractOfNode.assign(m_Graph.NumNodes(), -1);
+  m_ClusterEntrances.assign(m_ClusterNodes.size(), std::vector<int>());
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!isEntrance[nd]) continue;
+
+    m_AbstractOfNode[nd] = m_NodeOfAbstract.size();
+
+    m_ClusterEntrances[m_ClusterOfNode[nd]].push_back(m_NodeOfAbstract.size());
+
+    m_NodeOfAbstract.push_back(nd);
+  }
+}
+
+//-------------------------- CreateAbstractEdges ------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::CreateAbstractEdges(const std::vector<const EdgeType*>& links)
+{
+  std::vector<std::vector<AbstractEdge> > edges(m_NodeOfAbstract.size());
+
+  //the edges joining neighbouring clusters
+  for (unsigned int l=0; l<links.size(); ++l)
+  {
+    const int from = m_AbstractOfNode[links[l]->From()];
+    const int to   = m_AbstractOfNode[links[l]->To()];
+
+    AbstractEdge edge;
+    edge.Cost = links[l]->Cost();
+
+    edge.To = to;
+    edges[from].push_back(edge);
+
+    edge.To = from;
+    edges[to].push_back(edge);
+  }
+
+  //the edges between the entrances of each cluster
+  std::vector<double>          costs;
+  std::vector<const EdgeType*> spt;
+
+  for (unsigned int c=0; c<m_ClusterEntrances.size(); ++c)
+  {
+    const std::vector<int>& entrances = m_ClusterEntrances[c];
+
+    for (unsigned int e1=0; e1<entrances.size(); ++e1)
+    {
+      SearchCluster(m_NodeOfAbstract[entrances[e1]], -1, costs, spt);
+
+      for (unsigned int e2=0; e2<entrances.size(); ++e2)
+      {
+        const double cost = costs[m_LocalIndex[m_NodeOfAbstract[entrances[e2]]]];
+
+        if (e1 == e2 || cost == MaxDouble) continue;
+
+        AbstractEdge edge;
+        edge.To   = entrances[e2];
+        edge.Cost = cost;
+
+        edges[entrances[e1]].push_back(edge);
+      }
+    }
+  }
+
+  //lay the edges out in compressed sparse row form
+  m_AbstractEdgeOffsets.assign(m_NodeOfAbstract.size() + 1, 0);
+
+  for (unsigned int a=0; a<edges.size(); ++a)
+  {
+    m_AbstractEdgeOffsets[a] = m_AbstractEdges.size();
+
+    m_AbstractEdges.insert(m_AbstractEdges.end(), edges[a].begin(), edges[a].end());
+  }
+
+  m_AbstractEdgeOffsets[m_NodeOfAbstract.size()] = m_AbstractEdges.size();
+}
+
+//----------------------------- SearchCluster ---------------------------------
+//
+//  A* (Dijkstra if there is no target) over the nodes of one cluster
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void HierarchicalGraph<graph_type>::SearchCluster(int                            source,
+                                                  int                            target,
+                                                  std::vector<double>&           costs,
+                                                  std::vector<const EdgeType*>&  spt)const
+{
+  const int               cluster = m_ClusterOfNode[source];
+  const std::vector<int>& nodes   = m_ClusterNodes[cluster];
+
+  costs.assign(nodes.size(), MaxDouble);
+  spt.assign(nodes.size(), NULL);
+
+  std::vector<double>          FCosts(nodes.size(), 0.0);
+  std::vector<const EdgeType*> frontier(nodes.size(), NULL);
+  std::vector<bool>            settled(nodes.size(), false);
+
+  IndexedPriorityQLow<double> pq(FCosts, nodes.size());
+
+  costs[m_LocalIndex[source]] = 0.0;
+
+  pq.insert(m_LocalIndex[source]);
+
+  while (!pq.empty())
+  {
+    const int next = pq.Pop();
+
+    settled[next] = true;
+    spt[next]     = frontier[next];
+
+    if (nodes[next] == target) return;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nodes[next]);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (m_ClusterOfNode[pE->To()] != cluster) continue;
+
+      const int to = m_LocalIndex[pE->To()];
+
+      if (settled[to]) continue;
+
+      const double GCost = costs[next] + pE->Cost();
+      const double HCost = target < 0 ? 0.0 : Vec2DDistance(m_Graph.GetNode(pE->To()).Pos(),
+                                                            m_Graph.GetNode(target).Pos());
+
+      if (frontier[to] == NULL)
+      {
+        costs[to]    = GCost;
+        FCosts[to]   = GCost + HCost;
+        frontier[to] = pE;
+
+        pq.insert(to);
+      }
+      else if (GCost < costs[to])
+      {
+        costs[to]    = GCost;
+        FCosts[to]   = GCost + HCost;
+        frontier[to] = pE;
+
+        pq.ChangePriority(to);
+      }
+    }
+  }
+}
+
+//------------------------------ FindRoute ------------------------------------
+//
+//  the source and target are joined to the entrances of their clusters for
+//  the duration of the search, with costs found by searching each cluster.
+//  They are given the abstract indices NumAbstractNodes() and
+//  NumAbstractNodes()+1
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool HierarchicalGraph<graph_type>::FindRoute(int               source,
+                                              int               target,
+                                              std::vector<int>& route,
+                                              double&           cost)const
+{
+  route.clear();
+  cost = 0.0;
+
+  if (m_ClusterOfNode[source] < 0 || m_ClusterOfNode[target] < 0) return false;
+
+  if (source == target)
+  {
+    route.push_back(source); return true;
+  }
+
+  const int SourceCluster = m_ClusterOfNode[source];
+  const int TargetCluster = m_ClusterOfNode[target];
+
+  //the cost from the source to each node in its cluster, and (the graph
+  //being undirected) from each node in the target's cluster to the target
+  std::vector<double>          SourceCosts, TargetCosts;
+  std::vector<const EdgeType*> spt;
+
+  SearchCluster(source, -1, SourceCosts, spt);
+  SearchCluster(target, -1, TargetCosts, spt);
+
+  const int AbstractSource = NumAbstractNodes();
+  const int AbstractTarget = NumAbstractNodes() + 1;
+
+  std::vector<double> GCosts(NumAbstractNodes() + 2, 0.0);
+  std::vector<double> FCosts(NumAbstractNodes() + 2, 0.0);
+  std::vector<int>    parent(NumAbstractNodes() + 2, -1);
+
+  //0 = not yet seen, 1 = on the frontier, 2 = settled
+  std::vector<char>   state(NumAbstractNodes() + 2, 0);
+
+  IndexedPriorityQLow<double> pq(FCosts, NumAbstractNodes() + 2);
+
+  const Vector2D TargetPos = m_Graph.GetNode(target).Pos();
+
+  //adds or updates the frontier with the edge from one abstract node to
+  //another
+  auto relax = [&](int from, int to, double EdgeCost)
+  {
+    if (state[to] == 2) return;
+
+    const double GCost = GCosts[from] + EdgeCost;
+
+    if (state[to] == 1 && GCost >= GCosts[to]) return;
+
+    const double HCost = to == AbstractTarget ? 0.0 :
+                         Vec2DDistance(m_Graph.GetNode(m_NodeOfAbstract[to]).Pos(), TargetPos);
+
+    GCosts[to] = GCost;
+    FCosts[to] = GCost + HCost;
+    parent[to] = from;
+
+    if (state[to] == 0)
+    {
+      state[to] = 1; pq.insert(to);
+    }
+    else
+    {
+      pq.ChangePriority(to);
+    }
+  };
+
+  state[AbstractSource] = 1;
+  pq.insert(AbstractSource);
+
+  while (!pq.empty())
+  {
+    const int next = pq.Pop();
+
+    state[next] = 2;
+
+    if (next == AbstractTarget) break;
+
+    if (next == AbstractSource)
+    {
+      const std::vector<int>& entrances = m_ClusterEntrances[SourceCluster];
+
+      for (unsigned int e=0; e<entrances.size(); ++e)
+      {
+        const double EdgeCost = SourceCosts[m_LocalIndex[m_NodeOfAbstract[entrances[e]]]];
+
+        if (EdgeCost != MaxDouble) relax(next, entrances[e], EdgeCost);
+      }
+
+      //the target may be reachable without leaving the cluster
+      if (SourceCluster == TargetCluster && SourceCosts[m_LocalIndex[target]] != MaxDouble)
+      {
+        relax(next, AbstractTarget, SourceCosts[m_LocalIndex[target]]);
+      }
+
+      continue;
+    }
+
+    for (int e=m_AbstractEdgeOffsets[next]; e<m_AbstractEdgeOffsets[next+1]; ++e)
+    {
+      relax(next, m_AbstractEdges[e].To, m_AbstractEdges[e].Cost);
+    }
+
+    const int nd = m_NodeOfAbstract[next];
+
+    if (m_ClusterOfNode[nd] == TargetCluster && TargetCosts[m_LocalIndex[nd]] != MaxDouble)
+    {
+      relax(next, AbstractTarget, TargetCosts[m_LocalIndex[nd]]);
+    }
+  }
+
+  if (state[AbstractTarget] != 2) return false;
+
+  cost = GCosts[AbstractTarget];
+
+  //work back from the target, skipping the source or target entrance when
+  //the source or target is itself an entrance
+  for (int a=AbstractTarget; a != -1; a=parent[a])
+  {
+    const int nd = a == AbstractTarget ? target :
+                   a == AbstractSource ? source : m_NodeOfAbstract[a];
+
+    if (route.empty() || route.back() != nd) route.push_back(nd);
+  }
+
+  std::reverse(route.begin(), route.end());
+
+  return true;
+}
+
+//---------------------------- RefineSegment ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool HierarchicalGraph<graph_type>::RefineSegment(int                            from,
+                                                  int                            to,
+                                                  std::vector<const EdgeType*>&  edges)const
+{
+  edges.clear();
+
+  if (from == to) return true;
+
+  //waypoints in different clusters are joined by a single edge
+  if (m_ClusterOfNode[from] != m_ClusterOfNode[to])
+  {
+    const EdgeType* pBest = NULL;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, from);
+
+    for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (pE->To() == to && (!pBest || pE->Cost() < pBest->Cost())) pBest = pE;
+    }
+
+    if (!pBest) return false;
+
+    edges.push_back(pBest);
+
+    return true;
+  }
+
+  std::vector<double>          costs;
+  std::vector<const EdgeType*> spt;
+
+  SearchCluster(from, to, costs, spt);
+
+  if (costs[m_LocalIndex[to]] == MaxDouble) return false;
+
+  for (int nd=to; nd != from; nd=spt[m_LocalIndex[nd]]->From())
+  {
+    edges.push_back(spt[m_LocalIndex[nd]]);
+  }
+
+  std::reverse(edges.begin(), edges.end());
+
+  return true;
+}
+
+
+
+#endif
@@ -15,11 +15,12 @@
 #include <cassert>
 #include <string>
 #include <iostream>
+#include <fstream>
 
 
 #include "2D/Vector2D.h"
 #include "misc/utils.h" 
-#include "graph/NodeTypeEnumerations.h"
+#include "Graph/NodeTypeEnumerations.h"
 
 
 
@@ -104,6 +105,14 @@ public:
   //sets the cost of an edge
   void  SetEdgeCost(int from, int to, double cost);
 
+  //these add a node or an edge exactly as given, without the checks made by
+  //AddNode and AddEdge and without adding the opposite edge of an undirected
+  //graph. They are for restoring a graph from a copy of its nodes and edge
+  //lists: nodes must be restored in index order, including any that have
+  //been removed, and edges in the order they appear in their edge list
+  void  RestoreNode(const NodeType& node);
+  void  RestoreEdge(const EdgeType& edge);
+
   //returns the number of active + inactive nodes present in the graph
   int   NumNodes()const{return m_Nodes.size();}
   
@@ -123,7 +132,7 @@ public:
   {
     int tot = 0;
 
-    for (EdgeListVector::const_iterator curEdge = m_Edges.begin();
+    for (typename EdgeListVector::const_iterator curEdge = m_Edges.begin();
          curEdge != m_Edges.end();
          ++curEdge)
     {
@@ -149,7 +158,7 @@ public:
   //methods for loading and saving graphs from an open file stream or from
   //a file name 
   bool  Save(const char* FileName)const;
-  bool  Save(std::ofstream& stream)const;
+  bool  Save(std::ostream& stream)const;
 
   bool  Load(const char* FileName);
   bool  Load(std::ifstream& stream);
@@ -159,7 +168,7 @@ public:
 
   void RemoveEdges()
   {
-    for (EdgeListVector::iterator it = m_Edges.begin(); it != m_Edges.end(); ++it)
+    for (typename EdgeListVector::iterator it = m_Edges.begin(); it != m_Edges.end(); ++it)
     {
       it->clear();
     }
@@ -426,7 +435,7 @@ bool SparseGraph<node_type, edge_type>::isEdgePresent(int from, int to)const
 {
     if (isNodePresent(from) && isNodePresent(from))
     {
-       for (EdgeList::const_iterator curEdge = m_Edges[from].begin();
+       for (typename EdgeList::const_iterator curEdge = m_Edges[from].begin();
             curEdge != m_Edges[from].end();
             ++curEdge)
         {
@@ -479,7 +488,7 @@ const edge_type& SparseGraph<node_type, edge_type>::GetEdge(int from, int to)con
           m_Nodes[to].Index() != invalid_node_index &&
           "<SparseGraph::GetEdge>: invalid 'to' index");
 
-  for (EdgeList::const_iterator curEdge = m_Edges[from].begin();
+  for (typename EdgeList::const_iterator curEdge = m_Edges[from].begin();
        curEdge != m_Edges[from].end();
        ++curEdge)
   {
@@ -503,7 +512,7 @@ edge_type& SparseGraph<node_type, edge_type>::GetEdge(int from, int to)
           m_Nodes[to].Index() != invalid_node_index &&
           "<SparseGraph::GetEdge>: invalid 'to' index");
 
-  for (EdgeList::iterator curEdge = m_Edges[from].begin();
+  for (typename EdgeList::iterator curEdge = m_Edges[from].begin();
        curEdge != m_Edges[from].end();
        ++curEdge)
   {
@@ -563,7 +572,7 @@ void SparseGraph<node_type, edge_type>::RemoveEdge(int from, int to)
   assert ( (from < (int)m_Nodes.size()) && (to < (int)m_Nodes.size()) &&
            "<SparseGraph::RemoveEdge>:invalid node index");
 
-  EdgeList::iterator curEdge;
+  typename EdgeList::iterator curEdge;
   
   if (!m_bDigraph)
   {
@@ -618,6 +627,31 @@ int SparseGraph<node_type, edge_type>::AddNode(node_type node)
   }
 }
 
+//----------------------------- RestoreNode -----------------------------------
+//-----------------------------------------------------------------------------
+template <class node_type, class edge_type>
+void SparseGraph<node_type, edge_type>::RestoreNode(const NodeType& node)
+{
+  assert ((node.Index() == m_iNextNodeIndex || node.Index() == invalid_node_index) &&
+          "<SparseGraph::RestoreNode>: nodes must be restored in index order");
+
+  m_Nodes.push_back(node);
+  m_Edges.push_back(EdgeList());
+
+  ++m_iNextNodeIndex;
+}
+
+//----------------------------- RestoreEdge -----------------------------------
+//-----------------------------------------------------------------------------
+template <class node_type, class edge_type>
+void SparseGraph<node_type, edge_type>::RestoreEdge(const EdgeType& edge)
+{
+  assert( (edge.From() < m_iNextNodeIndex) && (edge.To() < m_iNextNodeIndex) &&
+          "<SparseGraph::RestoreEdge>: invalid node index");
+
+  m_Edges[edge.From()].push_back(edge);
+}
+
 //----------------------- CullInvalidEdges ------------------------------------
 //
 //  iterates through all the edges in the graph and removes any that point
@@ -626,9 +660,9 @@ int SparseGraph<node_type, edge_type>::AddNode(node_type node)
 template <class node_type, class edge_type>
 void SparseGraph<node_type, edge_type>::CullInvalidEdges()
 {
-  for (EdgeListVector::iterator curEdgeList = m_Edges.begin(); curEdgeList != m_Edges.end(); ++curEdgeList)
+  for (typename EdgeListVector::iterator curEdgeList = m_Edges.begin(); curEdgeList != m_Edges.end(); ++curEdgeList)
   {
-    for (EdgeList::iterator curEdge = (*curEdgeList).begin(); curEdge != (*curEdgeList).end(); ++curEdge)
+    for (typename EdgeList::iterator curEdge = (*curEdgeList).begin(); curEdge != (*curEdgeList).end(); ++curEdge)
     {
       if (m_Nodes[curEdge->To()].Index() == invalid_node_index || 
           m_Nodes[curEdge->From()].Index() == invalid_node_index)
@@ -658,11 +692,11 @@ void SparseGraph<node_type, edge_type>::RemoveNode(int node)
   if (!m_bDigraph)
   {    
     //visit each neighbour and erase any edges leading to this node
-    for (EdgeList::iterator curEdge = m_Edges[node].begin(); 
+    for (typename EdgeList::iterator curEdge = m_Edges[node].begin(); 
          curEdge != m_Edges[node].end();
          ++curEdge)
     {
-      for (EdgeList::iterator curE = m_Edges[curEdge->To()].begin();
+      for (typename EdgeList::iterator curE = m_Edges[curEdge->To()].begin();
            curE != m_Edges[curEdge->To()].end();
            ++curE)
       {
@@ -698,7 +732,7 @@ void SparseGraph<node_type, edge_type>::SetEdgeCost(int from, int to, double New
         "<SparseGraph::SetEdgeCost>: invalid index");
 
   //visit each neighbour and erase any edges leading to this node
-  for (EdgeList::iterator curEdge = m_Edges[from].begin(); 
+  for (typename EdgeList::iterator curEdge = m_Edges[from].begin(); 
        curEdge != m_Edges[from].end();
        ++curEdge)
   {
@@ -718,7 +752,7 @@ void SparseGraph<node_type, edge_type>::SetEdgeCost(int from, int to, double New
 template <class node_type, class edge_type>
 bool SparseGraph<node_type, edge_type>::UniqueEdge(int from, int to)const
 {
-  for (EdgeList::const_iterator curEdge = m_Edges[from].begin();
+  for (typename EdgeList::const_iterator curEdge = m_Edges[from].begin();
        curEdge != m_Edges[from].end();
        ++curEdge)
   {
@@ -750,13 +784,13 @@ bool SparseGraph<node_type, edge_type>::Save(const char* FileName)const
 
 //-------------------------------- Save ---------------------------------------
 template <class node_type, class edge_type>
-bool SparseGraph<node_type, edge_type>::Save(std::ofstream& stream)const
+bool SparseGraph<node_type, edge_type>::Save(std::ostream& stream)const
 {
   //save the number of nodes
   stream << m_Nodes.size() << std::endl;
 
   //iterate through the graph nodes and save them
-  NodeVector::const_iterator curNode = m_Nodes.begin();
+  typename NodeVector::const_iterator curNode = m_Nodes.begin();
   for (curNode; curNode!=m_Nodes.end(); ++curNode)
   {
     stream << *curNode;
@@ -769,7 +803,7 @@ bool SparseGraph<node_type, edge_type>::Save(std::ofstream& stream)const
   //iterate through the edges and save them
   for (unsigned int nodeIdx = 0; nodeIdx < m_Nodes.size(); ++nodeIdx)
   {
-    for (EdgeList::const_iterator curEdge = m_Edges[nodeIdx].begin();
+    for (typename EdgeList::const_iterator curEdge = m_Edges[nodeIdx].begin();
          curEdge!=m_Edges[nodeIdx].end(); ++curEdge)
     {
       stream << *curEdge;
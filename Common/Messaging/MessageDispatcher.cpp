@@ -1,7 +1,7 @@
 #include "MessageDispatcher.h"
 #include "Game/BaseGameEntity.h"
-#include "misc/FrameCounter.h"
-#include "game/EntityManager.h"
+#include "Time/CrudeTimer.h"
+#include "Game/EntityManager.h"
 #include "Debug/DebugConsole.h"
 
 using std::set;
@@ -68,7 +68,7 @@ void MessageDispatcher::DispatchMsg(double       delay,
   if (delay <= 0.0)                                                        
   {
     #ifdef SHOW_MESSAGING_INFO
-    debug_con << "\nTelegram dispatched at time: " << TickCounter->GetCurrentFrame()
+    debug_con << "\nTelegram dispatched at time: " << Clock->GetCurrentTime()
          << " by " << sender << " for " << receiver 
          << ". Msg is " << msg << "";
     #endif
@@ -80,7 +80,7 @@ void MessageDispatcher::DispatchMsg(double       delay,
   //else calculate the time when the telegram should be dispatched
   else
   {
-    double CurrentTime = TickCounter->GetCurrentFrame(); 
+    double CurrentTime = Clock->GetCurrentTime(); 
 
     telegram.DispatchTime = CurrentTime + delay;
 
@@ -89,7 +89,7 @@ void MessageDispatcher::DispatchMsg(double       delay,
 
     #ifdef SHOW_MESSAGING_INFO
     debug_con << "\nDelayed telegram from " << sender << " recorded at time " 
-            << TickCounter->GetCurrentFrame() << " for " << receiver
+            << Clock->GetCurrentTime() << " for " << receiver
             << ". Msg is " << msg << "";
     #endif
   }
@@ -103,7 +103,7 @@ void MessageDispatcher::DispatchMsg(double       delay,
 void MessageDispatcher::DispatchDelayedMessages()
 { 
   //first get current time
-  double CurrentTime = TickCounter->GetCurrentFrame(); 
+  double CurrentTime = Clock->GetCurrentTime(); 
 
   //now peek at the queue to see if any telegrams need dispatching.
   //remove all telegrams from the front of the queue that have gone
@@ -26,7 +26,7 @@ class BaseGameEntity;
 
 //to make code easier to read
 const double SEND_MSG_IMMEDIATELY = 0.0;
-const int    NO_ADDITIONAL_INFO   = 0;
+void* const  NO_ADDITIONAL_INFO   = 0;
 const int    SENDER_ID_IRRELEVANT = -1;
 
 
@@ -62,7 +62,7 @@ public:
                    void*       ExtraInfo);
 
   //send out any delayed messages. This method is called each time through   
-  //the main game loop.
+  //the main game loop. Dispatch times are measured by the Clock
   void DispatchDelayedMessages();
 };
 
@@ -6,14 +6,23 @@
 //
 //  Desc:   timer to measure time in seconds
 //
+//          The timer can either report wall clock time or run off a
+//          fixed timestep. In fixed timestep mode time only moves on when
+//          Tick() is called (once per game update) so a simulation can run
+//          faster than real time and two runs started from the same random
+//          seed play out identically. A headless build has no wall clock
+//          and always uses a fixed timestep.
+//
 //  Author: Mat Buckland 2002 (fup@ai-junkie.com)
 //
 //------------------------------------------------------------------------
 
+#ifndef RAVEN_HEADLESS
 //this library must be included
 #pragma comment(lib, "winmm.lib")
 
 #include <windows.h>
+#endif
 
 
 
@@ -27,8 +36,33 @@ private:
   //set to the time (in seconds) when class is instantiated
   double m_dStartTime;
 
+  //true if the timer is running off a fixed timestep rather than the
+  //wall clock
+  bool   m_bFixedTimeStep;
+
+  //the amount of time (in seconds) each call to Tick() moves the
+  //simulated time on by
+  double m_dTimeStep;
+
+  //the amount of simulated time that has elapsed
+  double m_dSimulatedTime;
+
+#ifdef RAVEN_HEADLESS
+  //set the start time
+  CrudeTimer():m_dStartTime(0.0),
+               m_bFixedTimeStep(true),
+               m_dTimeStep(0.0),
+               m_dSimulatedTime(0.0)
+  {}
+#else
   //set the start time
-  CrudeTimer(){m_dStartTime = timeGetTime() * 0.001;}
+  CrudeTimer():m_bFixedTimeStep(false),
+               m_dTimeStep(0.0),
+               m_dSimulatedTime(0.0)
+  {
+    m_dStartTime = timeGetTime() * 0.001;
+  }
+#endif
 
   //copy ctor and assignment should be private
   CrudeTimer(const CrudeTimer&);
@@ -39,7 +73,35 @@ public:
   static CrudeTimer* Instance();
 
   //returns how much time has elapsed since the timer was started
-  double GetCurrentTime(){return timeGetTime() * 0.001 - m_dStartTime;}
+  double GetCurrentTime()
+  {
+    if (m_bFixedTimeStep) return m_dSimulatedTime;
+
+#ifdef RAVEN_HEADLESS
+    return 0.0;
+#else
+    return timeGetTime() * 0.001 - m_dStartTime;
+#endif
+  }
+
+  //switches the timer to fixed timestep mode. Simulated time restarts
+  //from zero and is moved on by TimeStep seconds each call to Tick()
+  void SetFixedTimeStep(double TimeStep)
+  {
+    m_bFixedTimeStep = true;
+    m_dTimeStep      = TimeStep;
+    m_dSimulatedTime = 0.0;
+  }
+
+  bool   isFixedTimeStep()const{return m_bFixedTimeStep;}
+  double TimeStep()const{return m_dTimeStep;}
+
+  //moves simulated time on by one timestep. This has no effect when the
+  //timer is reading the wall clock
+  void Tick()
+  {
+    if (m_bFixedTimeStep) m_dSimulatedTime += m_dTimeStep;
+  }
 
 };
 
@@ -49,4 +111,4 @@ public:
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -9,13 +9,15 @@
 //          section to flow (like 10 times per second) and then only allow 
 //          the program flow to continue if Ready() returns true
 //
+//          The regulator reads the time from the Clock (see CrudeTimer.h)
+//          so it follows the fixed timestep when the clock is using one.
+//          The update jitter comes from the seeded random number generator
+//
 //  Author: Mat Buckland 2003 (fup@ai-junkie.com)
 //
 //------------------------------------------------------------------------
-#pragma comment(lib,"winmm.lib") //if you don't use MSVC make sure this library is included in your project
-#include "mmsystem.h" 
-
 #include "misc/utils.h"
+#include "Time/CrudeTimer.h"
 
 
 
@@ -27,8 +29,10 @@ private:
   //the time period between updates 
   double m_dUpdatePeriod;
 
-  //the next time the regulator allows code flow
-  DWORD m_dwNextUpdateTime;
+  //the next time (in milliseconds) the regulator allows code flow
+  double m_dNextUpdateTime;
+
+  static double CurrentTimeInMilliseconds(){return Clock->GetCurrentTime() * 1000.0;}
 
 
 public:
@@ -36,7 +40,7 @@ public:
   
   Regulator(double NumUpdatesPerSecondRqd)
   {
-    m_dwNextUpdateTime = (DWORD)(timeGetTime()+RandFloat()*1000);
+    m_dNextUpdateTime = CurrentTimeInMilliseconds() + RandFloat()*1000;
 
     if (NumUpdatesPerSecondRqd > 0)
     {
@@ -55,7 +59,7 @@ public:
   }
 
 
-  //returns true if the current time exceeds m_dwNextUpdateTime
+  //returns true if the current time exceeds m_dNextUpdateTime
   bool isReady()
   {
     //if a regulator is instantiated with a zero freq then it goes into
@@ -66,16 +70,16 @@ public:
     //never allow the code to flow
     if (m_dUpdatePeriod < 0) return false;
 
-    DWORD CurrentTime = timeGetTime();
+    double CurrentTime = CurrentTimeInMilliseconds();
 
     //the number of milliseconds the update period can vary per required
     //update-step. This is here to make sure any multiple clients of this class
     //have their updates spread evenly
     static const double UpdatePeriodVariator = 10.0;
 
-    if (CurrentTime >= m_dwNextUpdateTime)
+    if (CurrentTime >= m_dNextUpdateTime)
     {
-      m_dwNextUpdateTime = (DWORD)(CurrentTime + m_dUpdatePeriod + RandInRange(-UpdatePeriodVariator, UpdatePeriodVariator));
+      m_dNextUpdateTime = CurrentTime + m_dUpdatePeriod + RandInRange(-UpdatePeriodVariator, UpdatePeriodVariator);
 
       return true;
     }
@@ -10,7 +10,7 @@
 //          activated when an entity moves within its region of influence.
 //
 //-----------------------------------------------------------------------------
-#include "game/BaseGameEntity.h"
+#include "Game/BaseGameEntity.h"
 #include "TriggerRegion.h"
 
 struct Telegram;
@@ -38,13 +38,17 @@ private:
   //type of trigger.
   int            m_iGraphNodeIndex;
 
+  //the number of times a trigger of this type has been activated or
+  //deactivated
+  static unsigned int s_iNumStateChanges;
+
 protected:
   
   void SetGraphNodeIndex(int idx){m_iGraphNodeIndex = idx;}
 
   void SetToBeRemovedFromGame(){m_bRemoveFromGame = true;}
-  void SetInactive(){m_bActive = false;}
-  void SetActive(){m_bActive = true;}
+  void SetInactive(){if (m_bActive){m_bActive = false; ++s_iNumStateChanges;}}
+  void SetActive(){if (!m_bActive){m_bActive = true; ++s_iNumStateChanges;}}
 
   //returns true if the entity given by a position and bounding radius is
   //overlapping the trigger region
@@ -76,10 +80,20 @@ public:
   virtual void  Update() = 0;
 
   int  GraphNodeIndex()const{return m_iGraphNodeIndex;}
+
+  //returns the trigger's region of influence, or NULL if it hasn't one
+  const TriggerRegion* RegionOfInfluence()const{return m_pRegionOfInfluence;}
   bool isToBeRemoved()const{return m_bRemoveFromGame;}
   bool isActive(){return m_bActive;}
+
+  //anything that depends on which triggers are active can compare this with
+  //the value it last saw to find out if it is out of date
+  static unsigned int NumStateChanges(){return s_iNumStateChanges;}
 };
 
+template <class entity_type>
+unsigned int Trigger<entity_type>::s_iNumStateChanges = 0;
+
  
 //------------------------ AddCircularTriggerRegion ---------------------------
 //-----------------------------------------------------------------------------
@@ -11,18 +11,106 @@
 //           takes care of updating those triggers and of removing them from
 //           the system if their lifetime has expired.
 //
+//           Once the map is loaded the system can be partitioned. The
+//           triggers registered up to then are static: each is placed in
+//           the cells of a grid its region overlaps, and an entity is only
+//           tried against the static triggers in the cells it overlaps.
+//           Triggers registered afterwards are dynamic and are tried against
+//           every entity.
+//
 //-----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "TriggerRegion.h"
+
+
 template <class trigger_type>
 class TriggerSystem
 {
 public:
 
-  typedef std::list<trigger_type*> TriggerList;
+  typedef std::vector<trigger_type*> TriggerList;
 
 private:
 
+  //the triggers in the order they were registered. The static triggers come
+  //first
   TriggerList   m_Triggers; 
 
+  //the number of static triggers
+  unsigned int  m_iNumStatic;
+
+  //each cell holds the positions in m_Triggers of the static triggers whose
+  //regions overlap it, in order. Empty until the system is partitioned
+  std::vector<std::vector<unsigned int> > m_Cells;
+
+  int           m_iNumCellsX;
+  int           m_iNumCellsY;
+
+  double        m_dCellSizeX;
+  double        m_dCellSizeY;
+
+  //the static triggers an entity overlaps. Kept here to save allocating it
+  //for each entity
+  std::vector<unsigned int> m_Candidates;
+
+
+  int  ClampCellX(double x)const
+  {
+    int col = (int)floor(x / m_dCellSizeX);
+
+    if (col < 0) return 0;
+    if (col > m_iNumCellsX-1) return m_iNumCellsX-1;
+
+    return col;
+  }
+
+  int  ClampCellY(double y)const
+  {
+    int row = (int)floor(y / m_dCellSizeY);
+
+    if (row < 0) return 0;
+    if (row > m_iNumCellsY-1) return m_iNumCellsY-1;
+
+    return row;
+  }
+
+  //places each static trigger in the cells its region overlaps. A trigger
+  //without a region is placed in every cell
+  void PartitionStaticTriggers()
+  {
+    for (unsigned int c=0; c<m_Cells.size(); ++c)
+    {
+      m_Cells[c].clear();
+    }
+
+    for (unsigned int t=0; t<m_iNumStatic; ++t)
+    {
+      int left = 0, right = m_iNumCellsX-1, top = 0, bottom = m_iNumCellsY-1;
+
+      const TriggerRegion* pRegion = m_Triggers[t]->RegionOfInfluence();
+
+      if (pRegion)
+      {
+        InvertedAABBox2D box = pRegion->BoundingBox();
+
+        left   = ClampCellX(box.Left());
+        right  = ClampCellX(box.Right());
+        top    = ClampCellY(box.Top());
+        bottom = ClampCellY(box.Bottom());
+      }
+
+      for (int y=top; y<=bottom; ++y)
+      {
+        for (int x=left; x<=right; ++x)
+        {
+          m_Cells[y*m_iNumCellsX + x].push_back(t);
+        }
+      }
+    }
+  }
 
   //this method iterates through all the triggers present in the system and
   //calls their Update method in order that their internal state can be
@@ -30,44 +118,100 @@ private:
   //have their m_bRemoveFromGame field set to true.
   void UpdateTriggers()
   {
-    TriggerList::iterator curTrg = m_Triggers.begin();
-    while (curTrg != m_Triggers.end())
+    unsigned int NumKept       = 0;
+    unsigned int NumStaticKept = 0;
+
+    for (unsigned int t=0; t<m_Triggers.size(); ++t)
     {
       //remove trigger if dead
-      if ((*curTrg)->isToBeRemoved())
+      if (m_Triggers[t]->isToBeRemoved())
       {
-        delete *curTrg;
-
-        curTrg = m_Triggers.erase(curTrg);
+        delete m_Triggers[t];
       }
       else
       {
         //update this trigger
-        (*curTrg)->Update();
+        m_Triggers[t]->Update();
 
-        ++curTrg;
+        if (t < m_iNumStatic) ++NumStaticKept;
+
+        m_Triggers[NumKept++] = m_Triggers[t];
       }
     }
+
+    m_Triggers.resize(NumKept);
+
+    //the static triggers have moved so the cells must be filled again
+    if (NumStaticKept != m_iNumStatic)
+    {
+      m_iNumStatic = NumStaticKept;
+
+      PartitionStaticTriggers();
+    }
   }
 
   //this method iterates through the container of entities passed as a
-  //parameter and passes each one to the Try method of each trigger *provided*
-  //the entity is alive and provided the entity is ready for a trigger update.
+  //parameter and passes each one to the Try method of each trigger it could
+  //be touching *provided* the entity is alive and provided the entity is
+  //ready for a trigger update. The triggers are tried in the order they
+  //were registered
   template <class ContainerOfEntities>
   void TryTriggers(ContainerOfEntities& entities)
   {
     //test each entity against the triggers
-    ContainerOfEntities::iterator curEnt = entities.begin();
+    typename ContainerOfEntities::iterator curEnt = entities.begin();
     for (curEnt; curEnt != entities.end(); ++curEnt)
     {
       //an entity must be ready for its next trigger update and it must be 
       //alive before it is tested against each trigger.
       if ((*curEnt)->isReadyForTriggerUpdate() && (*curEnt)->isAlive())
       {
-        TriggerList::const_iterator curTrg;
-        for (curTrg = m_Triggers.begin(); curTrg != m_Triggers.end(); ++curTrg)
+        unsigned int t = 0;
+
+        if (!m_Cells.empty())
         {
-          (*curTrg)->Try(*curEnt);
+          //gather the static triggers in the cells overlapped by the
+          //entity's bounding box. A trigger may be in more than one of them
+          Vector2D pos = (*curEnt)->Pos();
+          double   r   = (*curEnt)->BRadius();
+
+          int left   = ClampCellX(pos.x - r);
+          int right  = ClampCellX(pos.x + r);
+          int top    = ClampCellY(pos.y - r);
+          int bottom = ClampCellY(pos.y + r);
+
+          m_Candidates.clear();
+
+          for (int y=top; y<=bottom; ++y)
+          {
+            for (int x=left; x<=right; ++x)
+            {
+              const std::vector<unsigned int>& cell = m_Cells[y*m_iNumCellsX + x];
+
+              m_Candidates.insert(m_Candidates.end(), cell.begin(), cell.end());
+            }
+          }
+
+          if (left != right || top != bottom)
+          {
+            std::sort(m_Candidates.begin(), m_Candidates.end());
+
+            m_Candidates.erase(std::unique(m_Candidates.begin(), m_Candidates.end()),
+                               m_Candidates.end());
+          }
+
+          for (unsigned int c=0; c<m_Candidates.size(); ++c)
+          {
+            m_Triggers[m_Candidates[c]]->Try(*curEnt);
+          }
+
+          //the dynamic triggers follow
+          t = m_iNumStatic;
+        }
+
+        for (t; t < m_Triggers.size(); ++t)
+        {
+          m_Triggers[t]->Try(*curEnt);
         }
       }
     }
@@ -76,6 +220,13 @@ private:
 
 public:
 
+  TriggerSystem():m_iNumStatic(0),
+                  m_iNumCellsX(0),
+                  m_iNumCellsY(0),
+                  m_dCellSizeX(0.0),
+                  m_dCellSizeY(0.0)
+  {}
+
   ~TriggerSystem()
   {
     Clear();
@@ -84,13 +235,35 @@ public:
   //this deletes any current triggers and empties the trigger list
   void Clear()
   {
-    TriggerList::iterator curTrg;
+    typename TriggerList::iterator curTrg;
     for (curTrg = m_Triggers.begin(); curTrg != m_Triggers.end(); ++curTrg)
     {
       delete *curTrg;
     }
 
     m_Triggers.clear();
+
+    m_iNumStatic = 0;
+
+    m_Cells.clear();
+  }
+
+  //makes the triggers registered so far static and places them in a grid of
+  //cellsX by cellsY cells covering the given area. Call once the map is
+  //loaded
+  void Partition(double width, double height, int cellsX, int cellsY)
+  {
+    m_iNumCellsX = cellsX;
+    m_iNumCellsY = cellsY;
+
+    m_dCellSizeX = width  / cellsX;
+    m_dCellSizeY = height / cellsY;
+
+    m_Cells.assign(cellsX*cellsY, std::vector<unsigned int>());
+
+    m_iNumStatic = m_Triggers.size();
+
+    PartitionStaticTriggers();
   }
 
   //This method should be called each update-step of the game. It will first
@@ -113,7 +286,7 @@ public:
   //some triggers are required to be rendered (like giver-triggers for example)
   void Render()
   {
-    TriggerList::iterator curTrg;
+    typename TriggerList::iterator curTrg;
     for (curTrg = m_Triggers.begin(); curTrg != m_Triggers.end(); ++curTrg)
     {
       (*curTrg)->Render();
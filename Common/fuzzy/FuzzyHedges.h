@@ -25,7 +25,7 @@ private:
 
 public:
 
-  FzVery(FzSet& ft):m_Set(ft.m_Set){}
+  FzVery(const FzSet& ft):m_Set(ft.m_Set){}
 
   double GetDOM()const
   {
@@ -51,7 +51,7 @@ private:
 
 public:
 
-  FzFairly(FzSet& ft):m_Set(ft.m_Set){}
+  FzFairly(const FzSet& ft):m_Set(ft.m_Set){}
 
   double GetDOM()const
   {
@@ -20,10 +20,12 @@
 
 #include <vector>
 #include <list>
+#include <algorithm>
 #include <cassert>
 
-#include "2d/Vector2D.h"
-#include "2d/InvertedAABBox2D.h"
+#include "2D/Vector2D.h"
+#include "2D/InvertedAABBox2D.h"
+#include "2D/geometry.h"
 #include "misc/utils.h"
 
 
@@ -60,7 +62,8 @@ private:
   std::vector<Cell<entity> >               m_Cells;
 
   //this is used to store any valid neighbors when an agent searches
-  //its neighboring space
+  //its neighboring space. It grows if more entities than MaxEntitys
+  //are found
   std::vector<entity>                      m_Neighbors;
 
   //this iterator will be used by the methods next and begin to traverse
@@ -83,6 +86,11 @@ private:
   //relevant cell's index
   inline int  PositionToIndex(const Vector2D& pos)const;
 
+  //given a coordinate in the game space these return the column/row of
+  //the cell it falls in, clamped to the grid
+  inline int ClampCellX(double x)const;
+  inline int ClampCellY(double y)const;
+
 public:
 
   CellSpacePartition(double width,        //width of the environment
@@ -102,6 +110,10 @@ public:
   //next and end methods to iterate through the vector.
   inline void CalculateNeighbors(Vector2D TargetPos, double QueryRadius);
 
+  //as above, but finds the entities within QueryRadius of any point on the
+  //line segment AB, such as the path a projectile sweeps in an update
+  inline void CalculateNeighborsOfSegment(Vector2D A, Vector2D B, double QueryRadius);
+
   //returns a reference to the entity at the front of the neighbor vector
   inline entity& begin(){m_curNeighbor = m_Neighbors.begin(); return *m_curNeighbor;}
 
@@ -132,8 +144,10 @@ CellSpacePartition<entity>::CellSpacePartition(double  width,        //width of
                   m_dSpaceHeight(height),
                   m_iNumCellsX(cellsX),
                   m_iNumCellsY(cellsY),
-                  m_Neighbors(MaxEntitys, entity())
+                  m_Neighbors()
 {
+  m_Neighbors.reserve(MaxEntitys+1);
+
   //calculate bounds of each cell
   m_dCellSizeX = width  / cellsX;
   m_dCellSizeY = height / cellsY;
@@ -161,45 +175,47 @@ CellSpacePartition<entity>::CellSpacePartition(double  width,        //width of
 //  cells contain entities then they are tested to see if they are situated
 //  within the target's neighborhood region. If they are they are added to
 //  neighbor list
+//
+//  Only the block of cells overlapped by the query box is visited, so the
+//  cost of a query depends on the query radius and not on the total number
+//  of cells
 //------------------------------------------------------------------------
 template<class entity>
 void CellSpacePartition<entity>::CalculateNeighbors(Vector2D TargetPos,
                                                     double   QueryRadius)
 {
-  //create an iterator and set it to the beginning of the neighbor vector
-  std::vector<entity>::iterator curNbor = m_Neighbors.begin();
-  
-  //create the query box that is the bounding box of the target's query
-  //area
-  InvertedAABBox2D QueryBox(TargetPos - Vector2D(QueryRadius, QueryRadius),
-                            TargetPos + Vector2D(QueryRadius, QueryRadius));
+  m_Neighbors.clear();
+
+  //calculate the range of cells overlapped by the bounding box of the
+  //target's query area
+  int left   = ClampCellX(TargetPos.x - QueryRadius);
+  int right  = ClampCellX(TargetPos.x + QueryRadius);
+  int top    = ClampCellY(TargetPos.y - QueryRadius);
+  int bottom = ClampCellY(TargetPos.y + QueryRadius);
 
-  //iterate through each cell and test to see if its bounding box overlaps
-  //with the query box. If it does and it also contains entities then
+  //iterate through each of those cells. If a cell contains entities then
   //make further proximity tests.
-  std::vector<Cell<entity> >::iterator curCell; 
-  for (curCell=m_Cells.begin(); curCell!=m_Cells.end(); ++curCell)
+  for (int y=top; y<=bottom; ++y)
   {
-    //test to see if this cell contains members and if it overlaps the
-    //query box
-    if (curCell->BBox.isOverlappedWith(QueryBox) &&
-       !curCell->Members.empty())
+    for (int x=left; x<=right; ++x)
     {
+      const Cell<entity>& cell = m_Cells[y*m_iNumCellsX + x];
+
       //add any entities found within query radius to the neighbor list
-      std::list<entity>::iterator it = curCell->Members.begin();
-      for (it; it!=curCell->Members.end(); ++it)
+      typename std::list<entity>::const_iterator it = cell.Members.begin();
+      for (it; it!=cell.Members.end(); ++it)
       {     
         if (Vec2DDistanceSq((*it)->Pos(), TargetPos) <
             QueryRadius*QueryRadius)
         {
-          *curNbor++ = *it;
+          m_Neighbors.push_back(*it);
         }
       }    
     }
   }//next cell
 
   //mark the end of the list with a zero.
-  *curNbor = 0;
+  m_Neighbors.push_back(0);
 }
 
 
@@ -210,7 +226,7 @@ void CellSpacePartition<entity>::CalculateNeighbors(Vector2D TargetPos,
 template<class entity>
 void CellSpacePartition<entity>::EmptyCells()
 {
-  std::vector<Cell<entity> >::iterator it = m_Cells.begin();
+  typename std::vector<Cell<entity> >::iterator it = m_Cells.begin();
 
   for (it; it!=m_Cells.end(); ++it)
   {
@@ -236,6 +252,33 @@ inline int CellSpacePartition<entity>::PositionToIndex(const Vector2D& pos)const
   return idx;
 }
 
+//--------------------- ClampCellX/ClampCellY ----------------------------
+//
+//  given a coordinate in the game space these return the column/row of
+//  the cell it falls in, clamped to the grid
+//------------------------------------------------------------------------
+template<class entity>
+inline int CellSpacePartition<entity>::ClampCellX(double x)const
+{
+  int col = (int)(m_iNumCellsX * x / m_dSpaceWidth);
+
+  if (col < 0) return 0;
+  if (col > m_iNumCellsX-1) return m_iNumCellsX-1;
+
+  return col;
+}
+
+template<class entity>
+inline int CellSpacePartition<entity>::ClampCellY(double y)const
+{
+  int row = (int)(m_iNumCellsY * y / m_dSpaceHeight);
+
+  if (row < 0) return 0;
+  if (row > m_iNumCellsY-1) return m_iNumCellsY-1;
+
+  return row;
+}
+
 //----------------------- AddEntity --------------------------------------
 //
 //  Used to add the entitys to the data structure
@@ -273,12 +316,78 @@ inline void CellSpacePartition<entity>::UpdateEntity(const entity&  ent,
   m_Cells[NewIdx].Members.push_back(ent);
 }
 
+//------------------- CalculateNeighborsOfSegment ------------------------
+//
+//  each row of cells the segment passes near is visited in turn. Only the
+//  cells of the row overlapped by the part of the segment within QueryRadius
+//  of the row are examined, so a long diagonal segment doesn't visit the
+//  whole block of cells around it
+//------------------------------------------------------------------------
+template<class entity>
+void CellSpacePartition<entity>::CalculateNeighborsOfSegment(Vector2D A,
+                                                             Vector2D B,
+                                                             double   QueryRadius)
+{
+  m_Neighbors.clear();
+
+  int top    = ClampCellY(std::min(A.y, B.y) - QueryRadius);
+  int bottom = ClampCellY(std::max(A.y, B.y) + QueryRadius);
+
+  for (int y=top; y<=bottom; ++y)
+  {
+    //the band of space whose entities may be in this row. Entities outside
+    //the space are held in the cells along its edges
+    double BandTop    = (y == 0)              ? -MaxDouble : y*m_dCellSizeY - QueryRadius;
+    double BandBottom = (y == m_iNumCellsY-1) ?  MaxDouble : (y+1)*m_dCellSizeY + QueryRadius;
+
+    //find the part of the segment within the band
+    double t0 = 0.0;
+    double t1 = 1.0;
+
+    if (B.y != A.y)
+    {
+      double ta = (BandTop    - A.y) / (B.y - A.y);
+      double tb = (BandBottom - A.y) / (B.y - A.y);
+
+      if (ta > tb) std::swap(ta, tb);
+
+      t0 = std::max(t0, ta);
+      t1 = std::min(t1, tb);
+
+      if (t0 > t1) continue;
+    }
+
+    double x0 = A.x + t0 * (B.x - A.x);
+    double x1 = A.x + t1 * (B.x - A.x);
+
+    int left  = ClampCellX(std::min(x0, x1) - QueryRadius);
+    int right = ClampCellX(std::max(x0, x1) + QueryRadius);
+
+    for (int x=left; x<=right; ++x)
+    {
+      const Cell<entity>& cell = m_Cells[y*m_iNumCellsX + x];
+
+      typename std::list<entity>::const_iterator it = cell.Members.begin();
+      for (it; it!=cell.Members.end(); ++it)
+      {
+        if (DistToLineSegment(A, B, (*it)->Pos()) < QueryRadius)
+        {
+          m_Neighbors.push_back(*it);
+        }
+      }
+    }
+  }
+
+  //mark the end of the list with a zero.
+  m_Neighbors.push_back(0);
+}
+
 //-------------------------- RenderCells -----------------------------------
 //--------------------------------------------------------------------------
 template<class entity>
 inline void CellSpacePartition<entity>::RenderCells()const
 {
-  std::vector<Cell<entity> >::const_iterator curCell;
+  typename std::vector<Cell<entity> >::const_iterator curCell;
   for (curCell=m_Cells.begin(); curCell!=m_Cells.end(); ++curCell)
   {
     curCell->BBox.Render(false);
@@ -13,7 +13,6 @@
 //  Author: Mat Buckland 2001 (fup@ai-junkie.com)
 //
 //------------------------------------------------------------------------
-#include <windows.h>
 #include <string>
 #include <vector>
 #include <cassert>
@@ -21,6 +20,125 @@
 #include "2D/Vector2D.h"
 
 
+#ifdef RAVEN_HEADLESS
+
+//a headless build has no device context to draw into, so this version of
+//the class just acts as a sink for every drawing call (in the same way
+//CSink stands in for the debug console). The interface mirrors the GDI
+//version below so that the entities' Render methods compile unchanged.
+typedef unsigned long COLORREF;
+
+const int NumColors = 15;
+
+#define gdi Cgdi::Instance()
+
+class Cgdi
+{
+public:
+
+  int NumPenColors()const{return NumColors;}
+
+  enum
+  {
+    red,
+    blue,
+    green,
+    black,
+    pink,
+    grey,
+    yellow,
+    orange,
+    purple,
+    brown,
+    white,
+    dark_green,
+    light_blue,
+    light_grey,
+    light_pink,
+    hollow
+  };
+
+private:
+
+  Cgdi(){}
+
+  //copy ctor and assignment should be private
+  Cgdi(const Cgdi&);
+  Cgdi& operator=(const Cgdi&);
+
+public:
+
+  static Cgdi* Instance(){static Cgdi instance; return &instance;}
+
+  void BlackPen(){}
+  void WhitePen(){}
+  void RedPen(){}
+  void GreenPen(){}
+  void BluePen(){}
+  void GreyPen(){}
+  void PinkPen(){}
+  void YellowPen(){}
+  void OrangePen(){}
+  void PurplePen(){}
+  void BrownPen(){}
+
+  void DarkGreenPen(){}
+  void LightBluePen(){}
+  void LightGreyPen(){}
+  void LightPinkPen(){}
+
+  void ThickBlackPen(){}
+  void ThickWhitePen(){}
+  void ThickRedPen(){}
+  void ThickGreenPen(){}
+  void ThickBluePen(){}
+
+  void BlackBrush(){}
+  void WhiteBrush(){}
+  void HollowBrush(){}
+  void GreenBrush(){}
+  void RedBrush(){}
+  void BlueBrush(){}
+  void GreyBrush(){}
+  void BrownBrush(){}
+  void YellowBrush(){}
+  void LightBlueBrush(){}
+  void DarkGreenBrush(){}
+  void OrangeBrush(){}
+
+  void TextAtPos(int, int, const std::string&){}
+  void TextAtPos(double, double, const std::string&){}
+  void TextAtPos(Vector2D, const std::string&){}
+  void TransparentText(){}
+  void OpaqueText(){}
+  void TextColor(int){}
+  void TextColor(int, int, int){}
+
+  void DrawDot(Vector2D, COLORREF){}
+  void DrawDot(int, int, COLORREF){}
+
+  void Line(Vector2D, Vector2D){}
+  void Line(int, int, int, int){}
+  void Line(double, double, double, double){}
+  void PolyLine(const std::vector<Vector2D>&){}
+  void LineWithArrow(Vector2D, Vector2D, double){}
+  void Cross(Vector2D, int){}
+
+  void Rect(int, int, int, int){}
+  void Rect(double, double, double, double){}
+  void ClosedShape(const std::vector<Vector2D>&){}
+  void Circle(Vector2D, double){}
+  void Circle(double, double, double){}
+  void Circle(int, int, double){}
+
+  void SetPenColor(int){}
+};
+
+#else
+
+#include <windows.h>
+
+
 //------------------------------- define some colors
 const int NumColors = 15;
 
@@ -387,4 +505,6 @@ public:
   }
 };
 
+#endif //RAVEN_HEADLESS
+
 #endif
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "misc/MappedFile.h"
+
+#include <cstdio>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+//----------------------------- ctor ------------------------------------------
+//-----------------------------------------------------------------------------
+MappedFile::MappedFile():m_pData(NULL),
+                         m_Size(0),
+                         m_hFile(NULL),
+                         m_hMapping(NULL)
+{}
+
+//------------------------------ dtor -----------------------------------------
+//-----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+#ifdef _WIN32
+
+//------------------------------- Open ----------------------------------------
+//-----------------------------------------------------------------------------
+bool MappedFile::Open(const std::string& FileName)
+{
+  Close();
+
+  HANDLE hFile = CreateFileA(FileName.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             NULL,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL);
+
+  if (hFile == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER size;
+
+  if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(hFile);
+    return false;
+  }
+
+  HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  if (hMapping == NULL)
+  {
+    CloseHandle(hFile);
+    return false;
+  }
+
+  const void* pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+  if (pData == NULL)
+  {
+    CloseHandle(hMapping);
+    CloseHandle(hFile);
+    return false;
+  }
+
+  m_hFile    = hFile;
+  m_hMapping = hMapping;
+  m_pData    = static_cast<const char*>(pData);
+  m_Size     = (std::size_t)size.QuadPart;
+
+  return true;
+}
+
+//------------------------------ Close ----------------------------------------
+//-----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+  if (m_pData)    UnmapViewOfFile(m_pData);
+  if (m_hMapping) CloseHandle(m_hMapping);
+  if (m_hFile)    CloseHandle(m_hFile);
+
+  m_pData    = NULL;
+  m_Size     = 0;
+  m_hMapping = NULL;
+  m_hFile    = NULL;
+}
+
+#else
+
+//------------------------------- Open ----------------------------------------
+//
+//  once the file is mapped the descriptor is no longer needed so m_hFile and
+//  m_hMapping are unused
+//-----------------------------------------------------------------------------
+bool MappedFile::Open(const std::string& FileName)
+{
+  Close();
+
+  int fd = open(FileName.c_str(), O_RDONLY);
+
+  if (fd < 0) return false;
+
+  struct stat info;
+
+  if (fstat(fd, &info) != 0 || info.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  void* pData = mmap(NULL, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  close(fd);
+
+  if (pData == MAP_FAILED) return false;
+
+  m_pData = static_cast<const char*>(pData);
+  m_Size  = (std::size_t)info.st_size;
+
+  return true;
+}
+
+//------------------------------ Close ----------------------------------------
+//-----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+  if (m_pData) munmap(const_cast<char*>(m_pData), m_Size);
+
+  m_pData = NULL;
+  m_Size  = 0;
+}
+
+#endif
+
+
+
+#ifdef _WIN32
+
+//--------------------------- TempFileNameFor ---------------------------------
+//-----------------------------------------------------------------------------
+std::string TempFileNameFor(const std::string& FileName)
+{
+  std::ostringstream name;
+
+  name << FileName << "." << (unsigned long)GetCurrentProcessId() << ".tmp";
+
+  return name.str();
+}
+
+//----------------------------- RenameOver ------------------------------------
+//
+//  rename won't replace an existing file on Windows
+//-----------------------------------------------------------------------------
+bool RenameOver(const std::string& From, const std::string& To)
+{
+  std::remove(To.c_str());
+
+  return std::rename(From.c_str(), To.c_str()) == 0;
+}
+
+#else
+
+//--------------------------- TempFileNameFor ---------------------------------
+//-----------------------------------------------------------------------------
+std::string TempFileNameFor(const std::string& FileName)
+{
+  std::ostringstream name;
+
+  name << FileName << "." << (unsigned long)getpid() << ".tmp";
+
+  return name.str();
+}
+
+//----------------------------- RenameOver ------------------------------------
+//
+//  rename replaces To in one step, so anyone opening To gets either the old
+//  file or the new one
+//-----------------------------------------------------------------------------
+bool RenameOver(const std::string& From, const std::string& To)
+{
+  return std::rename(From.c_str(), To.c_str()) == 0;
+}
+
+#endif
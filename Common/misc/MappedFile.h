@@ -0,0 +1,64 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+//-----------------------------------------------------------------------------
+//
+//  Name:   MappedFile.h
+//
+//  Desc:   maps the whole of a file into memory, read only. The operating
+//          system pages the contents in as they are touched so opening even
+//          a very large file is cheap.
+//-----------------------------------------------------------------------------
+#include <string>
+#include <cstddef>
+
+
+class MappedFile
+{
+private:
+
+  const char*  m_pData;
+  std::size_t  m_Size;
+
+  //the platform's handles to the file and the mapping. Stored as void* so
+  //this header doesn't need to include any system headers
+  void*        m_hFile;
+  void*        m_hMapping;
+
+  //copying a mapping makes no sense
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+public:
+
+  MappedFile();
+  ~MappedFile();
+
+  //maps the file. Returns false if the file can't be opened or mapped. An
+  //empty file can't be mapped
+  bool        Open(const std::string& FileName);
+
+  void        Close();
+
+  bool        isOpen()const{return m_pData != NULL;}
+
+  const char* Data()const{return m_pData;}
+  std::size_t Size()const{return m_Size;}
+};
+
+
+//a file that will be mapped is best written under another name and then
+//moved into place, so no one maps it half written. These help with that.
+
+//returns a name in the same directory as FileName for the file to be
+//written to. The name holds the process id, so two processes writing the
+//same file at once don't write to the same temporary file
+std::string TempFileNameFor(const std::string& FileName);
+
+//renames From to To, replacing To if it exists. The replacement is atomic
+//on POSIX systems. On Windows To is removed first, so for a moment there is
+//no file at all
+bool        RenameOver(const std::string& From, const std::string& To);
+
+
+
+#endif
@@ -361,6 +361,10 @@ public:
 
   bool empty()const{return (m_iSize==0);}
 
+  //empties the queue so it can be reused. Only the part of the heap in use
+  //is ever read so there is no need to touch the arrays
+  void clear(){m_iSize = 0;}
+
   //to insert an item into the queue it gets added to the end of the heap
   //and then the heap is reordered from the bottom up.
   void insert(const int idx)
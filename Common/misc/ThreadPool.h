@@ -0,0 +1,255 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+//-----------------------------------------------------------------------------
+//
+//  Name:   ThreadPool.h
+//
+//  Desc:   a fixed number of worker threads that run tasks taken from a
+//          shared queue.
+//
+//          ParallelFor is the easiest way to use it: it splits a range of
+//          indices among the workers and blocks until every index has been
+//          processed, optionally reporting progress on the calling thread
+//          while it waits.
+//
+//          The pool itself is thread safe but the tasks are responsible for
+//          synchronizing access to any data they share.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+
+class ThreadPool
+{
+public:
+
+  typedef std::function<void ()> Task;
+
+  //ParallelFor calls this with the number of indices processed so far and
+  //the total number to process
+  typedef void (*ProgressFunc)(int NumDone, int NumToDo);
+
+private:
+
+  std::vector<std::thread>  m_Workers;
+
+  //tasks waiting for a worker
+  std::deque<Task>          m_Tasks;
+
+  //the number of tasks currently being run by a worker
+  int                       m_iNumBusy;
+
+  bool                      m_bShuttingDown;
+
+  std::mutex                m_Mutex;
+
+  //signalled when a task is added or the pool is shutting down
+  std::condition_variable   m_TaskAdded;
+
+  //signalled when a worker finishes a task
+  std::condition_variable   m_TaskFinished;
+
+  //the body of each worker thread
+  void WorkerLoop();
+
+  //copying a pool makes no sense
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+
+public:
+
+  //if NumWorkers is zero or less one worker is created for each hardware
+  //thread
+  explicit ThreadPool(int NumWorkers);
+
+  //waits for any tasks that are running to finish. Tasks still waiting in
+  //the queue are discarded
+  ~ThreadPool();
+
+  void AddTask(const Task& task);
+
+  //blocks until the queue is empty and no task is being run
+  void WaitUntilIdle();
+
+  //calls f(i) for every i in the range [begin, end) and returns when all the
+  //calls have completed. f is called from the worker threads so it must be
+  //safe to call concurrently for different values of i
+  template <class Func>
+  void ParallelFor(int begin, int end, Func f, ProgressFunc ReportProgress = NULL);
+
+  int  NumWorkers()const{return (int)m_Workers.size();}
+};
+
+
+//----------------------------- ctor ------------------------------------------
+//-----------------------------------------------------------------------------
+inline ThreadPool::ThreadPool(int NumWorkers):m_iNumBusy(0),
+                                              m_bShuttingDown(false)
+{
+  if (NumWorkers <= 0)
+  {
+    NumWorkers = (int)std::thread::hardware_concurrency();
+  }
+
+  //hardware_concurrency returns zero if the number can't be determined
+  if (NumWorkers <= 0) NumWorkers = 1;
+
+  for (int w=0; w<NumWorkers; ++w)
+  {
+    m_Workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+  }
+}
+
+//------------------------------ dtor -----------------------------------------
+//-----------------------------------------------------------------------------
+inline ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_bShuttingDown = true;
+    m_Tasks.clear();
+  }
+
+  m_TaskAdded.notify_all();
+
+  for (unsigned int w=0; w<m_Workers.size(); ++w)
+  {
+    m_Workers[w].join();
+  }
+}
+
+//---------------------------- WorkerLoop -------------------------------------
+//-----------------------------------------------------------------------------
+inline void ThreadPool::WorkerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  while (true)
+  {
+    while (!m_bShuttingDown && m_Tasks.empty())
+    {
+      m_TaskAdded.wait(lock);
+    }
+
+    if (m_bShuttingDown) return;
+
+    Task task = m_Tasks.front();
+    m_Tasks.pop_front();
+
+    ++m_iNumBusy;
+
+    //run the task without holding the lock so the other workers can get on
+    lock.unlock();
+    task();
+    lock.lock();
+
+    --m_iNumBusy;
+
+    m_TaskFinished.notify_all();
+  }
+}
+
+//------------------------------ AddTask --------------------------------------
+//-----------------------------------------------------------------------------
+inline void ThreadPool::AddTask(const Task& task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Tasks.push_back(task);
+  }
+
+  m_TaskAdded.notify_one();
+}
+
+//---------------------------- WaitUntilIdle ----------------------------------
+//-----------------------------------------------------------------------------
+inline void ThreadPool::WaitUntilIdle()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  while (!m_Tasks.empty() || m_iNumBusy > 0)
+  {
+    m_TaskFinished.wait(lock);
+  }
+}
+
+//---------------------------- ParallelFor ------------------------------------
+//
+//  one task is added per worker. Each task repeatedly takes the next
+//  unprocessed index until there are none left, which balances the load
+//  when some indices take much longer than others
+//-----------------------------------------------------------------------------
+template <class Func>
+void ThreadPool::ParallelFor(int begin, int end, Func f, ProgressFunc ReportProgress)
+{
+  if (end <= begin) return;
+
+  const int NumToDo = end - begin;
+
+  std::atomic<int> next(begin);
+  std::atomic<int> NumDone(0);
+
+  //the number of tasks that have yet to finish. This is guarded by its own
+  //mutex so that waiting for it doesn't depend on any other tasks in the pool
+  int                     NumTasksRunning = NumToDo < NumWorkers() ? NumToDo : NumWorkers();
+  const int               NumTasks = NumTasksRunning;
+  std::mutex              mutex;
+  std::condition_variable finished;
+
+  for (int t=0; t<NumTasks; ++t)
+  {
+    AddTask([&]()
+    {
+      int i;
+      while ((i = next++) < end)
+      {
+        f(i);
+
+        ++NumDone;
+      }
+
+      //notify while holding the lock. Once it is released ParallelFor may
+      //return and destroy the condition variable
+      std::lock_guard<std::mutex> lock(mutex);
+
+      --NumTasksRunning;
+
+      finished.notify_all();
+    });
+  }
+
+  //wait for the tasks to finish, waking up regularly to report progress
+  const std::chrono::milliseconds ReportInterval(100);
+
+  int NumReported = -1;
+
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (NumTasksRunning > 0)
+  {
+    finished.wait_for(lock, ReportInterval);
+
+    if (ReportProgress && NumDone != NumReported && NumTasksRunning > 0)
+    {
+      NumReported = NumDone;
+
+      lock.unlock();
+      ReportProgress(NumReported, NumToDo);
+      lock.lock();
+    }
+  }
+
+  if (ReportProgress) ReportProgress(NumToDo, NumToDo);
+}
+
+
+
+#endif
@@ -1,6 +1,6 @@
 #include "misc/WindowUtils.h"
 #include <windows.h>
-#include "2d/Vector2D.h"
+#include "2D/Vector2D.h"
 #include "misc/utils.h"
 #include "misc/Stream_Utility_Functions.h"
 
@@ -60,12 +60,12 @@ bool CheckBufferLength(char* buff, int MaxLength, int& BufferLength)
   return true;
 }
 
-void ErrorBox(std::string& msg)
+void ErrorBox(const std::string& msg)
 {
   MessageBox(NULL, msg.c_str(), "Error", MB_OK);
 }
 
-void ErrorBox(char* msg)
+void ErrorBox(const char* msg)
 {
   MessageBox(NULL, msg, "Error", MB_OK);
 }
@@ -2,9 +2,28 @@
 #define WINDOW_UTILS_H
 #pragma warning (disable:4786)
 
-#include <windows.h>
 #include <string>
 
+#ifdef RAVEN_HEADLESS
+
+#include <iostream>
+#include "2D/Vector2D.h"
+
+//there is no keyboard, mouse or window in a headless build. Key queries
+//always fail and errors are written to stderr instead of a message box
+#define KEYDOWN(vk_code)         0
+#define WAS_KEY_PRESSED(vk_code) false
+#define IS_KEY_PRESSED(vk_code)  false
+
+inline void ErrorBox(const std::string& msg){std::cerr << "Error: " << msg << std::endl;}
+inline void ErrorBox(const char* msg){std::cerr << "Error: " << msg << std::endl;}
+
+inline Vector2D GetClientCursorPosition(){return Vector2D();}
+
+#else
+
+#include <windows.h>
+
 struct Vector2D;
 
 //macro to detect keypresses
@@ -41,8 +60,8 @@ void CheckMenuItemAppropriately(HWND hwnd, UINT MenuItem, bool b);
 //strings
 bool CheckBufferLength(char* buff, int MaxLength, unsigned int& BufferLength);
 
-void ErrorBox(std::string& msg);
-void ErrorBox(char* msg);
+void ErrorBox(const std::string& msg);
+void ErrorBox(const char* msg);
 
 //gets the coordinates of the cursor relative to an active window 
 Vector2D GetClientCursorPosition();
@@ -76,7 +95,6 @@ void ResizeWindow(HWND hwnd, int cx, int cy);
 int  GetWindowHeight(HWND hwnd);
 int  GetWindowWidth(HWND hwnd);
 
-
-
+#endif //RAVEN_HEADLESS
 
 #endif
\ No newline at end of file
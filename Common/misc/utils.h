@@ -276,7 +276,7 @@ inline double StandardDeviation(const std::vector<double>& v)
 template <class container>
 inline void DeleteSTLContainer(container& c)
 {
-  for (container::iterator it = c.begin(); it!=c.end(); ++it)
+  for (typename container::iterator it = c.begin(); it!=c.end(); ++it)
   {
     delete *it;
     *it = NULL;
@@ -286,7 +286,7 @@ inline void DeleteSTLContainer(container& c)
 template <class map>
 inline void DeleteSTLMap(map& m)
 {
-  for (map::iterator it = m.begin(); it!=m.end(); ++it)
+  for (typename map::iterator it = m.begin(); it!=m.end(); ++it)
   {
     delete it->second;
     it->second = NULL;
@@ -1,5 +1,5 @@
 #include "GraveMarkers.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 #include "2D/Transformations.h"
 
 //------------------------------- ctor ----------------------------------------
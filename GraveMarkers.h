@@ -12,8 +12,8 @@
 //-----------------------------------------------------------------------------
 #include <list>
 #include <vector>
-#include "2d/vector2d.h"
-#include "time/crudetimer.h"
+#include "2D/Vector2D.h"
+#include "Time/CrudeTimer.h"
 
 class GraveMarkers
 {
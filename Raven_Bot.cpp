@@ -3,13 +3,13 @@
 #include "misc/utils.h"
 #include "misc/Stream_Utility_Functions.h"
 #include "2D/Transformations.h"
-#include "2D/Geometry.h"
+#include "2D/geometry.h"
 #include "lua/Raven_Scriptor.h"
 #include "Raven_Game.h"
 #include "navigation/Raven_PathPlanner.h"
 #include "Raven_SteeringBehaviors.h"
 #include "Raven_UserOptions.h"
-#include "time/Regulator.h"
+#include "Time/Regulator.h"
 #include "Raven_WeaponSystem.h"
 #include "Raven_SensoryMemory.h"
 
@@ -47,6 +47,7 @@ Raven_Bot::Raven_Bot(Raven_Game* world,Vector2D pos):
                  m_iScore(0),
                  m_Status(spawning),
                  m_bPossessed(false),
+                 m_iSlot(0),
                  m_dFieldOfView(DegsToRads(script->GetDouble("Bot_FOV")))
            
 {
@@ -68,7 +69,6 @@ Raven_Bot::Raven_Bot(Raven_Game* world,Vector2D pos):
   m_pGoalArbitrationRegulator =  new Regulator(script->GetDouble("Bot_GoalAppraisalUpdateFreq"));
   m_pTargetSelectionRegulator = new Regulator(script->GetDouble("Bot_TargetingUpdateFreq"));
   m_pTriggerTestRegulator = new Regulator(script->GetDouble("Bot_TriggerUpdateFreq"));
-  m_pVisionUpdateRegulator = new Regulator(script->GetDouble("Bot_VisionUpdateFreq"));
 
   //create the goal queue
   m_pBrain = new Goal_Think(this);
@@ -98,7 +98,6 @@ Raven_Bot::~Raven_Bot()
   delete m_pGoalArbitrationRegulator;
   delete m_pTargetSelectionRegulator;
   delete m_pTriggerTestRegulator;
-  delete m_pVisionUpdateRegulator;
   delete m_pWeaponSys;
   delete m_pSensoryMem;
 }
@@ -145,11 +144,8 @@ void Raven_Bot::Update()
        m_pBrain->Arbitrate(); 
     }
 
-    //update the sensory memory with any visual stimulus
-    if (m_pVisionUpdateRegulator->isReady())
-    {
-      m_pSensoryMem->UpdateVision();
-    }
+    //note that the sensory memory is updated with any visual stimulus by
+    //the game's perception pass (see Raven_Game::UpdatePerception)
   
     //select the appropriate weapon to use from the weapons currently in
     //the inventory
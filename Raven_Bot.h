@@ -13,7 +13,7 @@
 #include <iosfwd>
 #include <map>
 
-#include "game/MovingEntity.h"
+#include "Game/MovingEntity.h"
 #include "misc/utils.h"
 #include "Raven_TargetingSystem.h"
 
@@ -72,7 +72,6 @@ private:
   Regulator*                         m_pGoalArbitrationRegulator;
   Regulator*                         m_pTargetSelectionRegulator;
   Regulator*                         m_pTriggerTestRegulator;
-  Regulator*                         m_pVisionUpdateRegulator;
 
   //the bot's health. Every time the bot is shot this value is decreased. If
   //it reaches zero then the bot dies (and respawns)
@@ -105,6 +104,11 @@ private:
   //set to true when a human player takes over control of the bot
   bool                               m_bPossessed;
 
+  //the bot's place in the tables other bots keep about it, such as their
+  //sensory memories. The game hands out the lowest slot not in use, so
+  //slots stay small enough to index arrays with
+  int                                m_iSlot;
+
   //a vertex buffer containing the bot's geometry
   std::vector<Vector2D>              m_vecBotVB;
   //the buffer for the transformed vertices
@@ -153,6 +157,10 @@ public:
   double        FieldOfView()const{return m_dFieldOfView;}
 
   bool          isPossessed()const{return m_bPossessed;}
+
+  int           Slot()const{return m_iSlot;}
+  void          SetSlot(int slot){m_iSlot = slot;}
+
   bool          isDead()const{return m_Status == dead;}
   bool          isAlive()const{return m_Status == alive;}
   bool          isSpawning()const{return m_Status == spawning;}
@@ -1,10 +1,10 @@
 #include "Raven_Door.h"
-#include "Messaging/telegram.h"
+#include "Messaging/Telegram.h"
 #include "misc/Stream_Utility_Functions.h"
 #include <algorithm>
 #include "Raven_Messages.h"
 #include "Raven_Map.h"
-#include "2d/wall2d.h"
+#include "2D/Wall2D.h"
 
 //---------------------------- ctor -------------------------------------------
 //-----------------------------------------------------------------------------
@@ -13,18 +13,45 @@ Raven_Door::Raven_Door(Raven_Map* pMap,
 
                                   BaseGameEntity(GetValueFromStream<int>(is)),
                                   m_Status(closed),
+                                  m_pMap(pMap),
                                   m_iNumTicksStayOpen(60)                   //MGC!
 {
   Read(is);
 
+  CreateGeometry();
+}
+
+//---------------------------- ctor -------------------------------------------
+//-----------------------------------------------------------------------------
+Raven_Door::Raven_Door(Raven_Map*                       pMap,
+                       int                              id,
+                       Vector2D                         P1,
+                       Vector2D                         P2,
+                       const std::vector<unsigned int>& switches):
+
+                                  BaseGameEntity(id),
+                                  m_Status(closed),
+                                  m_pMap(pMap),
+                                  m_Switches(switches),
+                                  m_iNumTicksStayOpen(60),                  //MGC!
+                                  m_vP1(P1),
+                                  m_vP2(P2)
+{
+  CreateGeometry();
+}
+
+//--------------------------- CreateGeometry ----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Door::CreateGeometry()
+{
   m_vtoP2Norm =  Vec2DNormalize(m_vP2 - m_vP1);
   m_dCurrentSize = m_dSize = Vec2DDistance(m_vP2, m_vP1);
 
   Vector2D perp = m_vtoP2Norm.Perp();
   
   //create the walls that make up the door's geometry
-  m_pWall1 = pMap->AddWall(m_vP1+perp, m_vP2+perp);
-  m_pWall2 = pMap->AddWall(m_vP2-perp, m_vP1-perp);
+  m_pWall1 = m_pMap->AddWall(m_vP1+perp, m_vP2+perp);
+  m_pWall2 = m_pMap->AddWall(m_vP2-perp, m_vP1-perp);
 }
 
 //---------------------------- dtor -------------------------------------------
@@ -51,7 +78,7 @@ void Raven_Door::Update()
     {
       if (m_iNumTicksCurrentlyOpen-- < 0)
       {
-        m_Status = closing;
+        SetStatus(closing);
       }
     }
   }
@@ -65,11 +92,22 @@ void Raven_Door::ChangePosition(Vector2D newP1, Vector2D newP2)
   m_vP1 = newP1;
   m_vP2 = newP2;
 
-  m_pWall1->SetFrom(m_vP1 + m_vtoP2Norm.Perp());
-  m_pWall1->SetTo(m_vP2 + m_vtoP2Norm.Perp());
+  //the walls are moved via the map so that its wall space partition is
+  //updated
+  m_pMap->MoveWall(m_pWall1, m_vP1 + m_vtoP2Norm.Perp(), m_vP2 + m_vtoP2Norm.Perp());
+  m_pMap->MoveWall(m_pWall2, m_vP2 - m_vtoP2Norm.Perp(), m_vP1 - m_vtoP2Norm.Perp());
+}
+
+//---------------------------- SetStatus --------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Door::SetStatus(door_status status)
+{
+  if (status != m_Status)
+  {
+    m_Status = status;
 
-  m_pWall2->SetFrom(m_vP2 - m_vtoP2Norm.Perp());
-  m_pWall2->SetTo(m_vP1 - m_vtoP2Norm.Perp());
+    m_pMap->DoorStateChanged();
+  }
 }
 
 //---------------------------- Open -------------------------------------------
@@ -79,7 +117,7 @@ void Raven_Door::Open()
   {
     if (m_dCurrentSize < 2)
     {
-      m_Status = open;
+      SetStatus(open);
 
       m_iNumTicksCurrentlyOpen = m_iNumTicksStayOpen;
 
@@ -105,7 +143,7 @@ void Raven_Door::Close()
   {
     if (m_dCurrentSize == m_dSize)
     {
-      m_Status = closed;
+      SetStatus(closed);
       return;
       
     }
@@ -170,7 +208,7 @@ bool Raven_Door::HandleMessage(const Telegram& msg)
   {
     if (m_Status != open)
     {
-      m_Status = opening;
+      SetStatus(opening);
     }
 
     return true;
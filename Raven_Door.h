@@ -13,8 +13,8 @@
 //-----------------------------------------------------------------------------
 #include <vector>
 #include <iosfwd>
-#include "2d/vector2d.h"
-#include "game/BaseGameEntity.h"
+#include "2D/Vector2D.h"
+#include "Game/BaseGameEntity.h"
 
 
 
@@ -33,6 +33,9 @@ protected:
 
   door_status                m_Status;
 
+  //the map the door is part of
+  Raven_Map*                 m_pMap;
+
   //a sliding door is created from two walls, back to back.These walls must
   //be added to a map's geometry in order for an agent to detect them
   Wall2D*                    m_pWall1;
@@ -62,12 +65,26 @@ protected:
 
   void  Open();
   void  Close();
+
+  //changes the status and lets the map know
+  void  SetStatus(door_status status);
   
   void ChangePosition(Vector2D newP1, Vector2D newP2);
+
+  //calculates the door's size and creates its walls once the hinge points
+  //are known
+  void CreateGeometry();
  
 public:
   
   Raven_Door(Raven_Map* pMap, std::ifstream& is);
+
+  //this ctor is used when loading a binary map
+  Raven_Door(Raven_Map*                       pMap,
+             int                              id,
+             Vector2D                         P1,
+             Vector2D                         P2,
+             const std::vector<unsigned int>& switches);
   ~Raven_Door();
 
   //the usual suspects
@@ -81,6 +98,11 @@ public:
   void AddSwitch(unsigned int id);
 
   std::vector<unsigned int> GetSwitchIDs()const{return m_Switches;}
+
+  //the ends of the door when it is closed. The door's walls always lie
+  //within one unit of the line between them
+  Vector2D  ClosedFrom()const{return m_vP1;}
+  Vector2D  ClosedTo()const{return m_vP1 + m_vtoP2Norm * m_dSize;}
 };
 
 
@@ -5,34 +5,75 @@
 #include "Raven_SteeringBehaviors.h"
 #include "lua/Raven_Scriptor.h"
 #include "navigation/Raven_PathPlanner.h"
-#include "game/EntityManager.h"
-#include "2d/WallIntersectionTests.h"
+#include "navigation/Raven_PathSmoother.h"
+#include "navigation/Raven_ClosestNodeRaster.h"
+#include "Game/EntityManager.h"
+#include "2D/WallIntersectionTests.h"
 #include "Raven_Map.h"
 #include "Raven_Door.h"
 #include "Raven_UserOptions.h"
-#include "Time/PrecisionTimer.h"
 #include "Raven_SensoryMemory.h"
 #include "Raven_WeaponSystem.h"
-#include "messaging/MessageDispatcher.h"
+#include "Messaging/MessageDispatcher.h"
 #include "Raven_Messages.h"
 #include "GraveMarkers.h"
+#include "Time/CrudeTimer.h"
+#include "misc/ThreadPool.h"
+#include "constants.h"
 
-#include "armory/Raven_Projectile.h"
-#include "armory/Projectile_Rocket.h"
-#include "armory/Projectile_Grenade.h"
-#include "armory/Projectile_Pellet.h"
-#include "armory/Projectile_Slug.h"
-#include "armory/Projectile_Bolt.h"
 
 #include "goals/Goal_Think.h"
 #include "goals/Raven_Goal_Types.h"
 
+#include <algorithm>
+
 
 
 //uncomment to write object creation/deletion to debug console
 //#define  LOG_CREATIONAL_STUFF
 
 
+//--------------------------- UpdateProjectiles -------------------------------
+//
+//  updates each projectile of one type. A dead projectile is removed by
+//  moving the last one into its place, which is then examined in turn.
+//  The call is qualified with the projectile's type so it is bound at
+//  compile time rather than through the vtable
+//-----------------------------------------------------------------------------
+template <class projectile_type>
+static void UpdateProjectiles(std::vector<projectile_type>& projectiles)
+{
+  unsigned int p = 0;
+
+  while (p < projectiles.size())
+  {
+    if (!projectiles[p].isDead())
+    {
+      projectiles[p].projectile_type::Update();
+
+      ++p;
+    }
+    else
+    {
+      projectiles[p] = projectiles.back();
+
+      projectiles.pop_back();
+    }
+  }
+}
+
+//--------------------------- RenderProjectiles -------------------------------
+//-----------------------------------------------------------------------------
+template <class projectile_type>
+static void RenderProjectiles(std::vector<projectile_type>& projectiles)
+{
+  for (unsigned int p=0; p<projectiles.size(); ++p)
+  {
+    projectiles[p].projectile_type::Render();
+  }
+}
+
+
 //----------------------------- ctor ------------------------------------------
 //-----------------------------------------------------------------------------
 Raven_Game::Raven_Game():m_pSelectedBot(NULL),
@@ -40,8 +81,33 @@ Raven_Game::Raven_Game():m_pSelectedBot(NULL),
                          m_bRemoveABot(false),
                          m_pMap(NULL),
                          m_pPathManager(NULL),
-                         m_pGraveMarkers(NULL)
+                         m_pGraveMarkers(NULL),
+                         m_pBotCellSpace(NULL),
+                         m_dLargestBotRadius(0.0),
+                         m_dViewDistance(script->GetDouble("Bot_ViewDistance")),
+                         m_iNumVisionPhases(1),
+                         m_iVisionPhase(0),
+                         m_dSoundRangeThroughWalls(script->GetDouble("SoundRangeThroughWalls"))
 {
+  //run the clock off a fixed timestep of one frame per update if required.
+  //A headless build has no wall clock so always does this
+#ifdef RAVEN_HEADLESS
+  Clock->SetFixedTimeStep(1.0 / FrameRate);
+#else
+  if (script->GetBool("FixedTimeStep"))
+  {
+    Clock->SetFixedTimeStep(1.0 / FrameRate);
+  }
+#endif
+
+  //each bot looks around once every m_iNumVisionPhases updates
+  const double VisionUpdateFreq = script->GetDouble("Bot_VisionUpdateFreq");
+
+  if (VisionUpdateFreq > 0)
+  {
+    m_iNumVisionPhases = std::max(1, (int)(FrameRate / VisionUpdateFreq + 0.5));
+  }
+
   //load in the default map
   LoadMap(script->GetString("StartMap"));
 }
@@ -56,6 +122,7 @@ Raven_Game::~Raven_Game()
   delete m_pMap;
   
   delete m_pGraveMarkers;
+  delete m_pBotCellSpace;
 }
 
 
@@ -81,20 +148,16 @@ void Raven_Game::Clear()
     delete *it;
   }
 
-  //delete any active projectiles
-  std::list<Raven_Projectile*>::iterator curW = m_Projectiles.begin();
-  for (curW; curW != m_Projectiles.end(); ++curW)
-  {
-#ifdef LOG_CREATIONAL_STUFF
-    debug_con << "deleting projectile id: " << (*curW)->ID() << "";
-#endif
-
-    delete *curW;
-  }
-
   //clear the containers
-  m_Projectiles.clear();
+  m_Bolts.clear();
+  m_Rockets.clear();
+  m_Grenades.clear();
+  m_Slugs.clear();
+  m_Pellets.clear();
   m_Bots.clear();
+  m_Sounds.clear();
+
+  if (m_pBotCellSpace) m_pBotCellSpace->EmptyCells();
 
   m_pSelectedBot = NULL;
 
@@ -110,12 +173,16 @@ void Raven_Game::Update()
   //don't update if the user has paused the game
   if (m_bPaused) return;
 
+  //send out any delayed telegrams that are now due
+  Dispatcher->DispatchDelayedMessages();
+
   m_pGraveMarkers->Update();
 
   //get any player keyboard input
   GetPlayerInput();
   
-  //update all the queued searches in the path manager
+  //update all the queued searches in the path manager. If the searches are
+  //run on worker threads this is where the bots hear of any that finished
   m_pPathManager->UpdateSearches();
 
   //update any doors
@@ -125,25 +192,20 @@ void Raven_Game::Update()
     (*curDoor)->Update();
   }
 
-  //update any current projectiles
-  std::list<Raven_Projectile*>::iterator curW = m_Projectiles.begin();
-  while (curW != m_Projectiles.end())
-  {
-    //test for any dead projectiles and remove them if necessary
-    if (!(*curW)->isDead())
-    {
-      (*curW)->Update();
-
-      ++curW;
-    }
-    else
-    {    
-      delete *curW;
+  //partition the bots at their current positions. The projectiles and the
+  //perception pass both use the partition to find the bots near them
+  PartitionBots();
 
-      curW = m_Projectiles.erase(curW);
-    }   
-  }
+  //update any current projectiles, removing any dead ones
+  UpdateProjectiles(m_Bolts);
+  UpdateProjectiles(m_Rockets);
+  UpdateProjectiles(m_Grenades);
+  UpdateProjectiles(m_Slugs);
+  UpdateProjectiles(m_Pellets);
   
+  //update the bots' vision
+  UpdatePerception();
+
   //update the bots
   bool bSpawnPossible = true;
   
@@ -187,16 +249,149 @@ void Raven_Game::Update()
       Raven_Bot* pBot = m_Bots.back();
       if (pBot == m_pSelectedBot)m_pSelectedBot=0;
       NotifyAllBotsOfRemoval(pBot);
+
+      //forget any sounds it made that haven't been heard yet
+      for (unsigned int s=0; s<m_Sounds.size();)
+      {
+        if (m_Sounds[s].pSource == pBot) m_Sounds.erase(m_Sounds.begin() + s);
+        else ++s;
+      }
+
       delete m_Bots.back();
       m_Bots.remove(pBot);
       pBot = 0;
+
+      //make sure the cell space doesn't hold on to the deleted bot
+      PartitionBots();
     }
 
     m_bRemoveABot = false;
   }
+
+  //one update step has elapsed. If the clock is running off a fixed
+  //timestep this moves it on
+  Clock->Tick();
 }
 
 
+//------------------------------ PartitionBots --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Game::PartitionBots()
+{
+  m_pBotCellSpace->EmptyCells();
+
+  m_dLargestBotRadius = 0.0;
+
+  std::list<Raven_Bot*>::const_iterator curBot = m_Bots.begin();
+  for (curBot; curBot != m_Bots.end(); ++curBot)
+  {
+    m_pBotCellSpace->AddEntity(*curBot);
+
+    m_dLargestBotRadius = std::max(m_dLargestBotRadius, (*curBot)->BRadius());
+  }
+}
+
+//---------------------------- PropagateSounds --------------------------------
+//
+//  the cell space is used to find the bots within range of each sound. A bot
+//  on the other side of a wall from a sound only hears it if it is within
+//  m_dSoundRangeThroughWalls of its range, so the line of sight test is only
+//  made for bots beyond that
+//-----------------------------------------------------------------------------
+void Raven_Game::PropagateSounds()
+{
+  for (unsigned int s=0; s<m_Sounds.size(); ++s)
+  {
+    const Sound& sound = m_Sounds[s];
+
+    //a bot is in range if its bounding circle overlaps the sound's circle,
+    //so the query is widened by the radius of the largest listener
+    m_pBotCellSpace->CalculateNeighbors(sound.vPos,
+                                        sound.dRange + m_dLargestBotRadius);
+
+    for (Raven_Bot* pBot = m_pBotCellSpace->begin();
+         !m_pBotCellSpace->end();
+         pBot = m_pBotCellSpace->next())
+    {
+      if (!pBot->isAlive() || pBot == sound.pSource) continue;
+
+      const double Range = sound.dRange + pBot->BRadius();
+
+      if (Vec2DDistanceSq(sound.vPos, pBot->Pos()) >= Range*Range) continue;
+
+      const double RangeThroughWalls = sound.dRange * m_dSoundRangeThroughWalls +
+                                       pBot->BRadius();
+
+      if (Vec2DDistanceSq(sound.vPos, pBot->Pos()) >= RangeThroughWalls*RangeThroughWalls &&
+          !isLOSOkay(sound.vPos, pBot->Pos()))
+      {
+        continue;
+      }
+
+      pBot->GetSensoryMem()->UpdateWithSoundSource(sound.pSource);
+    }
+  }
+
+  m_Sounds.clear();
+}
+
+//---------------------------- UpdatePerception -------------------------------
+//
+//  the sounds made since the last update are heard. Then the bots whose turn
+//  it is look around: the cell space is used to find the opponents within
+//  view range of each. The bots take turns by slot, so with many bots the
+//  cost of the line of sight tests is spread evenly over the updates rather
+//  than landing on one of them.
+//
+//  A pair of bots that are both due is examined only once: the line of sight
+//  test is made and the result is used to update the sensory memory of both
+//  bots (providing they are alive and under AI control). An opponent that
+//  isn't due is tested for the looking bot alone and sees for itself on its
+//  own turn
+//-----------------------------------------------------------------------------
+void Raven_Game::UpdatePerception()
+{
+  PropagateSounds();
+
+  const int phase = m_iVisionPhase;
+
+  m_iVisionPhase = (m_iVisionPhase + 1) % m_iNumVisionPhases;
+
+  std::list<Raven_Bot*>::const_iterator curBot = m_Bots.begin();
+  for (curBot; curBot != m_Bots.end(); ++curBot)
+  {
+    Raven_Bot* pBot = *curBot;
+
+    if (pBot->Slot() % m_iNumVisionPhases != phase) continue;
+
+    bool bBotSees = pBot->isAlive() && !pBot->isPossessed();
+
+    m_pBotCellSpace->CalculateNeighbors(pBot->Pos(), m_dViewDistance);
+
+    for (Raven_Bot* pOpp = m_pBotCellSpace->begin();
+         !m_pBotCellSpace->end();
+         pOpp = m_pBotCellSpace->next())
+    {
+      const bool bOppDue = pOpp->Slot() % m_iNumVisionPhases == phase;
+
+      //a pair of bots that are both due is visited from the bot with the
+      //lowest ID. (this also makes sure a bot is not tested against itself)
+      if (bOppDue && pOpp->ID() <= pBot->ID()) continue;
+
+      bool bOppSees = bOppDue && pOpp->isAlive() && !pOpp->isPossessed();
+
+      if (!bBotSees && !bOppSees) continue;
+
+      bool bLOSOkay = isLOSOkay(pBot->Pos(), pOpp->Pos());
+
+      if (bBotSees) pBot->GetSensoryMem()->UpdateVisionOfOpponent(pOpp, bLOSOkay);
+      if (bOppSees) pOpp->GetSensoryMem()->UpdateVisionOfOpponent(pBot, bLOSOkay);
+    }
+
+    if (bBotSees) pBot->GetSensoryMem()->UpdateOpponentsOutOfView(m_dViewDistance);
+  }
+}
+
 //----------------------------- AttemptToAddBot -------------------------------
 //-----------------------------------------------------------------------------
 bool Raven_Game::AttemptToAddBot(Raven_Bot* pBot)
@@ -257,6 +452,17 @@ void Raven_Game::AddBots(unsigned int NumBotsToAdd)
     rb->GetSteering()->WallAvoidanceOn();
     rb->GetSteering()->SeparationOn();
 
+    //give it the lowest slot not taken by another bot
+    std::vector<bool> SlotTaken(m_Bots.size(), false);
+
+    std::list<Raven_Bot*>::const_iterator curBot = m_Bots.begin();
+    for (curBot; curBot != m_Bots.end(); ++curBot)
+    {
+      if ((*curBot)->Slot() < (int)SlotTaken.size()) SlotTaken[(*curBot)->Slot()] = true;
+    }
+
+    rb->SetSlot(std::find(SlotTaken.begin(), SlotTaken.end(), false) - SlotTaken.begin());
+
     m_Bots.push_back(rb);
 
     //register the bot with the entity manager
@@ -297,64 +503,67 @@ void Raven_Game::RemoveBot()
   m_bRemoveABot = true;
 }
 
+//---------------------------- AddSound ---------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Game::AddSound(Raven_Bot* pSource, double range)
+{
+  Sound sound;
+
+  sound.pSource = pSource;
+  sound.vPos    = pSource->Pos();
+  sound.dRange  = range;
+
+  m_Sounds.push_back(sound);
+}
+
 //--------------------------- AddBolt -----------------------------------------
 //-----------------------------------------------------------------------------
 void Raven_Game::AddBolt(Raven_Bot* shooter, Vector2D target)
 {
-  Raven_Projectile* rp = new Bolt(shooter, target);
-
-  m_Projectiles.push_back(rp);
+  m_Bolts.push_back(Bolt(shooter, target));
   
   #ifdef LOG_CREATIONAL_STUFF
-  debug_con << "Adding a bolt " << rp->ID() << " at pos " << rp->Pos() << "";
+  debug_con << "Adding a bolt " << m_Bolts.back().ID() << " at pos " << m_Bolts.back().Pos() << "";
   #endif
 }
 
 //------------------------------ AddRocket --------------------------------
 void Raven_Game::AddRocket(Raven_Bot* shooter, Vector2D target)
 {
-  Raven_Projectile* rp = new Rocket(shooter, target);
-
-  m_Projectiles.push_back(rp);
+  m_Rockets.push_back(Rocket(shooter, target));
   
   #ifdef LOG_CREATIONAL_STUFF
-  debug_con << "Adding a rocket " << rp->ID() << " at pos " << rp->Pos() << "";
+  debug_con << "Adding a rocket " << m_Rockets.back().ID() << " at pos " << m_Rockets.back().Pos() << "";
   #endif
 }
 
 //------------------------------ AddGrenade --------------------------------
 void Raven_Game::AddGrenade(Raven_Bot* shooter, Vector2D target)
 {
-	Raven_Projectile* rp = new Grenade(shooter, target);
-
-	m_Projectiles.push_back(rp);
+	m_Grenades.push_back(Grenade(shooter, target));
 
 	#ifdef LOG_CREATIONAL_STUFF
-	debug_con << "Adding a grenade " << rp->ID() << " at pos " << rp->Pos() << "";
+	debug_con << "Adding a grenade " << m_Grenades.back().ID() << " at pos " << m_Grenades.back().Pos() << "";
 	#endif
 }
 
 //------------------------- AddRailGunSlug -----------------------------------
 void Raven_Game::AddRailGunSlug(Raven_Bot* shooter, Vector2D target)
 {
-  Raven_Projectile* rp = new Slug(shooter, target);
-
-  m_Projectiles.push_back(rp);
+  m_Slugs.push_back(Slug(shooter, target));
   
   #ifdef LOG_CREATIONAL_STUFF
-  debug_con << "Adding a rail gun slug" << rp->ID() << " at pos " << rp->Pos() << "";
+  debug_con << "Adding a rail gun slug" << m_Slugs.back().ID() << " at pos " << m_Slugs.back().Pos() << "";
 #endif
 }
 
 //------------------------- AddShotGunPellet -----------------------------------
 void Raven_Game::AddShotGunPellet(Raven_Bot* shooter, Vector2D target)
 {
-  Raven_Projectile* rp = new Pellet(shooter, target);
-
-  m_Projectiles.push_back(rp);
+  m_Pellets.push_back(Pellet(shooter, target));
   
   #ifdef LOG_CREATIONAL_STUFF
-  debug_con << "Adding a shotgun shell " << rp->ID() << " at pos " << rp->Pos() << "";
+  debug_con << "Adding a shotgun shell " << m_Pellets.back().ID() << " at pos " << m_Pellets.back().Pos() << "";
 #endif
 }
 
@@ -399,7 +608,11 @@ bool Raven_Game::LoadMap(const std::string& filename)
 
   //in with the new
   m_pGraveMarkers = new GraveMarkers(script->GetDouble("GraveLifetime"));
-  m_pPathManager = new PathManager<Raven_PathPlanner>(script->GetInt("MaxSearchCyclesPerUpdateStep"));
+  m_pPathManager = new PathManager<Raven_PathPlanner>(script->GetInt("MaxSearchCyclesPerUpdateStep"),
+                                                      script->GetInt("NumPathSearchThreads"));
+  m_pPathManager->SetDeadline(search_priority_low,    script->GetInt("PathSearchDeadline_Low"));
+  m_pPathManager->SetDeadline(search_priority_normal, script->GetInt("PathSearchDeadline_Normal"));
+  m_pPathManager->SetDeadline(search_priority_high,   script->GetInt("PathSearchDeadline_High"));
   m_pMap = new Raven_Map();
 
   //make sure the entity manager is reset
@@ -409,7 +622,27 @@ bool Raven_Game::LoadMap(const std::string& filename)
   //load the new map data
   if (m_pMap->LoadMap(filename))
   { 
+    //partition the new map area ready for the bots
+    delete m_pBotCellSpace;
+    m_pBotCellSpace = new BotCellSpace(m_pMap->GetSizeX(),
+                                       m_pMap->GetSizeY(),
+                                       script->GetInt("NumCellsX"),
+                                       script->GetInt("NumCellsY"),
+                                       script->GetInt("NumBots"));
+
     AddBots(script->GetInt("NumBots"));
+
+    //now the walls and doors are in place, work out the closest node to
+    //each part of the map and which shortcuts between navgraph nodes the
+    //bots can take. The shortcuts' nodes are shared out between the cores
+    if (!m_Bots.empty())
+    {
+      m_pMap->GetClosestNodeRaster()->Create(m_Bots.front()->BRadius());
+
+      ThreadPool pool(script->GetInt("NumPrecalcThreads"));
+
+      m_pMap->GetPathSmoother()->CreateTable(m_Bots.front(), pool);
+    }
   
     return true;
   }
@@ -428,6 +661,7 @@ void Raven_Game::ExorciseAnyPossessedBot()
 }
 
 
+#ifndef RAVEN_HEADLESS
 //-------------------------- ClickRightMouseButton -----------------------------
 //
 //  this method is called when the user clicks the right mouse button.
@@ -494,6 +728,7 @@ void Raven_Game::ClickLeftMouseButton(POINTS p)
     m_pSelectedBot->FireWeapon(POINTStoVector(p));
   }
 }
+#endif
 
 //------------------------ GetPlayerInput -------------------------------------
 //
@@ -550,7 +785,7 @@ void Raven_Game::ChangeWeaponOfPossessedBot(unsigned int weapon)const
 //------------------------------------------------------------------------------
 bool Raven_Game::isLOSOkay(Vector2D A, Vector2D B)const
 {
-  return !doWallsObstructLineSegment(A, B, m_pMap->GetWalls());
+  return !doWallsObstructLineSegment(A, B, m_pMap->GetWallSpace());
 }
 
 //------------------------- isPathObstructed ----------------------------------
@@ -574,7 +809,7 @@ bool Raven_Game::isPathObstructed(Vector2D A,
     curPos += ToB * 0.5 * BoundingRadius;
     
     //test all walls against the new position
-    if (doWallsIntersectCircle(m_pMap->GetWalls(), curPos, BoundingRadius))
+    if (doWallsIntersectCircle(m_pMap->GetWallSpace(), curPos, BoundingRadius))
     {
       return true;
     }
@@ -593,26 +828,30 @@ Raven_Game::GetAllBotsInFOV(const Raven_Bot* pBot)const
 {
   std::vector<Raven_Bot*> VisibleBots;
 
-  std::list<Raven_Bot*>::const_iterator curBot = m_Bots.begin();
-  for (curBot; curBot != m_Bots.end(); ++curBot)
+  //only the bots within view range need be examined
+  m_pBotCellSpace->CalculateNeighbors(pBot->Pos(), m_dViewDistance);
+
+  for (Raven_Bot* pOther = m_pBotCellSpace->begin();
+       !m_pBotCellSpace->end();
+       pOther = m_pBotCellSpace->next())
   {
     //make sure time is not wasted checking against the same bot or against a
     // bot that is dead or re-spawning
-    if (*curBot == pBot ||  !(*curBot)->isAlive()) continue;
+    if (pOther == pBot ||  !pOther->isAlive()) continue;
 
     //first of all test to see if this bot is within the FOV
     if (isSecondInFOVOfFirst(pBot->Pos(),
                              pBot->Facing(),
-                             (*curBot)->Pos(),
+                             pOther->Pos(),
                              pBot->FieldOfView()))
     {
       //cast a ray from between the bots to test visibility. If the bot is
       //visible add it to the vector
       if (!doWallsObstructLineSegment(pBot->Pos(),
-                              (*curBot)->Pos(),
-                              m_pMap->GetWalls()))
+                              pOther->Pos(),
+                              m_pMap->GetWallSpace()))
       {
-        VisibleBots.push_back(*curBot);
+        VisibleBots.push_back(pOther);
       }
     }
   }
@@ -629,8 +868,10 @@ Raven_Game::isSecondVisibleToFirst(const Raven_Bot* pFirst,
   //if the two bots are equal or if one of them is not alive return false
   if ( !(pFirst == pSecond) && pSecond->isAlive())
   {
-    //first of all test to see if this bot is within the FOV
-    if (isSecondInFOVOfFirst(pFirst->Pos(),
+    //first of all test to see if this bot is within view range and the FOV
+    if (Vec2DDistanceSq(pFirst->Pos(), pSecond->Pos()) <
+          m_dViewDistance*m_dViewDistance                &&
+        isSecondInFOVOfFirst(pFirst->Pos(),
                              pFirst->Facing(),
                              pSecond->Pos(),
                              pFirst->FieldOfView()))
@@ -639,7 +880,7 @@ Raven_Game::isSecondVisibleToFirst(const Raven_Bot* pFirst,
       //If the bot is visible add it to the vector
       if (!doWallsObstructLineSegment(pFirst->Pos(),
                                       pSecond->Pos(),
-                                      m_pMap->GetWalls()))
+                                      m_pMap->GetWallSpace()))
       {
         return true;
       }
@@ -735,11 +976,11 @@ void Raven_Game::Render()
   }
   
   //render any projectiles
-  std::list<Raven_Projectile*>::const_iterator curW = m_Projectiles.begin();
-  for (curW; curW != m_Projectiles.end(); ++curW)
-  {
-    (*curW)->Render();
-  }
+  RenderProjectiles(m_Bolts);
+  RenderProjectiles(m_Rockets);
+  RenderProjectiles(m_Grenades);
+  RenderProjectiles(m_Slugs);
+  RenderProjectiles(m_Pellets);
 
  // gdi->TextAtPos(300, WindowHeight - 70, "Num Current Searches: " + ttos(m_pPathManager->GetNumActiveSearches()));
 
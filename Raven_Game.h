@@ -18,17 +18,22 @@
 #include <string>
 #include <list>
 
-#include "graph/SparseGraph.h"
+#include "Graph/SparseGraph.h"
 #include "Raven_ObjectEnumerations.h"
-#include "2d/Wall2D.h"
+#include "2D/Wall2D.h"
 #include "misc/utils.h"
-#include "game/EntityFunctionTemplates.h"
+#include "Game/EntityFunctionTemplates.h"
 #include "Raven_Bot.h"
-#include "navigation/pathmanager.h"
+#include "navigation/PathManager.h"
+#include "misc/CellSpacePartition.h"
+#include "armory/Projectile_Bolt.h"
+#include "armory/Projectile_Rocket.h"
+#include "armory/Projectile_Grenade.h"
+#include "armory/Projectile_Slug.h"
+#include "armory/Projectile_Pellet.h"
 
 
 class BaseGameEntity;
-class Raven_Projectile;
 class Raven_Map;
 class GraveMarkers;
 
@@ -36,6 +41,10 @@ class GraveMarkers;
 
 class Raven_Game
 {
+public:
+
+  typedef CellSpacePartition<Raven_Bot*>    BotCellSpace;
+
 private:
 
   //the current game map
@@ -48,9 +57,15 @@ private:
   //bot
   Raven_Bot*                       m_pSelectedBot;
   
-  //this list contains any active projectiles (slugs, rockets,
-  //shotgun pellets, etc)
-  std::list<Raven_Projectile*>     m_Projectiles;
+  //the active projectiles (slugs, rockets, shotgun pellets, etc). Each type
+  //is kept by value in an array of its own, so firing a weapon seldom
+  //allocates and each type is updated in a loop of its own. A dead
+  //projectile is removed by moving the last one of its type into its place
+  std::vector<Bolt>                m_Bolts;
+  std::vector<Rocket>              m_Rockets;
+  std::vector<Grenade>             m_Grenades;
+  std::vector<Slug>                m_Slugs;
+  std::vector<Pellet>              m_Pellets;
 
   //this class manages all the path planning requests
   PathManager<Raven_PathPlanner>*  m_pPathManager;
@@ -66,6 +81,52 @@ private:
   //class manages the graves
   GraveMarkers*                    m_pGraveMarkers;
 
+  //the bots are partitioned into this grid at the start of each update so
+  //that proximity queries only have to examine the bots in nearby cells
+  BotCellSpace*                    m_pBotCellSpace;
+
+  //the bounding radius of the largest bot in the grid. A query for the bots
+  //overlapping a region must reach this far beyond it
+  double                           m_dLargestBotRadius;
+
+  //bots cannot see opponents further away than this
+  double                           m_dViewDistance;
+
+  //the bots take turns to update their vision so the work is spread over
+  //the updates. Each update the bots whose slot falls in the current phase
+  //look around, so each does so Bot_VisionUpdateFreq times a second
+  int                              m_iNumVisionPhases;
+  int                              m_iVisionPhase;
+
+  //a sound made by a bot, such as a weapon firing, waiting to be heard
+  struct Sound
+  {
+    Raven_Bot*  pSource;
+    Vector2D    vPos;
+    double      dRange;
+  };
+
+  //the sounds made since the perception pass last ran
+  std::vector<Sound>               m_Sounds;
+
+  //the fraction of its range a sound carries to bots on the other side of
+  //a wall
+  double                           m_dSoundRangeThroughWalls;
+
+  //empties the bot cell space and adds all the bots at their current
+  //positions
+  void  PartitionBots();
+
+  //the perception pass. Lets the bots hear the sounds made since it last
+  //ran, then updates the vision of the AI controlled bots whose turn it is,
+  //examining only the opponents within view range. When both bots of a pair
+  //are due the line of sight test between them is made once and shared
+  void  UpdatePerception();
+
+  //lets every living bot within range of each sound hear it, then empties
+  //the queue of sounds
+  void  PropagateSounds();
+
   //this iterates through each trigger, testing each one against each bot
   void  UpdateTriggers();
 
@@ -100,6 +161,10 @@ public:
   void AddShotGunPellet(Raven_Bot* shooter, Vector2D target);
   void AddBolt(Raven_Bot* shooter, Vector2D target);
 
+  //queues a sound made by a bot, such as a weapon firing, to be heard by the
+  //bots within range at the next perception pass
+  void AddSound(Raven_Bot* pSource, double range);
+
   //removes the last bot to be added
   void RemoveBot();
 
@@ -135,6 +200,7 @@ public:
 
   void        TogglePause(){m_bPaused = !m_bPaused;}
   
+#ifndef RAVEN_HEADLESS
   //this method is called when the user clicks the right mouse button.
   //The method checks to see if a bot is beneath the cursor. If so, the bot
   //is recorded as selected.If the cursor is not over a bot then any selected
@@ -144,6 +210,7 @@ public:
   //this method is called when the user clicks the left mouse button. If there
   //is a possessed bot, this fires the weapon, else does nothing
   void        ClickLeftMouseButton(POINTS p);
+#endif
 
   //when called will release any possessed bot from user control
   void        ExorciseAnyPossessedBot();
@@ -159,6 +226,9 @@ public:
   Raven_Map* const                         GetMap(){return m_pMap;}
   const std::list<Raven_Bot*>&             GetAllBots()const{return m_Bots;}
   PathManager<Raven_PathPlanner>* const    GetPathManager(){return m_pPathManager;}
+  BotCellSpace* const                      GetBotCellSpace()const{return m_pBotCellSpace;}
+  double                                   GetLargestBotRadius()const{return m_dLargestBotRadius;}
+  double                                   GetViewDistance()const{return m_dViewDistance;}
   int                                      GetNumBots()const{return m_Bots.size();}
 
   
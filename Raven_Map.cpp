@@ -1,29 +1,56 @@
 #include "Raven_Map.h"
 #include "Raven_ObjectEnumerations.h"
 #include "misc/Cgdi.h"
+#include "misc/WindowUtils.h"
 #include "Graph/HandyGraphFunctions.h"
+#include "Graph/GraphCostOracles.h"
 #include "Raven_Door.h"
-#include "game/EntityManager.h"
+#include "Raven_MapFile.h"
+#include "navigation/Raven_PathCache.h"
+#include "navigation/Raven_ItemFlowFields.h"
+#include "navigation/Raven_ClosestNodeRaster.h"
+#include "navigation/Raven_PathSmoother.h"
+#include "Game/EntityManager.h"
 #include "constants.h"
 #include "lua/Raven_Scriptor.h"
 
 #include "triggers/Trigger_HealthGiver.h"
 #include "triggers/Trigger_WeaponGiver.h"
 #include "triggers/Trigger_OnButtonSendMsg.h"
-#include "triggers/Trigger_SoundNotify.h"
 
 #include "Raven_UserOptions.h"
 
 
 //uncomment to write object creation/deletion to debug console
 #define  LOG_CREATIONAL_STUFF
-#include "debug/DebugConsole.h"
+#include "Debug/DebugConsole.h"
 
 
+//------------------------ ReportCostTableProgress ----------------------------
+//
+//  writes the progress of the cost table calculation to the debug console
+//-----------------------------------------------------------------------------
+static void ReportCostTableProgress(int NumDone, int NumToDo)
+{
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Calculating path costs... " << NumDone << "/" << NumToDo << "";
+#endif
+}
+
 //----------------------------- ctor ------------------------------------------
 //-----------------------------------------------------------------------------
-Raven_Map::Raven_Map():m_pNavGraph(NULL),
+Raven_Map::Raven_Map():m_pWallSpace(NULL),
+                       m_pNavGraph(NULL),
+                       m_pCompactNavGraph(NULL),
+                       m_pHierarchicalNavGraph(NULL),
+                       m_pNavGridLayout(NULL),
                        m_pSpacePartition(NULL),
+                       m_pCostOracle(NULL),
+                       m_pPathCache(NULL),
+                       m_pItemFlowFields(NULL),
+                       m_pClosestNodeRaster(NULL),
+                       m_pPathSmoother(NULL),
+                       m_iNumDoorStateChanges(0),
                        m_iSizeY(0),
                        m_iSizeX(0),
                        m_dCellSpaceNeighborhoodRange(0)
@@ -63,8 +90,35 @@ void Raven_Map::Clear()
 
   m_Walls.clear();
   m_SpawnPoints.clear();
+
+  delete m_pWallSpace;
+  m_pWallSpace = NULL;
   
-  //delete the navgraph
+  //delete the cost oracle and the navgraph views it refers to
+  delete m_pCostOracle;
+  m_pCostOracle = NULL;
+
+  delete m_pPathCache;
+  m_pPathCache = NULL;
+
+  delete m_pItemFlowFields;
+  m_pItemFlowFields = NULL;
+
+  delete m_pClosestNodeRaster;
+  m_pClosestNodeRaster = NULL;
+
+  delete m_pPathSmoother;
+  m_pPathSmoother = NULL;
+
+  delete m_pHierarchicalNavGraph;
+  m_pHierarchicalNavGraph = NULL;
+
+  delete m_pNavGridLayout;
+  m_pNavGridLayout = NULL;
+
+  delete m_pCompactNavGraph;
+  m_pCompactNavGraph = NULL;
+
   delete m_pNavGraph;   
 
   //delete the partioning info
@@ -76,7 +130,14 @@ void Raven_Map::Clear()
 //-----------------------------------------------------------------------------
 void Raven_Map::AddWall(std::ifstream& in)
 {
-  m_Walls.push_back(new Wall2D(in));
+  AddWall(new Wall2D(in));
+}
+
+void Raven_Map::AddWall(Wall2D* pWall)
+{
+  m_Walls.push_back(pWall);
+
+  m_pWallSpace->AddWall(pWall);
 }
 
 Wall2D* Raven_Map::AddWall(Vector2D from, Vector2D to)
@@ -85,15 +146,27 @@ Wall2D* Raven_Map::AddWall(Vector2D from, Vector2D to)
 
   m_Walls.push_back(w);
 
+  m_pWallSpace->AddWall(w);
+
   return w;
 }
 
+//----------------------------- MoveWall --------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Map::MoveWall(Wall2D* pWall, Vector2D from, Vector2D to)
+{
+  m_pWallSpace->MoveWall(pWall, from, to);
+}
+
 //--------------------------- AddDoor -----------------------------------------
 //-----------------------------------------------------------------------------
 void Raven_Map::AddDoor(std::ifstream& in)
 {
-  Raven_Door* pDoor = new Raven_Door(this, in);
+  AddDoor(new Raven_Door(this, in));
+}
 
+void Raven_Map::AddDoor(Raven_Door* pDoor)
+{
   m_Doors.push_back(pDoor);
 
   //register the entity 
@@ -104,13 +177,15 @@ void Raven_Map::AddDoor(std::ifstream& in)
 //-----------------------------------------------------------------------------
 void Raven_Map::AddDoorTrigger(std::ifstream& in)
 {
-  Trigger_OnButtonSendMsg<Raven_Bot>* tr = new Trigger_OnButtonSendMsg<Raven_Bot>(in);
+  AddDoorTrigger(new Trigger_OnButtonSendMsg<Raven_Bot>(in));
+}
 
-  m_TriggerSystem.Register(tr);
+void Raven_Map::AddDoorTrigger(TriggerType* pTrigger)
+{
+  m_TriggerSystem.Register(pTrigger);
 
   //register the entity 
-  EntityMgr->RegisterEntity(tr);
-  
+  EntityMgr->RegisterEntity(pTrigger);
 }
 
 
@@ -130,8 +205,11 @@ void Raven_Map::AddSpawnPoint(std::ifstream& in)
 //-----------------------------------------------------------------------------
 void Raven_Map::AddHealth_Giver(std::ifstream& in)
 {
-  Trigger_HealthGiver* hg = new Trigger_HealthGiver(in);
+  AddHealth_Giver(new Trigger_HealthGiver(in));
+}
 
+void Raven_Map::AddHealth_Giver(Trigger_HealthGiver* hg)
+{
   m_TriggerSystem.Register(hg);
 
   //let the corresponding navgraph node point to this object
@@ -151,6 +229,11 @@ void Raven_Map::AddWeapon_Giver(int type_of_weapon, std::ifstream& in)
 
   wg->SetEntityType(type_of_weapon);
 
+  AddWeapon_Giver(wg);
+}
+
+void Raven_Map::AddWeapon_Giver(Trigger_WeaponGiver* wg)
+{
   //add it to the appropriate vectors
   m_TriggerSystem.Register(wg);
 
@@ -170,6 +253,21 @@ void Raven_Map::AddWeapon_Giver(int type_of_weapon, std::ifstream& in)
 //-----------------------------------------------------------------------------
 bool Raven_Map::LoadMap(const std::string& filename)
 {  
+  //binary maps are recognized by their header. Anything else is assumed to
+  //be a map editor file
+  Raven_MapFile BinaryMap;
+
+  if (BinaryMap.Open(filename))
+  {
+    return LoadBinaryMap(BinaryMap, filename);
+  }
+
+  if (BinaryMap.isDamaged())
+  {
+    ErrorBox("Damaged Map File");
+    return false;
+  }
+
   std::ifstream in(filename.c_str());
   if (!in)
   {
@@ -193,41 +291,10 @@ bool Raven_Map::LoadMap(const std::string& filename)
     debug_con << "NavGraph for " << filename << " loaded okay" << "";
 #endif
 
-  //determine the average distance between graph nodes so that we can
-  //partition them efficiently
-  m_dCellSpaceNeighborhoodRange = CalculateAverageGraphEdgeLength(*m_pNavGraph) + 1;
-
-#ifdef LOG_CREATIONAL_STUFF
-    debug_con << "Average edge length is " << CalculateAverageGraphEdgeLength(*m_pNavGraph) << "";
-#endif
-
-#ifdef LOG_CREATIONAL_STUFF
-    debug_con << "Neighborhood range set to " << m_dCellSpaceNeighborhoodRange << "";
-#endif
-
-
-  //load in the map size and adjust the client window accordingly
+  //load in the map size
   in >> m_iSizeX >> m_iSizeY;
 
-#ifdef LOG_CREATIONAL_STUFF
-    debug_con << "Partitioning navgraph nodes..." << "";
-#endif
-
-  //partition the graph nodes
-  PartitionNavGraph();
-
-
-  //get the handle to the game window and resize the client area to accommodate
-  //the map
-  extern char* g_szApplicationName;
-  extern char* g_szWindowClassName;
-  HWND hwnd = FindWindow(g_szWindowClassName, g_szApplicationName);
-  const int ExtraHeightRqdToDisplayInfo = 50;
-  ResizeWindow(hwnd, m_iSizeX, m_iSizeY+ExtraHeightRqdToDisplayInfo);
-
-#ifdef LOG_CREATIONAL_STUFF
-    debug_con << "Loading map..." << "";
-#endif
+  PrepareEnvironment();
 
  
   //now create the environment entities
@@ -294,20 +361,304 @@ bool Raven_Map::LoadMap(const std::string& filename)
     debug_con << filename << " loaded okay" << "";
 #endif
 
-   //calculate the cost lookup table
-  m_PathCosts = CreateAllPairsCostsTable(*m_pNavGraph);
+  PartitionTriggers();
+
+  CreateCostOracle(filename);
 
   return true;
 }
 
+//------------------------- PrepareEnvironment --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Map::PrepareEnvironment()
+{
+  //the navgraph doesn't change once loaded so it can be laid out for
+  //searching now
+  m_pCompactNavGraph = new CompactNavGraph(*m_pNavGraph);
+
+  //on a large navgraph a search can expand thousands of nodes, so long
+  //paths are planned across clusters of nodes first
+  if (m_pNavGraph->NumActiveNodes() >= script->GetInt("MinNodesForHierarchicalPaths"))
+  {
+    m_pHierarchicalNavGraph = new HierarchicalNavGraph(*m_pCompactNavGraph,
+                                                       script->GetDouble("HierarchicalClusterSize"));
+  }
+
+  //a navgraph laid out as a grid can be searched with jump point search
+  m_pNavGridLayout = new NavGridLayout(*m_pCompactNavGraph);
+
+  if (!m_pNavGridLayout->isGrid())
+  {
+    delete m_pNavGridLayout;
+    m_pNavGridLayout = NULL;
+  }
+
+  //paths stored for one navgraph mean nothing for another
+  m_pPathCache = new Raven_PathCache(script->GetInt("PathCacheSize"));
+
+  //the fields are calculated as they are needed, once the givers are in
+  //place
+  m_pItemFlowFields = new Raven_ItemFlowFields(*this);
+
+  //the raster and the smoothing table are made by Raven_Game::LoadMap, once
+  //the walls, doors and bots are in place
+  m_pClosestNodeRaster = new Raven_ClosestNodeRaster(*this, script->GetDouble("ClosestNodeRasterCellSize"));
+
+  m_pPathSmoother = new Raven_PathSmoother(*this, script->GetInt("MaxNodesForSmoothingTable"));
+
+  //determine the average distance between graph nodes so that we can
+  //partition them efficiently
+  m_dCellSpaceNeighborhoodRange = CalculateAverageGraphEdgeLength(*m_pNavGraph) + 1;
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Average edge length is " << CalculateAverageGraphEdgeLength(*m_pNavGraph) << "";
+#endif
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Neighborhood range set to " << m_dCellSpaceNeighborhoodRange << "";
+#endif
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Partitioning navgraph nodes..." << "";
+#endif
+
+  //partition the graph nodes
+  PartitionNavGraph();
+
+  //create the grid the walls are partitioned into as they are loaded
+  m_pWallSpace = new WallSpacePartition(m_iSizeX,
+                                        m_iSizeY,
+                                        script->GetInt("NumWallCellsX"),
+                                        script->GetInt("NumWallCellsY"));
+
+
+#ifndef RAVEN_HEADLESS
+  //get the handle to the game window and resize the client area to accommodate
+  //the map
+  extern char* g_szApplicationName;
+  extern char* g_szWindowClassName;
+  HWND hwnd = FindWindow(g_szWindowClassName, g_szApplicationName);
+  const int ExtraHeightRqdToDisplayInfo = 50;
+  ResizeWindow(hwnd, m_iSizeX, m_iSizeY+ExtraHeightRqdToDisplayInfo);
+#endif
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Loading map..." << "";
+#endif
+}
+
+//--------------------------- LoadBinaryMap -----------------------------------
+//
+//  the same as LoadMap but the navgraph and entities are created straight
+//  from the records in the binary map rather than being parsed
+//-----------------------------------------------------------------------------
+bool Raven_Map::LoadBinaryMap(const Raven_MapFile& map, const std::string& filename)
+{
+  Clear();
+
+  BaseGameEntity::ResetNextValidID();
+
+  //restore the navgraph's nodes and then its edge lists, exactly as they
+  //were when the map was converted
+  m_pNavGraph = new NavGraph(false);
+
+  for (int n=0; n<map.NumNodes(); ++n)
+  {
+    const MapFileNode& node = map.Node(n);
+
+    m_pNavGraph->RestoreNode(GraphNode(node.Index, Vector2D(node.PosX, node.PosY)));
+  }
+
+  for (int n=0; n<map.NumNodes(); ++n)
+  {
+    for (const MapFileEdge* pE = map.EdgesBegin(n); pE != map.EdgesEnd(n); ++pE)
+    {
+      m_pNavGraph->RestoreEdge(NavGraphEdge(pE->From,
+                                            pE->To,
+                                            pE->Cost,
+                                            pE->Flags,
+                                            pE->IDofIntersectingEntity));
+    }
+  }
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "NavGraph for " << filename << " loaded okay" << "";
+#endif
+
+  m_iSizeX = map.SizeX();
+  m_iSizeY = map.SizeY();
+
+  PrepareEnvironment();
+
+  //now create the environment entities
+  for (int e=0; e<map.NumEntities(); ++e)
+  {
+    const MapFileEntity& entity = map.Entity(e);
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Creating a " << GetNameOfType(entity.Type) << "";
+#endif
+
+    switch(entity.Type)
+    {
+    case type_wall:
+      {
+        const MapFileWall& w = entity.Wall;
+
+        AddWall(new Wall2D(Vector2D(w.FromX, w.FromY),
+                           Vector2D(w.ToX, w.ToY),
+                           Vector2D(w.NormalX, w.NormalY)));
+      }
+
+      break;
+
+    case type_sliding_door:
+      {
+        const MapFileDoor& d = entity.Door;
+
+        std::vector<unsigned int> switches;
+
+        for (unsigned int s=0; s<d.NumSwitches; ++s)
+        {
+          switches.push_back(map.DoorSwitch(d.FirstSwitch + s));
+        }
+
+        AddDoor(new Raven_Door(this,
+                               entity.ID,
+                               Vector2D(d.P1X, d.P1Y),
+                               Vector2D(d.P2X, d.P2Y),
+                               switches));
+      }
+
+      break;
+
+    case type_door_trigger:
+      {
+        const MapFileDoorTrigger& t = entity.DoorTrigger;
+
+        AddDoorTrigger(new Trigger_OnButtonSendMsg<Raven_Bot>(entity.ID,
+                                                              t.Receiver,
+                                                              t.MessageToSend,
+                                                              Vector2D(t.PosX, t.PosY),
+                                                              t.Radius));
+      }
+
+      break;
+
+    case type_spawn_point:
+
+      m_SpawnPoints.push_back(Vector2D(entity.SpawnPoint.PosX, entity.SpawnPoint.PosY));
+
+      break;
+
+    case type_health:
+      {
+        const MapFileGiver& g = entity.Giver;
+
+        AddHealth_Giver(new Trigger_HealthGiver(entity.ID,
+                                                Vector2D(g.PosX, g.PosY),
+                                                g.Radius,
+                                                g.HealthGiven,
+                                                g.GraphNodeIndex));
+      }
+
+      break;
+
+    case type_shotgun:
+    case type_rail_gun:
+    case type_rocket_launcher:
+    case type_grenade_launcher:
+      {
+        const MapFileGiver& g = entity.Giver;
+
+        Trigger_WeaponGiver* wg = new Trigger_WeaponGiver(entity.ID,
+                                                          Vector2D(g.PosX, g.PosY),
+                                                          g.Radius,
+                                                          g.GraphNodeIndex);
+        wg->SetEntityType(entity.Type);
+
+        AddWeapon_Giver(wg);
+      }
+
+      break;
+    }//end switch
+  }
+
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << filename << " loaded okay" << "";
+#endif
+
+  PartitionTriggers();
+
+  CreateCostOracle(filename);
+
+  return true;
+}
+
+//-------------------------- CreateCostOracle ---------------------------------
+//
+//  The all pairs lookup table is fastest but its size grows with the square
+//  of the number of nodes, so large graphs use landmarks instead.
+//
+//  Calculating the table takes a while so it is saved next to the map file
+//  and reused by later loads of the same map. The file is tagged with a hash
+//  of the navgraph so editing the graph makes the old table be ignored
+//-----------------------------------------------------------------------------
+void Raven_Map::CreateCostOracle(const std::string& filename)
+{
+  if (m_pNavGraph->NumNodes() > script->GetInt("MaxNodesForCostTable"))
+  {
+    m_pCostOracle = new GraphCostOracle_Landmarks<CompactNavGraph>(*m_pCompactNavGraph,
+                                                            script->GetInt("CostOracleNumLandmarks"),
+                                                            script->GetInt("CostOracleCacheSize"));
+    return;
+  }
+
+  const bool               bUseCache     = script->GetBool("CacheCostTables");
+  const std::string        CacheFileName = filename + ".costs";
+  const unsigned long long GraphHash     = CalculateGraphHash(*m_pNavGraph);
+
+  if (bUseCache)
+  {
+    GraphCostOracle_MappedTable<CompactNavGraph>* pCached =
+      new GraphCostOracle_MappedTable<CompactNavGraph>(CacheFileName, *m_pCompactNavGraph, GraphHash);
+
+    if (pCached->isValid())
+    {
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Using path costs from " << CacheFileName << "";
+#endif
+
+      m_pCostOracle = pCached; return;
+    }
+
+    delete pCached;
+  }
+
+  //the search from each node is independent of the others so they are
+  //shared out between the cores
+  ThreadPool pool(script->GetInt("NumPrecalcThreads"));
+
+  GraphCostOracle_Table<CompactNavGraph>* pTable =
+    new GraphCostOracle_Table<CompactNavGraph>(*m_pCompactNavGraph, pool, ReportCostTableProgress);
+
+  if (bUseCache && !pTable->Save(CacheFileName, GraphHash))
+  {
+#ifdef LOG_CREATIONAL_STUFF
+    debug_con << "Unable to save path costs to " << CacheFileName << "";
+#endif
+  }
+
+  m_pCostOracle = pTable;
+}
+
 
 
 
 
 //------------- CalculateCostToTravelBetweenNodes -----------------------------
 //
-//  Uses the pre-calculated lookup table to determine the cost of traveling
-//  from nd1 to nd2
+//  Uses the cost oracle to determine the cost of traveling from nd1 to nd2
 //-----------------------------------------------------------------------------
 double 
 Raven_Map::CalculateCostToTravelBetweenNodes(int nd1, int nd2)const
@@ -316,7 +667,19 @@ Raven_Map::CalculateCostToTravelBetweenNodes(int nd1, int nd2)const
           nd2>=0 && nd2<m_pNavGraph->NumNodes() &&
           "<Raven_Map::CostBetweenNodes>: invalid index");
 
-  return m_PathCosts[nd1][nd2];
+  return m_pCostOracle->Cost(nd1, nd2);
+}
+
+//------------- CalculateLowerBoundCostBetweenNodes ---------------------------
+//-----------------------------------------------------------------------------
+double 
+Raven_Map::CalculateLowerBoundCostBetweenNodes(int nd1, int nd2)const
+{
+  assert (nd1>=0 && nd1<m_pNavGraph->NumNodes() &&
+          nd2>=0 && nd2<m_pNavGraph->NumNodes() &&
+          "<Raven_Map::CalculateLowerBoundCostBetweenNodes>: invalid index");
+
+  return m_pCostOracle->LowerBound(nd1, nd2);
 }
 
 
@@ -342,13 +705,14 @@ void Raven_Map::PartitionNavGraph()
   }   
 }
 
-//---------------------------- AddSoundTrigger --------------------------------
-//
-//  given the bot that has made a sound, this method adds a SoundMade trigger
+//--------------------------- PartitionTriggers -------------------------------
 //-----------------------------------------------------------------------------
-void Raven_Map::AddSoundTrigger(Raven_Bot* pSoundSource, double range)
+void Raven_Map::PartitionTriggers()
 {
-  m_TriggerSystem.Register(new Trigger_SoundNotify(pSoundSource, range));
+  m_TriggerSystem.Partition(m_iSizeX,
+                            m_iSizeY,
+                            script->GetInt("NumTriggerCellsX"),
+                            script->GetInt("NumTriggerCellsY"));
 }
 
 //----------------------- UpdateTriggerSystem ---------------------------------
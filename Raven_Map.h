@@ -16,17 +16,29 @@
 #include <vector>
 #include <string>
 #include <list>
-#include "graph/SparseGraph.h"
-#include "2d/Wall2D.h"
-#include "triggers/Trigger.h"
+#include "Graph/SparseGraph.h"
+#include "Graph/CompactGraph.h"
+#include "Graph/HierarchicalGraph.h"
+#include "Graph/GridLayout.h"
+#include "2D/Wall2D.h"
+#include "2D/WallSpacePartition.h"
+#include "Triggers/Trigger.h"
 #include "Raven_Bot.h"
 #include "Graph/GraphEdgeTypes.h"
 #include "Graph/GraphNodeTypes.h"
 #include "misc/CellSpacePartition.h"
-#include "triggers/TriggerSystem.h"
+#include "Triggers/TriggerSystem.h"
 
 class BaseGameEntity;
 class Raven_Door;
+class Raven_MapFile;
+class Trigger_HealthGiver;
+class Trigger_WeaponGiver;
+class Raven_PathCache;
+class Raven_ItemFlowFields;
+class Raven_ClosestNodeRaster;
+class Raven_PathSmoother;
+template <class graph_type> class GraphCostOracle;
 
 
 class Raven_Map
@@ -35,16 +47,23 @@ public:
 
   typedef NavGraphNode<Trigger<Raven_Bot>*>         GraphNode;
   typedef SparseGraph<GraphNode, NavGraphEdge>      NavGraph;
+  typedef CompactGraph<NavGraph>                    CompactNavGraph;
+  typedef HierarchicalGraph<CompactNavGraph>        HierarchicalNavGraph;
+  typedef GridLayout<CompactNavGraph>               NavGridLayout;
   typedef CellSpacePartition<NavGraph::NodeType*>   CellSpace;
 
   typedef Trigger<Raven_Bot>                        TriggerType;
-  typedef TriggerSystem<TriggerType>                TriggerSystem;
+  typedef ::TriggerSystem<TriggerType>              TriggerSystem;
   
 private:
  
   //the walls that comprise the current map's architecture. 
   std::vector<Wall2D*>                m_Walls;
 
+  //the walls are also partitioned into a grid to speed up line of sight
+  //and ray queries
+  WallSpacePartition*                m_pWallSpace;
+
   //trigger are objects that define a region of space. When a raven bot
   //enters that area, it 'triggers' an event. That event may be anything
   //from increasing a bot's health to opening a door or requesting a lift.
@@ -60,6 +79,17 @@ private:
   //this map's accompanying navigation graph
   NavGraph*                          m_pNavGraph;  
 
+  //the navgraph laid out for fast searching. Searches should use this
+  //rather than m_pNavGraph
+  CompactNavGraph*                   m_pCompactNavGraph;
+
+  //the clusters of a large navgraph and the ways between them, used to
+  //plan long paths. NULL if the navgraph is too small to need it
+  HierarchicalNavGraph*              m_pHierarchicalNavGraph;
+
+  //the layout of the navgraph if it is a regular grid, else NULL
+  NavGridLayout*                     m_pNavGridLayout;
+
   //the graph nodes will be partitioned enabling fast lookup
   CellSpace*                        m_pSpacePartition;
 
@@ -72,9 +102,32 @@ private:
   
   void  PartitionNavGraph();
 
-  //this will hold a pre-calculated lookup table of the cost to travel from
-  //one node to any other.
-  std::vector<std::vector<double> >  m_PathCosts;
+  //the givers and switches never move, so once they are loaded they are
+  //placed in a grid and each bot is only tried against those near it
+  void  PartitionTriggers();
+
+  //this answers queries about the cost to travel from one node to any
+  //other. Small graphs use a pre-calculated lookup table; larger graphs use
+  //an oracle whose memory use grows linearly with the size of the graph
+  GraphCostOracle<CompactNavGraph>*  m_pCostOracle;
+
+  //creates the cost oracle for the navgraph loaded from the named map file
+  void  CreateCostOracle(const std::string& filename);
+
+  //the paths the bots have found, shared between them
+  Raven_PathCache*                   m_pPathCache;
+
+  //the way from anywhere on the navgraph to the nearest item of each type
+  Raven_ItemFlowFields*              m_pItemFlowFields;
+
+  //the navgraph node closest to each part of the map
+  Raven_ClosestNodeRaster*           m_pClosestNodeRaster;
+
+  //smooths the bots' paths, remembering which shortcuts can be walked
+  Raven_PathSmoother*                m_pPathSmoother;
+
+  //the number of times a door has changed state
+  unsigned int                       m_iNumDoorStateChanges;
 
 
     //stream constructors for loading from a file
@@ -85,6 +138,20 @@ private:
   void AddDoor(std::ifstream& in);
   void AddDoorTrigger(std::ifstream& in);
 
+  //these add entities that have already been created
+  void AddWall(Wall2D* pWall);
+  void AddHealth_Giver(Trigger_HealthGiver* pGiver);
+  void AddWeapon_Giver(Trigger_WeaponGiver* pGiver);
+  void AddDoor(Raven_Door* pDoor);
+  void AddDoorTrigger(TriggerType* pTrigger);
+
+  //once the navgraph and map size are known this creates the spatial
+  //partitions ready for the entities to be added
+  void PrepareEnvironment();
+
+  //sets up the game environment from a binary map
+  bool LoadBinaryMap(const Raven_MapFile& map, const std::string& filename);
+
   void Clear();
   
 public:
@@ -94,27 +161,51 @@ public:
 
   void Render();
 
-  //loads an environment from a file
+  //loads an environment from a file. This may be either a map editor file
+  //or a binary map created from one by ConvertMapFile
   bool LoadMap(const std::string& FileName); 
 
   //adds a wall and returns a pointer to that wall. (this method can be
   //used by objects such as doors to add walls to the environment)
   Wall2D* AddWall(Vector2D from, Vector2D to);
 
-  void    AddSoundTrigger(Raven_Bot* pSoundSource, double range);
+  //walls that move (such as those belonging to doors) must be moved using
+  //this method so that the wall space partition is kept up to date
+  void    MoveWall(Wall2D* pWall, Vector2D from, Vector2D to);
 
   double   CalculateCostToTravelBetweenNodes(int nd1, int nd2)const;
 
+  //returns a value never greater than the cost to travel between the two
+  //nodes. This is cheap to calculate so use it to rule out nodes before
+  //calling CalculateCostToTravelBetweenNodes
+  double   CalculateLowerBoundCostBetweenNodes(int nd1, int nd2)const;
+
   //returns the position of a graph node selected at random
   Vector2D GetRandomNodeLocation()const;
   
   
   void  UpdateTriggerSystem(std::list<Raven_Bot*>& bots);
 
+  //doors call this whenever they start or finish opening or closing
+  void  DoorStateChanged(){++m_iNumDoorStateChanges;}
+
+  //these count the changes that affect the paths in the path cache
+  unsigned int  GetNumDoorStateChanges()const{return m_iNumDoorStateChanges;}
+  unsigned int  GetNumTriggerStateChanges()const{return TriggerType::NumStateChanges();}
+
   const Raven_Map::TriggerSystem::TriggerList&  GetTriggers()const{return m_TriggerSystem.GetTriggers();}
   const std::vector<Wall2D*>&        GetWalls()const{return m_Walls;}
+  const WallSpacePartition&          GetWallSpace()const{return *m_pWallSpace;}
   NavGraph&                          GetNavGraph()const{return *m_pNavGraph;}
+  const CompactNavGraph&             GetCompactNavGraph()const{return *m_pCompactNavGraph;}
+  const HierarchicalNavGraph*        GetHierarchicalNavGraph()const{return m_pHierarchicalNavGraph;}
+  const NavGridLayout*               GetNavGridLayout()const{return m_pNavGridLayout;}
+  Raven_PathCache* const             GetPathCache()const{return m_pPathCache;}
+  Raven_ItemFlowFields* const        GetItemFlowFields()const{return m_pItemFlowFields;}
+  Raven_ClosestNodeRaster* const     GetClosestNodeRaster()const{return m_pClosestNodeRaster;}
+  Raven_PathSmoother* const          GetPathSmoother()const{return m_pPathSmoother;}
   std::vector<Raven_Door*>&          GetDoors(){return m_Doors;}
+  const std::vector<Raven_Door*>&    GetDoors()const{return m_Doors;}
   const std::vector<Vector2D>&       GetSpawnPoints()const{return m_SpawnPoints;}
   CellSpace* const                   GetCellSpace()const{return m_pSpacePartition;}
   Vector2D                           GetRandomSpawnPoint(){return m_SpawnPoints[RandInt(0,m_SpawnPoints.size()-1)];}
@@ -0,0 +1,398 @@
+#include "Raven_MapFile.h"
+#include "Raven_ObjectEnumerations.h"
+#include "Graph/SparseGraph.h"
+#include "Graph/GraphNodeTypes.h"
+#include "Graph/GraphEdgeTypes.h"
+
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+
+const char MapFileMagic[8] = "RVNMAP";
+
+
+//returns the number of bytes needed to store Count elements of type T,
+//rounded up to keep the next array 8 byte aligned
+template <class T>
+static std::size_t ArraySize(unsigned int Count)
+{
+  return (sizeof(T) * Count + 7) & ~(std::size_t)7;
+}
+
+
+//----------------------------- ctor ------------------------------------------
+//-----------------------------------------------------------------------------
+Raven_MapFile::Raven_MapFile():m_pHeader(NULL),
+                               m_pNodes(NULL),
+                               m_pEdgeOffsets(NULL),
+                               m_pEdges(NULL),
+                               m_pEntities(NULL),
+                               m_pDoorSwitches(NULL),
+                               m_bDamaged(false)
+{}
+
+//------------------------------- Close ---------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_MapFile::Close()
+{
+  m_File.Close();
+
+  m_pHeader       = NULL;
+  m_pNodes        = NULL;
+  m_pEdgeOffsets  = NULL;
+  m_pEdges        = NULL;
+  m_pEntities     = NULL;
+  m_pDoorSwitches = NULL;
+}
+
+//------------------------------- Open ----------------------------------------
+//
+//  as well as checking the header, every index in the file is checked to be
+//  in range so that a damaged file can't crash the game
+//-----------------------------------------------------------------------------
+bool Raven_MapFile::Open(const std::string& filename)
+{
+  Close();
+
+  m_bDamaged = false;
+
+  if (!m_File.Open(filename)) return false;
+
+  if (m_File.Size() < sizeof(MapFileHeader))
+  {
+    Close(); return false;
+  }
+
+  const MapFileHeader* pHeader = reinterpret_cast<const MapFileHeader*>(m_File.Data());
+
+  if (std::memcmp(pHeader->Magic, MapFileMagic, sizeof(pHeader->Magic)) != 0 ||
+      pHeader->Version != MapFileHeader::current_version)
+  {
+    Close(); return false;
+  }
+
+  //from here on a failed check means a binary map that is damaged
+  m_bDamaged = true;
+
+  //find the start of each array
+  const char* p = m_File.Data() + sizeof(MapFileHeader);
+
+  m_pNodes        = reinterpret_cast<const MapFileNode*>(p);
+  p += ArraySize<MapFileNode>(pHeader->NumNodes);
+
+  m_pEdgeOffsets  = reinterpret_cast<const unsigned int*>(p);
+  p += ArraySize<unsigned int>(pHeader->NumNodes + 1);
+
+  m_pEdges        = reinterpret_cast<const MapFileEdge*>(p);
+  p += ArraySize<MapFileEdge>(pHeader->NumEdges);
+
+  m_pEntities     = reinterpret_cast<const MapFileEntity*>(p);
+  p += ArraySize<MapFileEntity>(pHeader->NumEntities);
+
+  m_pDoorSwitches = reinterpret_cast<const unsigned int*>(p);
+  p += ArraySize<unsigned int>(pHeader->NumDoorSwitches);
+
+  if ((std::size_t)(p - m_File.Data()) != m_File.Size())
+  {
+    Close(); return false;
+  }
+
+  //check the graph
+  const unsigned int NumNodes = pHeader->NumNodes;
+
+  if (m_pEdgeOffsets[0] != 0 || m_pEdgeOffsets[NumNodes] != pHeader->NumEdges)
+  {
+    Close(); return false;
+  }
+
+  for (unsigned int n=0; n<NumNodes; ++n)
+  {
+    //a node is either at its own index or is a removed node
+    if (m_pNodes[n].Index != (int)n && m_pNodes[n].Index != invalid_node_index)
+    {
+      Close(); return false;
+    }
+
+    if (m_pEdgeOffsets[n] > m_pEdgeOffsets[n+1])
+    {
+      Close(); return false;
+    }
+
+    for (unsigned int e=m_pEdgeOffsets[n]; e<m_pEdgeOffsets[n+1]; ++e)
+    {
+      if (m_pEdges[e].From != (int)n || m_pEdges[e].To < 0 || m_pEdges[e].To >= (int)NumNodes)
+      {
+        Close(); return false;
+      }
+    }
+  }
+
+  //check the entities
+  for (unsigned int e=0; e<pHeader->NumEntities; ++e)
+  {
+    const MapFileEntity& entity = m_pEntities[e];
+
+    switch (entity.Type)
+    {
+    case type_wall:
+    case type_spawn_point:
+    case type_door_trigger:
+
+      break;
+
+    case type_sliding_door:
+
+      if (entity.Door.FirstSwitch > pHeader->NumDoorSwitches ||
+          entity.Door.NumSwitches > pHeader->NumDoorSwitches - entity.Door.FirstSwitch)
+      {
+        Close(); return false;
+      }
+
+      break;
+
+    case type_health:
+    case type_shotgun:
+    case type_rail_gun:
+    case type_rocket_launcher:
+    case type_grenade_launcher:
+
+      if (entity.Giver.GraphNodeIndex < 0 || entity.Giver.GraphNodeIndex >= (int)NumNodes)
+      {
+        Close(); return false;
+      }
+
+      break;
+
+    default:
+
+      Close(); return false;
+    }
+  }
+
+  m_pHeader  = pHeader;
+  m_bDamaged = false;
+
+  return true;
+}
+
+
+//---------------------------- ConvertMapFile ---------------------------------
+//
+//  the entities are read exactly as Raven_Map::LoadMap reads them. The
+//  navgraph is loaded into a SparseGraph first so that its edge lists are
+//  written in the same order LoadMap would have created them in
+//-----------------------------------------------------------------------------
+bool ConvertMapFile(const std::string& MapFileName, const std::string& BinaryFileName)
+{
+  std::ifstream in(MapFileName.c_str());
+
+  if (!in)
+  {
+    throw std::runtime_error("Cannot open file: " + MapFileName);
+  }
+
+  typedef SparseGraph<NavGraphNode<>, NavGraphEdge> Graph;
+
+  Graph graph(false);
+
+  graph.Load(in);
+
+  MapFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+
+  std::memcpy(header.Magic, MapFileMagic, sizeof(header.Magic));
+  header.Version  = MapFileHeader::current_version;
+  header.NumNodes = graph.NumNodes();
+
+  in >> header.SizeX >> header.SizeY;
+
+  //copy the graph into compressed sparse row form
+  std::vector<MapFileNode>  nodes(header.NumNodes);
+  std::vector<unsigned int> EdgeOffsets(header.NumNodes + 1, 0);
+  std::vector<MapFileEdge>  edges;
+
+  for (int n=0; n<graph.NumNodes(); ++n)
+  {
+    std::memset(&nodes[n], 0, sizeof(MapFileNode));
+
+    nodes[n].PosX  = graph.GetNode(n).Pos().x;
+    nodes[n].PosY  = graph.GetNode(n).Pos().y;
+    nodes[n].Index = graph.GetNode(n).Index();
+
+    EdgeOffsets[n] = edges.size();
+
+    Graph::ConstEdgeIterator EdgeItr(graph, n);
+
+    for (const NavGraphEdge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      MapFileEdge edge;
+
+      edge.Cost                   = pE->Cost();
+      edge.From                   = pE->From();
+      edge.To                     = pE->To();
+      edge.Flags                  = pE->Flags();
+      edge.IDofIntersectingEntity = pE->IDofIntersectingEntity();
+
+      edges.push_back(edge);
+    }
+  }
+
+  EdgeOffsets[header.NumNodes] = edges.size();
+  header.NumEdges = edges.size();
+
+  //read the entities
+  std::vector<MapFileEntity> entities;
+  std::vector<unsigned int>  DoorSwitches;
+
+  int EntityType;
+
+  while (in >> EntityType)
+  {
+    MapFileEntity entity;
+    std::memset(&entity, 0, sizeof(MapFileEntity));
+
+    entity.Type = EntityType;
+
+    switch(EntityType)
+    {
+    case type_wall:
+      {
+        MapFileWall& w = entity.Wall;
+
+        in >> w.FromX >> w.FromY >> w.ToX >> w.ToY >> w.NormalX >> w.NormalY;
+      }
+
+      break;
+
+    case type_sliding_door:
+      {
+        MapFileDoor& d = entity.Door;
+
+        unsigned int NumSwitches;
+
+        in >> entity.ID >> d.P1X >> d.P1Y >> d.P2X >> d.P2Y >> NumSwitches;
+
+        d.FirstSwitch = DoorSwitches.size();
+        d.NumSwitches = NumSwitches;
+
+        for (unsigned int s=0; s<NumSwitches; ++s)
+        {
+          unsigned int id;
+          in >> id;
+
+          DoorSwitches.push_back(id);
+        }
+      }
+
+      break;
+
+    case type_door_trigger:
+      {
+        MapFileDoorTrigger& t = entity.DoorTrigger;
+
+        in >> entity.ID >> t.Receiver >> t.MessageToSend >> t.PosX >> t.PosY >> t.Radius;
+      }
+
+      break;
+
+    case type_spawn_point:
+      {
+        double dummy;
+
+        //dummy values are artifacts from the map editor
+        in >> dummy >> entity.SpawnPoint.PosX >> entity.SpawnPoint.PosY >> dummy >> dummy;
+      }
+
+      break;
+
+    case type_health:
+      {
+        MapFileGiver& g = entity.Giver;
+
+        in >> entity.ID >> g.PosX >> g.PosY >> g.Radius >> g.HealthGiven >> g.GraphNodeIndex;
+      }
+
+      break;
+
+    case type_shotgun:
+    case type_rail_gun:
+    case type_rocket_launcher:
+    case type_grenade_launcher:
+      {
+        MapFileGiver& g = entity.Giver;
+
+        in >> entity.ID >> g.PosX >> g.PosY >> g.Radius >> g.GraphNodeIndex;
+      }
+
+      break;
+
+    default:
+
+      throw std::runtime_error("<ConvertMapFile>: Attempting to convert undefined object");
+    }
+
+    if (in.fail())
+    {
+      throw std::runtime_error("<ConvertMapFile>: Unexpected end of file in " + MapFileName);
+    }
+
+    entities.push_back(entity);
+  }
+
+  header.NumEntities     = entities.size();
+  header.NumDoorSwitches = DoorSwitches.size();
+
+  //write everything out, padding each array to an 8 byte boundary. The file
+  //is written to a temporary name and then renamed so that a game loading
+  //the map never sees it half written
+  const std::string TempFileName = BinaryFileName + ".tmp";
+
+  std::ofstream out(TempFileName.c_str(), std::ios::binary | std::ios::trunc);
+
+  if (!out) return false;
+
+  const char padding[8] = {0};
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  if (!nodes.empty())
+  {
+    out.write(reinterpret_cast<const char*>(&nodes[0]), sizeof(MapFileNode) * nodes.size());
+  }
+
+  out.write(reinterpret_cast<const char*>(&EdgeOffsets[0]), sizeof(unsigned int) * EdgeOffsets.size());
+  out.write(padding, ArraySize<unsigned int>(EdgeOffsets.size()) - sizeof(unsigned int) * EdgeOffsets.size());
+
+  if (!edges.empty())
+  {
+    out.write(reinterpret_cast<const char*>(&edges[0]), sizeof(MapFileEdge) * edges.size());
+  }
+
+  if (!entities.empty())
+  {
+    out.write(reinterpret_cast<const char*>(&entities[0]), sizeof(MapFileEntity) * entities.size());
+  }
+
+  if (!DoorSwitches.empty())
+  {
+    out.write(reinterpret_cast<const char*>(&DoorSwitches[0]), sizeof(unsigned int) * DoorSwitches.size());
+  }
+
+  out.write(padding, ArraySize<unsigned int>(DoorSwitches.size()) - sizeof(unsigned int) * DoorSwitches.size());
+
+  out.close();
+
+  if (!out)
+  {
+    std::remove(TempFileName.c_str());
+    return false;
+  }
+
+  //rename won't replace an existing file on every platform
+  std::remove(BinaryFileName.c_str());
+
+  return std::rename(TempFileName.c_str(), BinaryFileName.c_str()) == 0;
+}
@@ -0,0 +1,200 @@
+#ifndef RAVEN_MAPFILE_H
+#define RAVEN_MAPFILE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_MapFile.h
+//
+//  Desc:   the binary map format. A binary map holds the same information
+//          as a map editor (.map) file but can be loaded without any
+//          parsing: the file is memory mapped and Raven_Map builds the game
+//          world directly from the records in it.
+//
+//          The file is laid out as
+//
+//            MapFileHeader
+//            MapFileNode     [NumNodes]
+//            unsigned int    [NumNodes+1]  offset of each node's first edge
+//            MapFileEdge     [NumEdges]    grouped by the node they lead from
+//            MapFileEntity   [NumEntities] in the order of the .map file
+//            unsigned int    [NumDoorSwitches]
+//
+//          with each array starting on an 8 byte boundary. The navgraph is
+//          therefore in compressed sparse row form: the edges leading from
+//          node n are Edges[EdgeOffsets[n]] to Edges[EdgeOffsets[n+1]-1], in
+//          the same order as n's edge list in the graph that was converted.
+//
+//          Binary maps are created from .map files with ConvertMapFile (or
+//          the Raven_MapConvert tool). The file uses the byte order of the
+//          machine that created it.
+//-----------------------------------------------------------------------------
+#include <string>
+
+#include "misc/MappedFile.h"
+
+
+//------------------------------- header --------------------------------------
+struct MapFileHeader
+{
+  enum {current_version = 1};
+
+  char          Magic[8];
+  unsigned int  Version;
+
+  int           SizeX;
+  int           SizeY;
+
+  unsigned int  NumNodes;
+  unsigned int  NumEdges;
+  unsigned int  NumEntities;
+  unsigned int  NumDoorSwitches;
+  unsigned int  Unused;
+};
+
+//------------------------------- navgraph ------------------------------------
+struct MapFileNode
+{
+  double        PosX;
+  double        PosY;
+
+  //invalid_node_index if the node has been removed from the graph
+  int           Index;
+  int           Unused;
+};
+
+struct MapFileEdge
+{
+  double        Cost;
+  int           From;
+  int           To;
+  int           Flags;
+  int           IDofIntersectingEntity;
+};
+
+//------------------------------- entities ------------------------------------
+//
+//  Type is one of the entity types from Raven_ObjectEnumerations.h and says
+//  which member of the union is in use
+//-----------------------------------------------------------------------------
+struct MapFileWall
+{
+  double        FromX, FromY;
+  double        ToX,   ToY;
+  double        NormalX, NormalY;
+};
+
+struct MapFileDoor
+{
+  double        P1X, P1Y;
+  double        P2X, P2Y;
+
+  //the IDs of the door's switches are DoorSwitches[FirstSwitch] to
+  //DoorSwitches[FirstSwitch+NumSwitches-1]
+  unsigned int  FirstSwitch;
+  unsigned int  NumSwitches;
+};
+
+struct MapFileDoorTrigger
+{
+  double        PosX, PosY;
+  double        Radius;
+  unsigned int  Receiver;
+  int           MessageToSend;
+};
+
+struct MapFileSpawnPoint
+{
+  double        PosX, PosY;
+};
+
+//the health and weapon givers
+struct MapFileGiver
+{
+  double        PosX, PosY;
+  double        Radius;
+  int           GraphNodeIndex;
+
+  //only used by health givers
+  int           HealthGiven;
+};
+
+struct MapFileEntity
+{
+  int           Type;
+
+  //the entity's ID. Walls and spawn points aren't entities so don't use it
+  int           ID;
+
+  union
+  {
+    MapFileWall         Wall;
+    MapFileDoor         Door;
+    MapFileDoorTrigger  DoorTrigger;
+    MapFileSpawnPoint   SpawnPoint;
+    MapFileGiver        Giver;
+  };
+};
+
+
+//----------------------------- Raven_MapFile ---------------------------------
+//
+//  gives access to the records in a memory mapped binary map file
+//-----------------------------------------------------------------------------
+class Raven_MapFile
+{
+private:
+
+  MappedFile                m_File;
+
+  const MapFileHeader*      m_pHeader;
+  const MapFileNode*        m_pNodes;
+  const unsigned int*       m_pEdgeOffsets;
+  const MapFileEdge*        m_pEdges;
+  const MapFileEntity*      m_pEntities;
+  const unsigned int*       m_pDoorSwitches;
+
+  //set by Open if the file is a binary map that fails the checks
+  bool                      m_bDamaged;
+
+public:
+
+  Raven_MapFile();
+
+  //maps the file. Returns false if it isn't a valid binary map, in which
+  //case it is most likely a .map file
+  bool  Open(const std::string& filename);
+
+  void  Close();
+
+  bool  isOpen()const{return m_pHeader != NULL;}
+
+  //true if the last file opened is a binary map but is damaged, rather than
+  //being a .map file
+  bool  isDamaged()const{return m_bDamaged;}
+
+  int   SizeX()const{return m_pHeader->SizeX;}
+  int   SizeY()const{return m_pHeader->SizeY;}
+
+  int   NumNodes()const{return m_pHeader->NumNodes;}
+  int   NumEntities()const{return m_pHeader->NumEntities;}
+
+  const MapFileNode&   Node(int n)const{return m_pNodes[n];}
+
+  //the edges leading from node n are in the range [EdgesBegin(n), EdgesEnd(n))
+  const MapFileEdge*   EdgesBegin(int n)const{return m_pEdges + m_pEdgeOffsets[n];}
+  const MapFileEdge*   EdgesEnd(int n)const{return m_pEdges + m_pEdgeOffsets[n+1];}
+
+  const MapFileEntity& Entity(int e)const{return m_pEntities[e];}
+
+  unsigned int         DoorSwitch(int s)const{return m_pDoorSwitches[s];}
+};
+
+
+//reads a map editor (.map) file and writes it out as a binary map. Throws a
+//std::runtime_error if the .map file can't be read or contains an unknown
+//entity type, and returns false if the binary file can't be written
+bool ConvertMapFile(const std::string& MapFileName, const std::string& BinaryFileName);
+
+
+
+#endif
@@ -1,7 +1,7 @@
 #include "Raven_SensoryMemory.h"
 #include "Raven_Game.h"
-#include "time/crudetimer.h"
-#include "misc/cgdi.h"
+#include "Time/CrudeTimer.h"
+#include "misc/Cgdi.h"
 #include "misc/Stream_Utility_Functions.h"
 
 //------------------------------- ctor ----------------------------------------
@@ -12,16 +12,55 @@
                                                           
 {}
 
+//----------------------------- FindRecord ------------------------------------
+//-----------------------------------------------------------------------------
+int Raven_SensoryMemory::FindRecord(Raven_Bot* pOpponent)const
+{
+  //the targeting system asks about its target whether or not it has one
+  if (!pOpponent) return -1;
+
+  const int row = pOpponent->Slot();
+
+  if (row < (int)m_Opponent.size() && m_Opponent[row] == pOpponent)
+  {
+    return row;
+  }
+
+  return -1;
+}
+
 //--------------------- MakeNewRecordIfNotAlreadyPresent ----------------------
 
-void Raven_SensoryMemory::MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pOpponent)
+int Raven_SensoryMemory::MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pOpponent)
 {
-  //else check to see if this Opponent already exists in the memory. If it doesn't,
+  const int row = pOpponent->Slot();
+
+  //make room for the opponent's slot
+  if (row >= (int)m_Opponent.size())
+  {
+    m_Opponent.resize(row+1, NULL);
+    m_TimeLastSensed.resize(row+1);
+    m_TimeBecameVisible.resize(row+1);
+    m_TimeLastVisible.resize(row+1);
+    m_LastSensedPosition.resize(row+1);
+    m_bWithinFOV.resize(row+1);
+    m_bShootable.resize(row+1);
+  }
+
+  //check to see if this Opponent already exists in the memory. If it doesn't,
   //create a new record
-  if (m_MemoryMap.find(pOpponent) == m_MemoryMap.end())
+  if (m_Opponent[row] != pOpponent)
   {
-    m_MemoryMap[pOpponent] = MemoryRecord();
+    m_Opponent[row]           = pOpponent;
+    m_TimeLastSensed[row]     = -999;
+    m_TimeBecameVisible[row]  = -999;
+    m_TimeLastVisible[row]    = 0;
+    m_LastSensedPosition[row] = Vector2D();
+    m_bWithinFOV[row]         = false;
+    m_bShootable[row]         = false;
   }
+
+  return row;
 }
 
 //------------------------ RemoveBotFromMemory --------------------------------
@@ -30,11 +69,11 @@ void Raven_SensoryMemory::MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pOpponent)
 //-----------------------------------------------------------------------------
 void Raven_SensoryMemory::RemoveBotFromMemory(Raven_Bot* pBot)
 {
-  MemoryMap::iterator record = m_MemoryMap.find(pBot);
+  const int row = FindRecord(pBot);
   
-  if (record != m_MemoryMap.end())
+  if (row >= 0)
   {
-    m_MemoryMap.erase(record);
+    m_Opponent[row] = NULL;
   }
 }
   
@@ -51,113 +90,104 @@ void Raven_SensoryMemory::UpdateWithSoundSource(Raven_Bot* pNoiseMaker)
   {
     //if the bot is already part of the memory then update its data, else
     //create a new memory record and add it to the memory
-    MakeNewRecordIfNotAlreadyPresent(pNoiseMaker);
-
-    MemoryRecord& info = m_MemoryMap[pNoiseMaker];
+    const int row = MakeNewRecordIfNotAlreadyPresent(pNoiseMaker);
 
     //test if there is LOS between bots 
     if (m_pOwner->GetWorld()->isLOSOkay(m_pOwner->Pos(), pNoiseMaker->Pos()))
     {
-      info.bShootable = true;
+      m_bShootable[row] = true;
       
      //record the position of the bot
-      info.vLastSensedPosition = pNoiseMaker->Pos();
+      m_LastSensedPosition[row] = pNoiseMaker->Pos();
     }
     else
     {
-      info.bShootable = false;
+      m_bShootable[row] = false;
     }
     
     //record the time it was sensed
-    info.fTimeLastSensed = (double)Clock->GetCurrentTime();
+    m_TimeLastSensed[row] = (double)Clock->GetCurrentTime();
   }
 }
 
-//----------------------------- UpdateVision ----------------------------------
+//------------------------- UpdateVisionOfOpponent ----------------------------
 //
-//  this method iterates through all the bots in the game world to test if
-//  they are in the field of view. Each bot's memory record is updated
-//  accordingly
+//  this is called by the game's perception pass for each opponent within
+//  view range of the owner. bLOSOkay is the result of the line of sight test
+//  between the pair, which the perception pass shares between both bots. The
+//  opponent's memory record is updated accordingly
 //-----------------------------------------------------------------------------
-void Raven_SensoryMemory::UpdateVision()
+void Raven_SensoryMemory::UpdateVisionOfOpponent(Raven_Bot* pOpponent,
+                                                 bool       bLOSOkay)
 {
-  //for each bot in the world test to see if it is visible to the owner of
-  //this class
-  const std::list<Raven_Bot*>& bots = m_pOwner->GetWorld()->GetAllBots();
-  std::list<Raven_Bot*>::const_iterator curBot;
-  for (curBot = bots.begin(); curBot!=bots.end(); ++curBot)
+  //make sure it is part of the memory
+  const int row = MakeNewRecordIfNotAlreadyPresent(pOpponent);
+
+  //test if there is LOS between bots 
+  if (bLOSOkay)
   {
-    //make sure the bot being examined is not this bot
-    if (m_pOwner != *curBot)
-    {
-      //make sure it is part of the memory map
-      MakeNewRecordIfNotAlreadyPresent(*curBot);
+    m_bShootable[row] = true;
 
-      //get a reference to this bot's data
-      MemoryRecord& info = m_MemoryMap[*curBot];
+          //test if the bot is within FOV
+    if (isSecondInFOVOfFirst(m_pOwner->Pos(),
+                             m_pOwner->Facing(),
+                             pOpponent->Pos(),
+                             m_pOwner->FieldOfView()))
+    {
+      m_TimeLastSensed[row]     = Clock->GetCurrentTime();
+      m_LastSensedPosition[row] = pOpponent->Pos();
+      m_TimeLastVisible[row]    = Clock->GetCurrentTime();
 
-      //test if there is LOS between bots 
-      if (m_pOwner->GetWorld()->isLOSOkay(m_pOwner->Pos(), (*curBot)->Pos()))
+      if (m_bWithinFOV[row] == false)
       {
-        info.bShootable = true;
-
-              //test if the bot is within FOV
-        if (isSecondInFOVOfFirst(m_pOwner->Pos(),
-                                 m_pOwner->Facing(),
-                                 (*curBot)->Pos(),
-                                  m_pOwner->FieldOfView()))
-        {
-          info.fTimeLastSensed     = Clock->GetCurrentTime();
-          info.vLastSensedPosition = (*curBot)->Pos();
-          info.fTimeLastVisible    = Clock->GetCurrentTime();
-
-          if (info.bWithinFOV == false)
-          {
-            info.bWithinFOV           = true;
-            info.fTimeBecameVisible    = info.fTimeLastSensed;
-          
-          }
-        }
-
-        else
-        {
-          info.bWithinFOV = false;         
-        }
+        m_bWithinFOV[row]          = true;
+        m_TimeBecameVisible[row]   = m_TimeLastSensed[row];
+      
       }
+    }
 
-      else
-      {
-        info.bShootable = false;
-        info.bWithinFOV = false;
-      }
+    else
+    {
+      m_bWithinFOV[row] = false;         
     }
-  }//next bot
-}
+  }
 
+  else
+  {
+    m_bShootable[row] = false;
+    m_bWithinFOV[row] = false;
+  }
+}
 
-//------------------------ GetListOfRecentlySensedOpponents -------------------
+//------------------------ UpdateOpponentsOutOfView ---------------------------
 //
-//  returns a list of the bots that have been sensed recently
+//  opponents further away than ViewDistance are not examined by the
+//  perception pass, so any records of them still marked as shootable or in
+//  view are cleared here
 //-----------------------------------------------------------------------------
-std::list<Raven_Bot*> 
-Raven_SensoryMemory::GetListOfRecentlySensedOpponents()const
+void Raven_SensoryMemory::UpdateOpponentsOutOfView(double ViewDistance)
 {
-  //this will store all the opponents the bot can remember
-  std::list<Raven_Bot*> opponents;
-
-  double CurrentTime = Clock->GetCurrentTime();
-
-  MemoryMap::const_iterator curRecord = m_MemoryMap.begin();
-  for (curRecord; curRecord!=m_MemoryMap.end(); ++curRecord)
+  for (unsigned int row=0; row<m_Opponent.size(); ++row)
   {
-    //if this bot has been updated in the memory recently, add to list
-    if ( (CurrentTime - curRecord->second.fTimeLastSensed) <= m_dMemorySpan)
+    if ( m_Opponent[row] && (m_bShootable[row] || m_bWithinFOV[row]) &&
+         Vec2DDistanceSq(m_pOwner->Pos(), m_Opponent[row]->Pos()) >=
+         ViewDistance*ViewDistance)
     {
-      opponents.push_back(curRecord->first);
+      m_bShootable[row] = false;
+      m_bWithinFOV[row] = false;
     }
   }
+}
 
-  return opponents;
+
+//------------------------ GetRecentlySensedOpponents ------------------------
+//
+//  returns a view of the bots that have been sensed recently
+//-----------------------------------------------------------------------------
+Raven_SensoryMemory::RecentlySensedOpponents
+Raven_SensoryMemory::GetRecentlySensedOpponents()const
+{
+  return RecentlySensedOpponents(this, Clock->GetCurrentTime());
 }
 
 //----------------------------- isOpponentShootable --------------------------------
@@ -167,11 +197,11 @@ Raven_SensoryMemory::GetListOfRecentlySensedOpponents()const
 //-----------------------------------------------------------------------------
 bool Raven_SensoryMemory::isOpponentShootable(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const int row = FindRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (row >= 0)
   {
-    return it->second.bShootable;
+    return m_bShootable[row];
   }
 
   return false;
@@ -183,11 +213,11 @@ bool Raven_SensoryMemory::isOpponentShootable(Raven_Bot* pOpponent)const
 //-----------------------------------------------------------------------------
 bool  Raven_SensoryMemory::isOpponentWithinFOV(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const int row = FindRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (row >= 0)
   {
-    return it->second.bWithinFOV;
+    return m_bWithinFOV[row];
   }
 
   return false;
@@ -199,11 +229,11 @@ bool  Raven_SensoryMemory::isOpponentWithinFOV(Raven_Bot* pOpponent)const
 //-----------------------------------------------------------------------------
 Vector2D  Raven_SensoryMemory::GetLastRecordedPositionOfOpponent(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const int row = FindRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (row >= 0)
   {
-    return it->second.vLastSensedPosition;
+    return m_LastSensedPosition[row];
   }
 
   throw std::runtime_error("< Raven_SensoryMemory::GetLastRecordedPositionOfOpponent>: Attempting to get position of unrecorded bot");
@@ -215,11 +245,11 @@ Vector2D  Raven_SensoryMemory::GetLastRecordedPositionOfOpponent(Raven_Bot* pOpp
 //-----------------------------------------------------------------------------
 double  Raven_SensoryMemory::GetTimeOpponentHasBeenVisible(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const int row = FindRecord(pOpponent);
  
-  if (it != m_MemoryMap.end() && it->second.bWithinFOV)
+  if (row >= 0 && m_bWithinFOV[row])
   {
-    return Clock->GetCurrentTime() - it->second.fTimeBecameVisible;
+    return Clock->GetCurrentTime() - m_TimeBecameVisible[row];
   }
 
   return 0;
@@ -232,11 +262,11 @@ double  Raven_SensoryMemory::GetTimeOpponentHasBeenVisible(Raven_Bot* pOpponent)
 //-----------------------------------------------------------------------------
 double Raven_SensoryMemory::GetTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const int row = FindRecord(pOpponent);
  
-  if (it != m_MemoryMap.end())
+  if (row >= 0)
   {
-    return Clock->GetCurrentTime() - it->second.fTimeLastVisible;
+    return Clock->GetCurrentTime() - m_TimeLastVisible[row];
   }
 
   return MaxDouble;
@@ -248,11 +278,11 @@ double Raven_SensoryMemory::GetTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent
 //-----------------------------------------------------------------------------
 double  Raven_SensoryMemory::GetTimeSinceLastSensed(Raven_Bot* pOpponent)const
 {
-  MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
+  const int row = FindRecord(pOpponent);
  
-  if (it != m_MemoryMap.end() && it->second.bWithinFOV)
+  if (row >= 0 && m_bWithinFOV[row])
   {
-    return Clock->GetCurrentTime() - it->second.fTimeLastSensed;
+    return Clock->GetCurrentTime() - m_TimeLastSensed[row];
   }
 
   return 0;
@@ -264,9 +294,9 @@ double  Raven_SensoryMemory::GetTimeSinceLastSensed(Raven_Bot* pOpponent)const
 //-----------------------------------------------------------------------------
 void  Raven_SensoryMemory::RenderBoxesAroundRecentlySensed()const
 {
-  std::list<Raven_Bot*> opponents = GetListOfRecentlySensedOpponents();
-  std::list<Raven_Bot*>::const_iterator it;
-  for (it = opponents.begin(); it != opponents.end(); ++it)
+  RecentlySensedOpponents opponents = GetRecentlySensedOpponents();
+  RecentlySensedOpponents::const_iterator it = opponents.begin();
+  for (it; it != opponents.end(); ++it)
   {
     gdi->OrangePen();
     Vector2D p = (*it)->Pos();
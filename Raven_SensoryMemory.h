@@ -3,101 +3,161 @@
 #pragma warning (disable:4786)
 //-----------------------------------------------------------------------------
 //
-//  Name:
+//  Name:   Raven_SensoryMemory.h
 //
 //  Author: Mat Buckland (ai-junkie.com)
 //
-//  Desc:
+//  Desc:   a bot's memory of the opponents it has seen or heard. There is a
+//          row in the memory for each bot slot (see Raven_Bot::Slot) and
+//          each field of the rows is kept in an array of its own, so looking
+//          up an opponent is an index and scanning the memory for those
+//          sensed recently touches only the arrays it needs
 //
 //-----------------------------------------------------------------------------
-#include <map>
-#include <list>
-#include "2d/vector2d.h"
+#include <vector>
+#include "2D/Vector2D.h"
 
 class Raven_Bot;
 
 
-class MemoryRecord
+class Raven_SensoryMemory
 {
-public:
+private:
   
+  //the owner of this instance
+  Raven_Bot* m_pOwner;
+
+  //the opponent each row of the memory is about, or null if the row isn't
+  //in use. A row is made for an opponent the first time it is encountered
+  //(seen or heard) and is updated each time after
+  std::vector<Raven_Bot*>  m_Opponent;
+
   //records the time the opponent was last sensed (seen or heard). This
   //is used to determine if a bot can 'remember' this record or not. 
-  //(if CurrentTime() - m_dTimeLastSensed is greater than the bot's
+  //(if CurrentTime() - m_TimeLastSensed is greater than the bot's
   //memory span, the data in this record is made unavailable to clients)
-  double       fTimeLastSensed;
+  std::vector<double>      m_TimeLastSensed;
 
   //it can be useful to know how long an opponent has been visible. This 
   //variable is tagged with the current time whenever an opponent first becomes
   //visible. It's then a simple matter to calculate how long the opponent has
-  //been in view (CurrentTime - fTimeBecameVisible)
-  double       fTimeBecameVisible;
+  //been in view (CurrentTime - m_TimeBecameVisible)
+  std::vector<double>      m_TimeBecameVisible;
 
   //it can also be useful to know the last time an opponent was seen
-  double       fTimeLastVisible;
+  std::vector<double>      m_TimeLastVisible;
 
-  //a vector marking the position where the opponent was last sensed. This can
-  // be used to help hunt down an opponent if it goes out of view
-  Vector2D    vLastSensedPosition;
+  //the position where the opponent was last sensed. This can be used to
+  //help hunt down an opponent if it goes out of view
+  std::vector<Vector2D>    m_LastSensedPosition;
 
   //set to true if opponent is within the field of view of the owner
-  bool        bWithinFOV;
+  std::vector<bool>        m_bWithinFOV;
 
   //set to true if there is no obstruction between the opponent and the owner, 
   //permitting a shot.
-  bool        bShootable;
-  
-
-  MemoryRecord():fTimeLastSensed(-999),
-            fTimeBecameVisible(-999),
-            fTimeLastVisible(0),
-            bWithinFOV(false),
-            bShootable(false)
-  {}
-};
+  std::vector<bool>        m_bShootable;
 
+  //a bot has a memory span equivalent to this value. When a bot requests
+  //the opponents it has sensed recently this value is used to determine if 
+  //the bot is able to remember an opponent or not.
+  double      m_dMemorySpan;
 
+  //returns the row holding pOpponent, or -1 if there isn't one
+  int        FindRecord(Raven_Bot* pOpponent)const;
 
-class Raven_SensoryMemory
-{
-private:
-
-  typedef std::map<Raven_Bot*, MemoryRecord> MemoryMap;
-
-private:
-  
-  //the owner of this instance
-  Raven_Bot* m_pOwner;
+  //this methods checks to see if there is an existing record for pBot. If
+  //not a new record is made in the row for its slot. Returns the row.
+  //(called by UpdateWithSoundSource & UpdateVision)
+  int        MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pBot);
 
-  //this container is used to simulate memory of sensory events. A MemoryRecord
-  //is created for each opponent in the environment. Each record is updated 
-  //whenever the opponent is encountered. (when it is seen or heard)
-  MemoryMap  m_MemoryMap;
+  bool       isRecentlySensed(int row, double CurrentTime)const
+  {
+    return m_Opponent[row] && (CurrentTime - m_TimeLastSensed[row]) <= m_dMemorySpan;
+  }
 
-  //a bot has a memory span equivalent to this value. When a bot requests a 
-  //list of all recently sensed opponents this value is used to determine if 
-  //the bot is able to remember an opponent or not.
-  double      m_dMemorySpan;
+public:
 
-  //this methods checks to see if there is an existing record for pBot. If
-  //not a new MemoryRecord record is made and added to the memory map.(called
-  //by UpdateWithSoundSource & UpdateVision)
-  void       MakeNewRecordIfNotAlreadyPresent(Raven_Bot* pBot);
+  //a view of the opponents that have had their records updated within the
+  //last m_dMemorySpan seconds. It holds nothing of its own; stepping
+  //through it skips the rows of the memory that don't qualify
+  class RecentlySensedOpponents
+  {
+  private:
+
+    const Raven_SensoryMemory* m_pMemory;
+    double                     m_dCurrentTime;
+
+  public:
+
+    class const_iterator
+    {
+    private:
+
+      const Raven_SensoryMemory* m_pMemory;
+      double                     m_dCurrentTime;
+      int                        m_iRow;
+
+      void SkipToRecentlySensed()
+      {
+        while (m_iRow < (int)m_pMemory->m_Opponent.size() &&
+               !m_pMemory->isRecentlySensed(m_iRow, m_dCurrentTime))
+        {
+          ++m_iRow;
+        }
+      }
+
+    public:
+
+      const_iterator(const Raven_SensoryMemory* pMemory,
+                     double                     CurrentTime,
+                     int                        row):m_pMemory(pMemory),
+                                                     m_dCurrentTime(CurrentTime),
+                                                     m_iRow(row)
+      {
+        SkipToRecentlySensed();
+      }
+
+      Raven_Bot*      operator*()const{return m_pMemory->m_Opponent[m_iRow];}
+
+      const_iterator& operator++(){++m_iRow; SkipToRecentlySensed(); return *this;}
+
+      bool operator==(const const_iterator& rhs)const{return m_iRow == rhs.m_iRow;}
+      bool operator!=(const const_iterator& rhs)const{return m_iRow != rhs.m_iRow;}
+    };
+
+    RecentlySensedOpponents(const Raven_SensoryMemory* pMemory,
+                            double                     CurrentTime):m_pMemory(pMemory),
+                                                                    m_dCurrentTime(CurrentTime)
+    {}
+
+    const_iterator begin()const
+    {
+      return const_iterator(m_pMemory, m_dCurrentTime, 0);
+    }
+
+    const_iterator end()const
+    {
+      return const_iterator(m_pMemory, m_dCurrentTime, (int)m_pMemory->m_Opponent.size());
+    }
+  };
 
 public:
 
   Raven_SensoryMemory(Raven_Bot* owner, double MemorySpan);
 
-  //this method is used to update the memory map whenever an opponent makes
+  //this method is used to update the memory whenever an opponent makes
   //a noise
   void     UpdateWithSoundSource(Raven_Bot* pNoiseMaker);
 
   //this removes a bot's record from memory
   void     RemoveBotFromMemory(Raven_Bot* pBot);
 
-  //this method iterates through all the opponents in the game world and 
-  //updates the records of those that are in the owner's FOV
-  void     UpdateVision();
+  //these are called by the game's perception pass (see
+  //Raven_Game::UpdatePerception) to update the records of the opponents
+  //within view range of the owner, and then of those outside it
+  void     UpdateVisionOfOpponent(Raven_Bot* pOpponent, bool bLOSOkay);
+  void     UpdateOpponentsOutOfView(double ViewDistance);
 
   bool     isOpponentShootable(Raven_Bot* pOpponent)const;
   bool     isOpponentWithinFOV(Raven_Bot* pOpponent)const;
@@ -106,9 +166,9 @@ public:
   double    GetTimeSinceLastSensed(Raven_Bot* pOpponent)const;
   double    GetTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent)const;
 
-  //this method returns a list of all the opponents that have had their
-  //records updated within the last m_dMemorySpan seconds.
-  std::list<Raven_Bot*> GetListOfRecentlySensedOpponents()const;
+  //returns a view of all the opponents that have had their records updated
+  //within the last m_dMemorySpan seconds.
+  RecentlySensedOpponents GetRecentlySensedOpponents()const;
 
   void     RenderBoxesAroundRecentlySensed()const;
 
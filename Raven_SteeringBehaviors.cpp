@@ -1,11 +1,11 @@
 #include "Raven_SteeringBehaviors.h"
 #include "Raven_Bot.h"
-#include "2d/Wall2D.h"
-#include "2d/Transformations.h"
+#include "2D/Wall2D.h"
+#include "2D/Transformations.h"
 #include "misc/utils.h"
 #include "misc/Cgdi.h"
 #include "Raven_Game.h"
-#include "2d/geometry.h"
+#include "2D/geometry.h"
 #include "lua/Raven_Scriptor.h"
 #include "Raven_Map.h"
 
@@ -156,7 +156,7 @@ Vector2D Raven_Steering::CalculatePrioritized()
 
   if (On(wall_avoidance))
   {
-    force = WallAvoidance(m_pWorld->GetMap()->GetWalls()) *
+    force = WallAvoidance(m_pWorld->GetMap()->GetWallSpace()) *
             m_dWeightWallAvoidance;
 
     if (!AccumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
@@ -293,7 +293,7 @@ Vector2D Raven_Steering::Wander()
 //  This returns a steering force that will keep the agent away from any
 //  walls it may encounter
 //------------------------------------------------------------------------
-Vector2D Raven_Steering::WallAvoidance(const vector<Wall2D*> &walls)
+Vector2D Raven_Steering::WallAvoidance(const WallSpacePartition& walls)
 {
   //the feelers are contained in a std::vector, m_Feelers
   CreateFeelers();
@@ -301,8 +301,8 @@ Vector2D Raven_Steering::WallAvoidance(const vector<Wall2D*> &walls)
   double DistToThisIP    = 0.0;
   double DistToClosestIP = MaxDouble;
 
-  //this will hold an index into the vector of walls
-  int ClosestWall = -1;
+  //this will hold a pointer to the closest wall
+  const Wall2D* ClosestWall = NULL;
 
   Vector2D SteeringForce,
             point,         //used for storing temporary info
@@ -311,32 +311,30 @@ Vector2D Raven_Steering::WallAvoidance(const vector<Wall2D*> &walls)
   //examine each feeler in turn
   for (unsigned int flr=0; flr<m_Feelers.size(); ++flr)
   {
-    //run through each wall checking for any intersection points
-    for (unsigned int w=0; w<walls.size(); ++w)
+    //find the closest wall the feeler intersects, if any
+    const Wall2D* pWall = NULL;
+
+    if (walls.FindClosestIntersection(m_pRaven_Bot->Pos(),
+                                      m_Feelers[flr],
+                                      DistToThisIP,
+                                      point,
+                                      &pWall))
     {
-      if (LineIntersection2D(m_pRaven_Bot->Pos(),
-                             m_Feelers[flr],
-                             walls[w]->From(),
-                             walls[w]->To(),
-                             DistToThisIP,
-                             point))
+      //is this the closest found so far? If so keep a record
+      if (DistToThisIP < DistToClosestIP)
       {
-        //is this the closest found so far? If so keep a record
-        if (DistToThisIP < DistToClosestIP)
-        {
-          DistToClosestIP = DistToThisIP;
+        DistToClosestIP = DistToThisIP;
 
-          ClosestWall = w;
+        ClosestWall = pWall;
 
-          ClosestPoint = point;
-        }
+        ClosestPoint = point;
       }
-    }//next wall
+    }
 
   
     //if an intersection point has been detected, calculate a force  
     //that will direct the agent away
-    if (ClosestWall >=0)
+    if (ClosestWall)
     {
       //calculate by what distance the projected position of the agent
       //will overshoot the wall
@@ -344,7 +342,7 @@ Vector2D Raven_Steering::WallAvoidance(const vector<Wall2D*> &walls)
 
       //create a force in the direction of the wall normal, with a 
       //magnitude of the overshoot
-      SteeringForce = walls[ClosestWall]->Normal() * OverShoot.Length();
+      SteeringForce = ClosestWall->Normal() * OverShoot.Length();
     }
 
   }//next feeler
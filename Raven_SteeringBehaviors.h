@@ -11,14 +11,14 @@
 //
 //------------------------------------------------------------------------
 #include <vector>
-#include <windows.h>
 #include <string>
 #include <list>
-#include "2d/Vector2D.h"
+#include "2D/Vector2D.h"
 #include "constants.h"
 
 class Raven_Bot;
 class Wall2D;
+class WallSpacePartition;
 class BaseGameEntity;
 class Raven_Game;
 
@@ -157,7 +157,7 @@ private:
 
   //this returns a steering force which will keep the agent away from any
   //walls it may encounter
-  Vector2D WallAvoidance(const std::vector<Wall2D*> &walls);
+  Vector2D WallAvoidance(const WallSpacePartition& walls);
 
   
   Vector2D Separation(const std::list<Raven_Bot*> &agents);
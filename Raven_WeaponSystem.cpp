@@ -9,7 +9,7 @@
 #include "lua/Raven_Scriptor.h"
 #include "Raven_Game.h"
 #include "Raven_UserOptions.h"
-#include "2D/transformations.h"
+#include "2D/Transformations.h"
 #include "misc/Stream_Utility_Functions.h"
 
 
@@ -264,44 +264,44 @@ void Raven_WeaponSystem::InitializeFuzzyModule()
 {
 	// The shooter deviates its aim accordingly to this fuzzy variable.
 	FuzzyVariable& AimDeviation = m_FuzzyModule.CreateFLV("AimDeviation");
-	FzSet& ExtraFarLeftAD = AimDeviation.AddLeftShoulderSet("ExtraFarLeftAD", DegsToRads(-90), DegsToRads(-30), DegsToRads(-20));
-	FzSet& VeryFarLeftAD = AimDeviation.AddTriangularSet("VeryFarLeftAD", DegsToRads(-30), DegsToRads(-20), DegsToRads(-15));
-	FzSet& FarLeftAD = AimDeviation.AddTriangularSet("FarLeftAD", DegsToRads(-20), DegsToRads(-15), DegsToRads(-5));
-	FzSet& LeftAD = AimDeviation.AddTriangularSet("LeftAD", DegsToRads(-15), DegsToRads(-5), DegsToRads(0));
-	FzSet& CenterAD = AimDeviation.AddTriangularSet("CenterAD", DegsToRads(-5), DegsToRads(0), DegsToRads(5));
-	FzSet& RightAD = AimDeviation.AddTriangularSet("RightAD", DegsToRads(0), DegsToRads(5), DegsToRads(15));
-	FzSet& FarRightAD = AimDeviation.AddTriangularSet("FarRightAD", DegsToRads(5), DegsToRads(15), DegsToRads(20));
-	FzSet& VeryFarRightAD = AimDeviation.AddTriangularSet("VeryFarRightAD", DegsToRads(15), DegsToRads(20), DegsToRads(30));
-	FzSet& ExtraFarRightAD = AimDeviation.AddRightShoulderSet("ExtraFarRightAD", DegsToRads(20), DegsToRads(30), DegsToRads(90));
+	FzSet ExtraFarLeftAD = AimDeviation.AddLeftShoulderSet("ExtraFarLeftAD", DegsToRads(-90), DegsToRads(-30), DegsToRads(-20));
+	FzSet VeryFarLeftAD = AimDeviation.AddTriangularSet("VeryFarLeftAD", DegsToRads(-30), DegsToRads(-20), DegsToRads(-15));
+	FzSet FarLeftAD = AimDeviation.AddTriangularSet("FarLeftAD", DegsToRads(-20), DegsToRads(-15), DegsToRads(-5));
+	FzSet LeftAD = AimDeviation.AddTriangularSet("LeftAD", DegsToRads(-15), DegsToRads(-5), DegsToRads(0));
+	FzSet CenterAD = AimDeviation.AddTriangularSet("CenterAD", DegsToRads(-5), DegsToRads(0), DegsToRads(5));
+	FzSet RightAD = AimDeviation.AddTriangularSet("RightAD", DegsToRads(0), DegsToRads(5), DegsToRads(15));
+	FzSet FarRightAD = AimDeviation.AddTriangularSet("FarRightAD", DegsToRads(5), DegsToRads(15), DegsToRads(20));
+	FzSet VeryFarRightAD = AimDeviation.AddTriangularSet("VeryFarRightAD", DegsToRads(15), DegsToRads(20), DegsToRads(30));
+	FzSet ExtraFarRightAD = AimDeviation.AddRightShoulderSet("ExtraFarRightAD", DegsToRads(20), DegsToRads(30), DegsToRads(90));
 
 	// Distance between the shooter and its target.
 	// In order to avoid too much complexity, the Medium and Far variables are used the same way.
 	FuzzyVariable& DistToTarget = m_FuzzyModule.CreateFLV("DistToTarget");
-	FzSet& TargetClose = DistToTarget.AddLeftShoulderSet("TargetClose", 0, 25, 150);
-	FzSet& TargetMedium = DistToTarget.AddTriangularSet("TargetMedium", 25, 150, 300);
-	FzSet& TargetFar = DistToTarget.AddRightShoulderSet("TargetFar", 150, 300, 1000);
+	FzSet TargetClose = DistToTarget.AddLeftShoulderSet("TargetClose", 0, 25, 150);
+	FzSet TargetMedium = DistToTarget.AddTriangularSet("TargetMedium", 25, 150, 300);
+	FzSet TargetFar = DistToTarget.AddRightShoulderSet("TargetFar", 150, 300, 1000);
 
 	// The speed of the target should stay between 0 and the max value defined in Params.ini
 	// We can assume that it will never be greater than 100.
 	// In order to avoid too much complexity, we only define 2 sets.
 	FuzzyVariable& TargetSpeed = m_FuzzyModule.CreateFLV("TargetSpeed");
-	FzSet& TargetSlow = TargetSpeed.AddLeftShoulderSet("TargetSlow", 0.0, 0.25, 0.75);
-	FzSet& TargetFast = TargetSpeed.AddRightShoulderSet("TargetFast", 0.25, 0.75, 100.0);
+	FzSet TargetSlow = TargetSpeed.AddLeftShoulderSet("TargetSlow", 0.0, 0.25, 0.75);
+	FzSet TargetFast = TargetSpeed.AddRightShoulderSet("TargetFast", 0.25, 0.75, 100.0);
 
 	// After 3 seconds watching its target, the shooter starts to aim better.
 	// We can assume that an ennemy will never stay visible or and alive more than 10min.
 	// In order to avoid too much complexity, we only define 2 sets.
 	FuzzyVariable& VisibilityDuration = m_FuzzyModule.CreateFLV("VisibilityDuration");
-	FzSet& ShortPeriod = VisibilityDuration.AddLeftShoulderSet("ShortPeriod", 0, 0, 3);
-	FzSet& LongPeriod = VisibilityDuration.AddRightShoulderSet("LongPeriod", 0, 3, 600);
+	FzSet ShortPeriod = VisibilityDuration.AddLeftShoulderSet("ShortPeriod", 0, 0, 3);
+	FzSet LongPeriod = VisibilityDuration.AddRightShoulderSet("LongPeriod", 0, 3, 600);
 
 	// Represents the target's heading angle relatively to the shooter's angle of view.
 	// In order to be certain that the angle stays in the bounds, we add an extra-degree to them.
 	// If the angle is small enough, the target's heading is parallel to the shooter's angle of view : it can just shoot forward without anticipating.
 	FuzzyVariable& TargetHeading = m_FuzzyModule.CreateFLV("TargetHeading");
-	FzSet& LeftTH = TargetHeading.AddLeftShoulderSet("LeftTH", DegsToRads(-91), DegsToRads(-5), DegsToRads(0));
-	FzSet& CenterTH = TargetHeading.AddTriangularSet("CenterTH", DegsToRads(-5), DegsToRads(0), DegsToRads(5));
-	FzSet& RightTH = TargetHeading.AddRightShoulderSet("RightTH", DegsToRads(0), DegsToRads(5), DegsToRads(91));
+	FzSet LeftTH = TargetHeading.AddLeftShoulderSet("LeftTH", DegsToRads(-91), DegsToRads(-5), DegsToRads(0));
+	FzSet CenterTH = TargetHeading.AddTriangularSet("CenterTH", DegsToRads(-5), DegsToRads(0), DegsToRads(5));
+	FzSet RightTH = TargetHeading.AddRightShoulderSet("RightTH", DegsToRads(0), DegsToRads(5), DegsToRads(91));
 
 
 
@@ -12,8 +12,8 @@
 //
 //-----------------------------------------------------------------------------
 #include <map>
-#include "2d/vector2d.h"
-#include "Fuzzy/FuzzyModule.h"
+#include "2D/Vector2D.h"
+#include "fuzzy/FuzzyModule.h"
 
 class Raven_Bot;
 class Raven_Weapon;
@@ -1,12 +1,11 @@
 #include "Projectile_Grenade.h"
 #include "../lua/Raven_Scriptor.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 #include "../Raven_Bot.h"
 #include "../Raven_Game.h"
 #include "../constants.h"
-#include "2d/WallIntersectionTests.h"
+#include "2D/WallIntersectionTests.h"
 #include "../Raven_Map.h"
-#include "Time/PrecisionTimer.h"
 
 #include "../Raven_Messages.h"
 #include "Messaging/MessageDispatcher.h"
@@ -91,7 +90,7 @@ void Grenade::TestForImpact()
 		m_vPosition,
 		dist,
 		m_vImpactPoint,
-		m_pWorld->GetMap()->GetWalls()))
+		m_pWorld->GetMap()->GetWallSpace()))
 	{
 		m_bImpacted = true;
 
@@ -121,17 +120,20 @@ void Grenade::TestForImpact()
 //-----------------------------------------------------------------------------
 void Grenade::InflictDamageOnBotsWithinBlastRadius()
 {
-  std::list<Raven_Bot*>::const_iterator curBot = m_pWorld->GetAllBots().begin();
+  //only the bots in the cells within reach of the blast need be checked
+  Raven_Game::BotCellSpace* pBots = m_pWorld->GetBotCellSpace();
 
-  for (curBot; curBot != m_pWorld->GetAllBots().end(); ++curBot)
+  pBots->CalculateNeighbors(Pos(), m_dBlastRadius + m_pWorld->GetLargestBotRadius());
+
+  for (Raven_Bot* pBot = pBots->begin(); !pBots->end(); pBot = pBots->next())
   {
-    if (Vec2DDistance(Pos(), (*curBot)->Pos()) < m_dBlastRadius + (*curBot)->BRadius())
+    if (Vec2DDistance(Pos(), pBot->Pos()) < m_dBlastRadius + pBot->BRadius())
     {
       //send a message to the bot to let it know it's been hit, and who the
       //shot came from
       Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
                               m_iShooterID,
-                              (*curBot)->ID(),
+                              pBot->ID(),
                               Msg_TakeThatMF,
                               (void*)&m_iDamageInflicted);
 
@@ -1,10 +1,10 @@
 #include "Projectile_Slug.h"
 #include "../lua/Raven_Scriptor.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 #include "../Raven_Bot.h"
 #include "../Raven_Game.h"
-#include "game/EntityFunctionTemplates.h"
-#include "2d/WallIntersectionTests.h"
+#include "Game/EntityFunctionTemplates.h"
+#include "2D/WallIntersectionTests.h"
 #include "../Raven_Map.h"
 
 #include "../Raven_Messages.h"
@@ -78,7 +78,7 @@ void Slug::TestForImpact()
                                           m_vPosition,
                                           DistToClosestImpact,
                                           m_vImpactPoint,
-                                          m_pWorld->GetMap()->GetWalls());
+                                          m_pWorld->GetMap()->GetWallSpace());
 
   //test to see if the ray between the current position of the slug and 
   //the start position intersects with any bots.
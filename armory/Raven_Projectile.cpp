@@ -10,26 +10,27 @@ Raven_Bot* Raven_Projectile::GetClosestIntersectingBot(Vector2D    From,
   Raven_Bot* ClosestIntersectingBot = 0;
   double ClosestSoFar = MaxDouble;
 
-  //iterate through all entities checking against the line segment FromTo
-  std::list<Raven_Bot*>::const_iterator curBot;
-  for (curBot =  m_pWorld->GetAllBots().begin();
-       curBot != m_pWorld->GetAllBots().end();
-       ++curBot)
+  //only the bots in the cells near the line segment FromTo need be checked
+  Raven_Game::BotCellSpace* pBots = m_pWorld->GetBotCellSpace();
+
+  pBots->CalculateNeighborsOfSegment(From, To, m_pWorld->GetLargestBotRadius());
+
+  for (Raven_Bot* pBot = pBots->begin(); !pBots->end(); pBot = pBots->next())
   {
     //make sure we don't check against the shooter of the projectile
-    if ( ((*curBot)->ID() != m_iShooterID))
+    if ( (pBot->ID() != m_iShooterID))
     {
       //if the distance to FromTo is less than the entity's bounding radius then
       //there is an intersection
-      if (DistToLineSegment(From, To, (*curBot)->Pos()) < (*curBot)->BRadius())
+      if (DistToLineSegment(From, To, pBot->Pos()) < pBot->BRadius())
       {
         //test to see if this is the closest so far
-        double Dist = Vec2DDistanceSq((*curBot)->Pos(), m_vOrigin);
+        double Dist = Vec2DDistanceSq(pBot->Pos(), m_vOrigin);
 
         if (Dist < ClosestSoFar)
         {
-          Dist = ClosestSoFar;
-          ClosestIntersectingBot = *curBot;
+          ClosestSoFar = Dist;
+          ClosestIntersectingBot = pBot;
         }
       }
     }
@@ -47,20 +48,21 @@ std::list<Raven_Bot*> Raven_Projectile::GetListOfIntersectingBots(Vector2D From,
   //this will hold any bots that are intersecting with the line segment
   std::list<Raven_Bot*> hits;
 
-  //iterate through all entities checking against the line segment FromTo
-  std::list<Raven_Bot*>::const_iterator curBot;
-  for (curBot =  m_pWorld->GetAllBots().begin();
-       curBot != m_pWorld->GetAllBots().end();
-       ++curBot)
+  //only the bots in the cells near the line segment FromTo need be checked
+  Raven_Game::BotCellSpace* pBots = m_pWorld->GetBotCellSpace();
+
+  pBots->CalculateNeighborsOfSegment(From, To, m_pWorld->GetLargestBotRadius());
+
+  for (Raven_Bot* pBot = pBots->begin(); !pBots->end(); pBot = pBots->next())
   {
     //make sure we don't check against the shooter of the projectile
-    if ( ((*curBot)->ID() != m_iShooterID))
+    if ( (pBot->ID() != m_iShooterID))
     {
       //if the distance to FromTo is less than the entities bounding radius then
       //there is an intersection so add it to hits
-      if (DistToLineSegment(From, To, (*curBot)->Pos()) < (*curBot)->BRadius())
+      if (DistToLineSegment(From, To, pBot->Pos()) < pBot->BRadius())
       {
-        hits.push_back(*curBot);
+        hits.push_back(pBot);
       }
     }
 
@@ -58,7 +58,7 @@ inline void GrenadeLauncher::ShootAt(Vector2D pos)
 
 		//add a trigger to the game so that the other bots can hear this shot
 		//(provided they are within range)
-		m_pOwner->GetWorld()->GetMap()->AddSoundTrigger(m_pOwner, script->GetDouble("GrenadeLauncher_SoundRange"));
+		m_pOwner->GetWorld()->AddSound(m_pOwner, script->GetDouble("GrenadeLauncher_SoundRange"));
 	}
 }
 
@@ -90,25 +90,25 @@ double GrenadeLauncher::GetDesirability(double DistToTarget)
 void GrenadeLauncher::InitializeFuzzyModule()
 {
 	FuzzyVariable& DistToTarget = m_FuzzyModule.CreateFLV("DistToTarget");
-	FzSet& Target_VeryClose = DistToTarget.AddLeftShoulderSet("Target_VeryClose", 0, 25, 150);
-	FzSet& Target_Close = DistToTarget.AddLeftShoulderSet("Target_Close", 15, 90, 225);
-	FzSet& Target_Medium = DistToTarget.AddTriangularSet("Target_Medium", 25, 150, 300);
-	FzSet& Target_Far = DistToTarget.AddRightShoulderSet("Target_Far", 90, 225, 750);
-	FzSet& Target_VeryFar = DistToTarget.AddRightShoulderSet("Target_VeryFar", 150, 300, 1000);
+	FzSet Target_VeryClose = DistToTarget.AddLeftShoulderSet("Target_VeryClose", 0, 25, 150);
+	FzSet Target_Close = DistToTarget.AddLeftShoulderSet("Target_Close", 15, 90, 225);
+	FzSet Target_Medium = DistToTarget.AddTriangularSet("Target_Medium", 25, 150, 300);
+	FzSet Target_Far = DistToTarget.AddRightShoulderSet("Target_Far", 90, 225, 750);
+	FzSet Target_VeryFar = DistToTarget.AddRightShoulderSet("Target_VeryFar", 150, 300, 1000);
 
 	FuzzyVariable& Desirability = m_FuzzyModule.CreateFLV("Desirability");
-	FzSet& VeryDesirable = Desirability.AddRightShoulderSet("VeryDesirable", 50, 75, 100);
-	FzSet& MoreDesirable = Desirability.AddRightShoulderSet("MoreDesirable", 37, 62, 87);
-	FzSet& Desirable = Desirability.AddTriangularSet("Desirable", 25, 50, 75);
-	FzSet& LessDesirable = Desirability.AddLeftShoulderSet("LessDesirable", 12, 37, 62);
-	FzSet& Undesirable = Desirability.AddLeftShoulderSet("Undesirable", 0, 25, 50);
+	FzSet VeryDesirable = Desirability.AddRightShoulderSet("VeryDesirable", 50, 75, 100);
+	FzSet MoreDesirable = Desirability.AddRightShoulderSet("MoreDesirable", 37, 62, 87);
+	FzSet Desirable = Desirability.AddTriangularSet("Desirable", 25, 50, 75);
+	FzSet LessDesirable = Desirability.AddLeftShoulderSet("LessDesirable", 12, 37, 62);
+	FzSet Undesirable = Desirability.AddLeftShoulderSet("Undesirable", 0, 25, 50);
 
 	FuzzyVariable& AmmoStatus = m_FuzzyModule.CreateFLV("AmmoStatus");
-	FzSet& Ammo_Loads = AmmoStatus.AddRightShoulderSet("Ammo_Loads", 10, 30, 100);
-	FzSet& Ammo_Good = AmmoStatus.AddRightShoulderSet("Ammo_Good", 5, 20, 65);
-	FzSet& Ammo_Okay = AmmoStatus.AddTriangularSet("Ammo_Okay", 0, 10, 30);
-	FzSet& Ammo_Low = AmmoStatus.AddTriangularSet("Ammo_Low", 0, 5, 20);
-	FzSet& Ammo_VeryLow = AmmoStatus.AddTriangularSet("Ammo_VeryLow", 0, 0, 10);
+	FzSet Ammo_Loads = AmmoStatus.AddRightShoulderSet("Ammo_Loads", 10, 30, 100);
+	FzSet Ammo_Good = AmmoStatus.AddRightShoulderSet("Ammo_Good", 5, 20, 65);
+	FzSet Ammo_Okay = AmmoStatus.AddTriangularSet("Ammo_Okay", 0, 10, 30);
+	FzSet Ammo_Low = AmmoStatus.AddTriangularSet("Ammo_Low", 0, 5, 20);
+	FzSet Ammo_VeryLow = AmmoStatus.AddTriangularSet("Ammo_VeryLow", 0, 0, 10);
 
 	m_FuzzyModule.AddRule(FzAND(Target_VeryClose, Ammo_Loads), Undesirable);
 	m_FuzzyModule.AddRule(FzAND(Target_VeryClose, Ammo_Good), Undesirable);
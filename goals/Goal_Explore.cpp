@@ -4,7 +4,7 @@
 #include "../Raven_Game.h"
 #include "../Raven_Map.h"
 #include "Messaging/Telegram.h"
-#include "..\Raven_Messages.h"
+#include "../Raven_Messages.h"
 
 #include "Goal_SeekToPosition.h"
 #include "Goal_FollowPath.h"
@@ -29,8 +29,10 @@ void Goal_Explore::Activate()
     m_bDestinationIsSet = true;
   }
 
-  //and request a path to that position
-  m_pOwner->GetPathPlanner()->RequestPathToPosition(m_CurrentDestination);
+  //and request a path to that position. Exploring is never urgent so the
+  //search can wait for those of bots with more pressing needs
+  m_pOwner->GetPathPlanner()->RequestPathToPosition(m_CurrentDestination,
+                                                    search_priority_low);
 
   //the bot may have to wait a few update cycles before a path is calculated
   //so for appearances sake it simple ARRIVES at the destination until a path
@@ -65,12 +67,17 @@ bool Goal_Explore::HandleMessage(const Telegram& msg)
     switch(msg.Msg)
     {
     case Msg_PathReady:
+      {
+        //clear any existing goals
+        RemoveAllSubgoals();
 
-      //clear any existing goals
-      RemoveAllSubgoals();
+        //a long path may be handed over a stretch at a time
+        Raven_PathPlanner::PathRemainder remainder;
 
-      AddSubgoal(new Goal_FollowPath(m_pOwner,
-                                     m_pOwner->GetPathPlanner()->GetPath()));
+        Raven_PathPlanner::Path path = m_pOwner->GetPathPlanner()->GetPath(&remainder);
+
+        AddSubgoal(new Goal_FollowPath(m_pOwner, path, remainder));
+      }
 
       return true; //msg handled
 
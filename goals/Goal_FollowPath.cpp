@@ -4,16 +4,18 @@
 
 #include "Goal_TraverseEdge.h"
 #include "Goal_NegotiateDoor.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 
 
 
 //------------------------------ ctor -----------------------------------------
 //-----------------------------------------------------------------------------
 Goal_FollowPath::
-Goal_FollowPath(Raven_Bot*          pBot,
-                std::list<PathEdge> path):Goal_Composite<Raven_Bot>(pBot, goal_follow_path),
-                                                  m_Path(path)
+Goal_FollowPath(Raven_Bot*                              pBot,
+                std::list<PathEdge>                     path,
+                const Raven_PathPlanner::PathRemainder& remainder):Goal_Composite<Raven_Bot>(pBot, goal_follow_path),
+                                                                   m_Path(path),
+                                                                   m_Remainder(remainder)
 {
 }
 
@@ -23,7 +25,23 @@ Goal_FollowPath(Raven_Bot*          pBot,
 void Goal_FollowPath::Activate()
 {
   m_iStatus = active;
-  
+
+  //refine the next stretch of the path before the bot reaches the end of
+  //this one, so the edge it is about to follow is only flagged as the last
+  //if it really is
+  while (m_Path.size() < 2 && !m_Remainder.empty())
+  {
+    m_pOwner->GetPathPlanner()->ExtendPath(m_Remainder, m_Path);
+  }
+
+  //the rest of the path couldn't be worked out so the bot must plan again
+  if (m_Remainder.failed())
+  {
+    m_iStatus = failed;
+
+    return;
+  }
+
   //get a reference to the next edge
   PathEdge edge = m_Path.front();
 
@@ -83,7 +101,7 @@ int Goal_FollowPath::Process()
 
   //if there are no subgoals present check to see if the path still has edges.
   //remaining. If it does then call activate to grab the next edge.
-  if (m_iStatus == completed && !m_Path.empty())
+  if (m_iStatus == completed && (!m_Path.empty() || !m_Remainder.empty()))
   {
     Activate(); 
   }
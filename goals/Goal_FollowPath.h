@@ -24,9 +24,14 @@ private:
   //a local copy of the path returned by the path planner
   std::list<PathEdge>  m_Path;
 
+  //the rest of the path, if the planner only refined the first stretch of it
+  Raven_PathPlanner::PathRemainder  m_Remainder;
+
 public:
 
-  Goal_FollowPath(Raven_Bot* pBot, std::list<PathEdge> path);
+  Goal_FollowPath(Raven_Bot*                              pBot,
+                  std::list<PathEdge>                     path,
+                  const Raven_PathPlanner::PathRemainder& remainder = Raven_PathPlanner::PathRemainder());
 
   //the usual suspects
   void Activate();
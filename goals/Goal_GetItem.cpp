@@ -4,7 +4,7 @@
 #include "../navigation/Raven_PathPlanner.h"
 
 #include "Messaging/Telegram.h"
-#include "..\Raven_Messages.h"
+#include "../Raven_Messages.h"
 
 #include "Goal_Wander.h"
 #include "Goal_DodgeFollowingPath.h"
@@ -47,8 +47,12 @@ void Goal_GetItem::Activate()
   
   m_pGiverTrigger = 0;
   
-  //request a path to the item
-  m_pOwner->GetPathPlanner()->RequestPathToItem(m_iItemToGet);
+  //request a path to the item. A bot after health is most likely fleeing
+  //so its search is put ahead of the others
+  m_pOwner->GetPathPlanner()->RequestPathToItem(m_iItemToGet,
+                                                m_iItemToGet == type_health ?
+                                                search_priority_high :
+                                                search_priority_normal);
 
   //the bot may have to wait a few update cycles before a path is calculated
   //so for appearances sake it just wanders
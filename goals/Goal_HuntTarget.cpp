@@ -1,13 +1,13 @@
 #include "Goal_HuntTarget.h"
 #include "Goal_Explore.h"
 #include "Goal_MoveToPosition.h"
-#include "..\Raven_Bot.h"
-#include "..\Raven_SteeringBehaviors.h"
+#include "../Raven_Bot.h"
+#include "../Raven_SteeringBehaviors.h"
 
 
 
-#include "debug/DebugConsole.h"
-#include "misc/cgdi.h"
+#include "Debug/DebugConsole.h"
+#include "misc/Cgdi.h"
 
 //---------------------------- Initialize -------------------------------------
 //-----------------------------------------------------------------------------  
@@ -37,7 +37,7 @@ void Goal_HuntTarget::Activate()
     //else move to the LRP
     else
     {
-      AddSubgoal(new Goal_MoveToPosition(m_pOwner, lrp));
+      AddSubgoal(new Goal_MoveToPosition(m_pOwner, lrp, search_priority_high));
     }
   }
 
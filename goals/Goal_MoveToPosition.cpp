@@ -4,7 +4,7 @@
 #include "../navigation/Raven_PathPlanner.h"
 #include "Messaging/Telegram.h"
 #include "../Raven_Messages.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 
 #include "Goal_SeekToPosition.h"
 #include "Goal_FollowPath.h"
@@ -26,7 +26,7 @@ void Goal_MoveToPosition::Activate()
   //before a path is calculated. Consequently, for appearances sake, it just
   //seeks directly to the target position whilst it's awaiting notification
   //that the path planning request has succeeded/failed
-  if (m_pOwner->GetPathPlanner()->RequestPathToPosition(m_vDestination))
+  if (m_pOwner->GetPathPlanner()->RequestPathToPosition(m_vDestination, m_iSearchPriority))
   {
     AddSubgoal(new Goal_SeekToPosition(m_pOwner, m_vDestination));
   }
@@ -61,12 +61,17 @@ bool Goal_MoveToPosition::HandleMessage(const Telegram& msg)
     switch(msg.Msg)
     {
     case Msg_PathReady:
+      {
+        //clear any existing goals
+        RemoveAllSubgoals();
 
-      //clear any existing goals
-      RemoveAllSubgoals();
+        //a long path may be handed over a stretch at a time
+        Raven_PathPlanner::PathRemainder remainder;
 
-      AddSubgoal(new Goal_FollowPath(m_pOwner,
-                                     m_pOwner->GetPathPlanner()->GetPath()));
+        Raven_PathPlanner::Path path = m_pOwner->GetPathPlanner()->GetPath(&remainder);
+
+        AddSubgoal(new Goal_FollowPath(m_pOwner, path, remainder));
+      }
 
       return true; //msg handled
 
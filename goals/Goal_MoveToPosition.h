@@ -6,6 +6,7 @@
 #include "2D/Vector2D.h"
 #include "../Raven_Bot.h"
 #include "Raven_Goal_Types.h"
+#include "../navigation/PathManager.h"
 
 
 
@@ -16,14 +17,19 @@ private:
   //the position the bot wants to reach
   Vector2D m_vDestination;
 
+  //the priority the path to it is requested with
+  int      m_iSearchPriority;
+
 public:
 
   Goal_MoveToPosition(Raven_Bot* pBot,
-                      Vector2D   pos):
+                      Vector2D   pos,
+                      int        SearchPriority = search_priority_normal):
   
             Goal_Composite<Raven_Bot>(pBot,
                                       goal_move_to_position),
-            m_vDestination(pos)
+            m_vDestination(pos),
+            m_iSearchPriority(SearchPriority)
   {}
 
  //the usual suspects
@@ -1,13 +1,13 @@
 #include "Goal_SeekToPosition.h"
-#include "..\Raven_Bot.h"
-#include "..\Raven_SteeringBehaviors.h"
-#include "time/CrudeTimer.h"
+#include "../Raven_Bot.h"
+#include "../Raven_SteeringBehaviors.h"
+#include "Time/CrudeTimer.h"
 #include "../navigation/Raven_PathPlanner.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 
 
 
-#include "debug/DebugConsole.h"
+#include "Debug/DebugConsole.h"
 
 
 
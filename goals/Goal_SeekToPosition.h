@@ -3,7 +3,7 @@
 #pragma warning (disable:4786)
 
 #include "Goals/Goal.h"
-#include "2d/Vector2D.h"
+#include "2D/Vector2D.h"
 #include "Raven_Goal_Types.h"
 #include "../Raven_Bot.h"
 
@@ -1,15 +1,15 @@
 #include "Goal_TraverseEdge.h"
-#include "..\Raven_Bot.h"
+#include "../Raven_Bot.h"
 #include "Raven_Goal_Types.h"
-#include "..\Raven_SteeringBehaviors.h"
-#include "time/CrudeTimer.h"
-#include "..\constants.h"
+#include "../Raven_SteeringBehaviors.h"
+#include "Time/CrudeTimer.h"
+#include "../constants.h"
 #include "../navigation/Raven_PathPlanner.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 #include "../lua/Raven_Scriptor.h"
 
 
-#include "debug/DebugConsole.h"
+#include "Debug/DebugConsole.h"
 
 
 
@@ -4,10 +4,10 @@
 #include "constants.h"
 #include "misc/utils.h"
 #include "Time/PrecisionTimer.h"
-#include "Resource.h"
-#include "misc/windowutils.h"
+#include "resource.h"
+#include "misc/WindowUtils.h"
 #include "misc/Cgdi.h"
-#include "debug/DebugConsole.h"
+#include "Debug/DebugConsole.h"
 #include "Raven_UserOptions.h"
 #include "Raven_Game.h"
 #include "lua/Raven_Scriptor.h"
@@ -71,8 +71,16 @@ LRESULT CALLBACK WindowProc (HWND   hwnd,
 			   cxClient = rect.right;
 			   cyClient = rect.bottom;
 
-         //seed random number generator
-         srand((unsigned) time(NULL));
+         //seed random number generator. A non zero seed in Params.ini
+         //makes every run play out the same way
+         if (script->GetInt("RandomSeed"))
+         {
+           srand((unsigned) script->GetInt("RandomSeed"));
+         }
+         else
+         {
+           srand((unsigned) time(NULL));
+         }
 
          
          //---------------create a surface to render to(backbuffer)
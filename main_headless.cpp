@@ -0,0 +1,174 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   main_headless.cpp
+//
+//  Desc:   entry point for the headless (render free) build of Raven. There
+//          is no window, no GDI and no debug console. The game is updated in
+//          a tight loop with the clock advancing by a fixed step each
+//          update, so a match runs as fast as the CPU allows instead of
+//          being capped by the FrameRate wall clock.
+//
+//          usage: Raven_Headless [NumUpdates] [MapFile] [RandomSeed]
+//
+//          An empty MapFile ("") keeps the StartMap from Params.ini.
+//          If no seed is given the RandomSeed value in Params.ini is used.
+//          Two runs with the same seed produce the same match.
+//
+//          When the run is finished the number of updates per second, the
+//          size of the navgraph and whether it is searched as a grid or
+//          through a hierarchy, the timings of the path planning searches
+//          of each priority (in updates), the path cache hit rate, the
+//          number of times the item flow fields were calculated, how often
+//          the closest node to a position couldn't be looked up, how many
+//          shortcuts path smoothing had to sweep, during the match and to
+//          fill in its table when the map was loaded, and the score of each
+//          bot are written to stdout.
+//
+//          None of the DM1 maps has a navgraph laid out as a regular grid.
+//          maps/gridDM1.map has DM1's walls with a grid navgraph and no
+//          items, so its paths are found with jump point search:
+//
+//            Raven_Headless 36000 maps/gridDM1.map 42
+//
+//          maps/fineGridDM1.map is the same with a finer grid. Its navgraph
+//          has more than MinNodesForHierarchicalPaths nodes, so long paths
+//          are planned through the hierarchy as well:
+//
+//            Raven_Headless 36000 maps/fineGridDM1.map 42
+//-----------------------------------------------------------------------------
+#include <ctime>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "constants.h"
+#include "misc/utils.h"
+#include "Time/CrudeTimer.h"
+#include "Raven_Game.h"
+#include "Raven_Bot.h"
+#include "navigation/Raven_PathPlanner.h"
+#include "navigation/Raven_PathCache.h"
+#include "navigation/Raven_ItemFlowFields.h"
+#include "navigation/Raven_ClosestNodeRaster.h"
+#include "navigation/Raven_PathSmoother.h"
+#include "lua/Raven_Scriptor.h"
+
+
+//the number of updates the simulation runs for if none is specified
+const long DefaultNumUpdates = 60 * FrameRate;
+
+
+int main(int argc, char* argv[])
+{
+  long NumUpdates = DefaultNumUpdates;
+
+  if (argc > 1)
+  {
+    NumUpdates = std::atol(argv[1]);
+  }
+
+  //seed random number generator
+  unsigned Seed = (unsigned) script->GetInt("RandomSeed");
+
+  if (argc > 3)
+  {
+    Seed = (unsigned) std::strtoul(argv[3], NULL, 10);
+  }
+
+  if (Seed == 0)
+  {
+    Seed = (unsigned) time(NULL);
+  }
+
+  srand(Seed);
+
+  Raven_Game* pRaven = NULL;
+
+  try
+  {
+    //create the game. This loads the default map
+    pRaven = new Raven_Game();
+
+    if (argc > 2 && argv[2][0] != '\0' && !pRaven->LoadMap(argv[2]))
+    {
+      delete pRaven;
+      return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (long update=0; update<NumUpdates; ++update)
+    {
+      pRaven->Update();
+    }
+
+    double WallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "seed:           " << Seed << "\n"
+              << "updates:        " << NumUpdates << "\n"
+              << "simulated time: " << Clock->GetCurrentTime() << "s\n"
+              << "wall time:      " << WallTime << "s\n"
+              << "updates/sec:    " << (WallTime > 0 ? NumUpdates / WallTime : 0.0)
+              << std::endl;
+
+    std::cout << "navgraph: " << pRaven->GetMap()->GetNavGraph().NumActiveNodes() << " nodes"
+              << (pRaven->GetMap()->GetNavGridLayout() ? ", grid (jump point search)" : "")
+              << (pRaven->GetMap()->GetHierarchicalNavGraph() ? ", hierarchical" : "")
+              << std::endl;
+
+    const char* PriorityNames[num_search_priorities] = {"low", "normal", "high"};
+
+    for (int p=num_search_priorities-1; p>=0; --p)
+    {
+      const PathSearchStats& stats = pRaven->GetPathManager()->GetStats(p);
+
+      std::cout << PriorityNames[p] << " priority searches: " << stats.NumCompleted
+                << " (" << stats.NumLate << " late)"
+                << "  wait avg " << stats.AverageQueueWait() << " max " << stats.MaxQueueWait
+                << "  latency avg " << stats.AverageLatency() << " max " << stats.MaxLatency
+                << "\n";
+    }
+
+    const Raven_PathCache* pCache = pRaven->GetMap()->GetPathCache();
+
+    std::cout << "path cache: " << pCache->NumHits() << " hits, "
+              << pCache->NumMisses() << " misses\n";
+
+    std::cout << "item flow fields: "
+              << pRaven->GetMap()->GetItemFlowFields()->NumCalculations() << " calculations\n";
+
+    const Raven_ClosestNodeRaster* pRaster = pRaven->GetMap()->GetClosestNodeRaster();
+
+    std::cout << "closest node raster: " << pRaster->NumLookups() << " lookups, "
+              << pRaster->NumMisses() << " misses\n";
+
+    const Raven_PathSmoother* pSmoother = pRaven->GetMap()->GetPathSmoother();
+
+    std::cout << "path smoothing: " << pSmoother->NumTests() << " shortcuts tested, "
+              << pSmoother->NumSweeps() << " swept; table of "
+              << pSmoother->NumTableWalks() << " walks between nodes, "
+              << pSmoother->NumTableSweeps() << " swept\n";
+
+    std::list<Raven_Bot*>::const_iterator curBot = pRaven->GetAllBots().begin();
+    for (curBot; curBot != pRaven->GetAllBots().end(); ++curBot)
+    {
+      std::cout << "bot " << (*curBot)->ID() << " score: " << (*curBot)->Score() << "\n";
+    }
+  }
+
+  catch (const std::runtime_error& err)
+  {
+    std::cerr << err.what() << std::endl;
+
+    //tidy up
+    delete pRaven;
+    return 1;
+  }
+
+  //tidy up
+  delete pRaven;
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   main_mapconvert.cpp
+//
+//  Desc:   converts map editor (.map) files into binary maps, which the game
+//          loads without any parsing. See Raven_MapFile.h.
+//
+//          usage: Raven_MapConvert MapFile [BinaryFile]
+//
+//          If no BinaryFile is given it is written next to the map file
+//          with the extension .rmap
+//-----------------------------------------------------------------------------
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "Raven_MapFile.h"
+
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "usage: Raven_MapConvert MapFile [BinaryFile]" << std::endl;
+    return 1;
+  }
+
+  const std::string MapFileName = argv[1];
+
+  std::string BinaryFileName;
+
+  if (argc > 2)
+  {
+    BinaryFileName = argv[2];
+  }
+  else
+  {
+    //replace the extension, if there is one
+    std::string::size_type dot = MapFileName.find_last_of('.');
+    std::string::size_type sep = MapFileName.find_last_of("/\\");
+
+    if (dot != std::string::npos && (sep == std::string::npos || dot > sep))
+    {
+      BinaryFileName = MapFileName.substr(0, dot) + ".rmap";
+    }
+    else
+    {
+      BinaryFileName = MapFileName + ".rmap";
+    }
+  }
+
+  try
+  {
+    if (!ConvertMapFile(MapFileName, BinaryFileName))
+    {
+      std::cerr << "Unable to write " << BinaryFileName << std::endl;
+      return 1;
+    }
+  }
+
+  catch (const std::runtime_error& err)
+  {
+    std::cerr << err.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << MapFileName << " -> " << BinaryFileName << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,433 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   main_navtests.cpp
+//
+//  Desc:   checks the D* Lite search in navigation/TimeSlicedGraphAlgorithms.h,
+//          which repairs its last search instead of starting again. Searches
+//          are run on walled grids and then repeatedly moved (MoveSource,
+//          MoveTarget) or have edge costs changed (SetEdgeCost). After each
+//          repair the cost found, and the path traced, are checked against a
+//          fresh Graph_SearchAStar_TS search for the same query.
+//
+//          Each check is made on a grid with exact edge costs and again with
+//          the costs rounded to six figures, as they are when a map file is
+//          loaded.
+//
+//          usage: Raven_NavTests [RandomSeed]
+//
+//          Writes a line for each failure and a summary to stdout. Returns 0
+//          if every check passed. It is run by ctest.
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <list>
+
+#include "misc/utils.h"
+#include "Graph/SparseGraph.h"
+#include "Graph/CompactGraph.h"
+#include "Graph/GraphNodeTypes.h"
+#include "Graph/GraphEdgeTypes.h"
+#include "Graph/HandyGraphFunctions.h"
+#include "Graph/AStarHeuristicPolicies.h"
+#include "navigation/TimeSlicedGraphAlgorithms.h"
+
+
+typedef SparseGraph<NavGraphNode<void*>, NavGraphEdge>             NavGraph;
+typedef CompactGraph<NavGraph>                                     CompactNavGraph;
+typedef SearchWorkspacePool<NavGraphEdge>                          WorkspacePool;
+
+typedef Graph_SearchAStar_TS<CompactNavGraph, Heuristic_Euclid>     AStar;
+typedef Graph_SearchDStarLite_TS<CompactNavGraph, Heuristic_Euclid> DStarLite;
+
+
+//the size of the test grids and the number of nodes removed from them
+const int    GridSize  = 40;
+const int    NumWalls  = 300;
+
+//the number of searches made by each test and the number of times each is
+//moved or changed and repaired
+const int    NumSearches = 40;
+const int    NumRepairs  = 25;
+
+int NumChecks   = 0;
+int NumFailures = 0;
+
+
+//------------------------------ CreateGrid -----------------------------------
+//
+//  a grid of GridSize x GridSize nodes ten units apart with NumWalls nodes
+//  removed at random. If bRoundCosts is true the edge costs are written to
+//  six figures and read back, as a map file stores them
+//-----------------------------------------------------------------------------
+void CreateGrid(NavGraph& G, bool bRoundCosts)
+{
+  GraphHelper_CreateGrid(G, GridSize*10, GridSize*10, GridSize, GridSize);
+
+  for (int w=0; w<NumWalls; ++w)
+  {
+    int nd = RandInt(0, G.NumNodes()-1);
+
+    if (G.isNodePresent(nd)) G.RemoveNode(nd);
+  }
+
+  if (!bRoundCosts) return;
+
+  for (int nd=0; nd<G.NumNodes(); ++nd)
+  {
+    NavGraph::EdgeIterator EdgeItr(G, nd);
+
+    for (NavGraphEdge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      std::ostringstream ss;
+
+      ss << pE->Cost();
+
+      pE->SetCost(std::atof(ss.str().c_str()));
+    }
+  }
+}
+
+//------------------------------ RandomNode -----------------------------------
+//-----------------------------------------------------------------------------
+int RandomNode(const NavGraph& G)
+{
+  int nd;
+
+  do
+  {
+    nd = RandInt(0, G.NumNodes()-1);
+  }
+  while (!G.isNodePresent(nd));
+
+  return nd;
+}
+
+//------------------------------ Neighbours -----------------------------------
+//-----------------------------------------------------------------------------
+std::vector<int> Neighbours(const NavGraph& G, int nd)
+{
+  std::vector<int> neighbours;
+
+  NavGraph::ConstEdgeIterator EdgeItr(G, nd);
+
+  for (const NavGraphEdge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+  {
+    neighbours.push_back(pE->To());
+  }
+
+  return neighbours;
+}
+
+//------------------------------- Cycle ---------------------------------------
+//
+//  cycles a search until it terminates and returns the result
+//-----------------------------------------------------------------------------
+template <class search_type>
+int Cycle(search_type& search)
+{
+  int result;
+
+  do
+  {
+    result = search.CycleOnce();
+  }
+  while (result == search_incomplete);
+
+  return result;
+}
+
+//------------------------------- Check ---------------------------------------
+//
+//  compares a repaired search with a fresh A* search over G, the graph as the
+//  repaired search should see it. The costs must match to within the rounding
+//  of a map file, and the path traced must join the source to the target
+//  along edges of G whose costs add up to the cost found
+//-----------------------------------------------------------------------------
+void Check(const DStarLite&       search,
+           int                    result,
+           const NavGraph&        G,
+           const CompactNavGraph& CompactG,
+           WorkspacePool&         pool,
+           const char*            test)
+{
+  ++NumChecks;
+
+  AStar reference(CompactG, search.Source(), search.Target(), &pool);
+
+  const int ReferenceResult = Cycle(reference);
+
+  std::ostringstream error;
+
+  if (result != ReferenceResult)
+  {
+    error << "found " << (result == target_found) << ", A* found "
+          << (ReferenceResult == target_found);
+  }
+
+  else if (result == target_found)
+  {
+    const double cost      = search.GetCostToTarget();
+    const double tolerance = 1e-6 * (1.0 + reference.GetCostToTarget());
+
+    std::list<int> path = search.GetPathToTarget();
+
+    double PathCost = 0.0;
+
+    std::list<int>::const_iterator curNode = path.begin();
+    std::list<int>::const_iterator nextNode = curNode;
+
+    for (++nextNode; nextNode != path.end(); ++curNode, ++nextNode)
+    {
+      if (!G.isEdgePresent(*curNode, *nextNode))
+      {
+        PathCost = -1.0; break;
+      }
+
+      PathCost += G.GetEdge(*curNode, *nextNode).Cost();
+    }
+
+    if (fabs(cost - reference.GetCostToTarget()) > tolerance)
+    {
+      error << "cost " << cost << ", A* cost " << reference.GetCostToTarget();
+    }
+
+    else if (path.empty() || path.front() != search.Source() || path.back() != search.Target())
+    {
+      error << "the path doesn't run from the source to the target";
+    }
+
+    else if (PathCost < 0.0)
+    {
+      error << "the path has a step that isn't an edge";
+    }
+
+    else if (fabs(PathCost - cost) > tolerance)
+    {
+      error << "the path costs " << PathCost << ", the search says " << cost;
+    }
+
+    else if (search.GetPathAsPathEdges().size() + 1 != path.size())
+    {
+      error << "the path edges don't match the path";
+    }
+  }
+
+  if (!error.str().empty())
+  {
+    ++NumFailures;
+
+    std::cout << test << ": " << search.Source() << " to " << search.Target()
+              << ": " << error.str() << "\n";
+  }
+}
+
+//---------------------------- TestMoveSource --------------------------------
+//
+//  the source steps along the path found, as a bot following it does, or
+//  now and then jumps somewhere else on the grid
+//-----------------------------------------------------------------------------
+void TestMoveSource(bool bRoundCosts)
+{
+  NavGraph G(false);
+
+  CreateGrid(G, bRoundCosts);
+
+  CompactNavGraph CompactG(G);
+  WorkspacePool   pool;
+
+  for (int s=0; s<NumSearches; ++s)
+  {
+    DStarLite search(CompactG, RandomNode(G), RandomNode(G), &pool);
+
+    Check(search, Cycle(search), G, CompactG, pool, "MoveSource");
+
+    for (int r=0; r<NumRepairs; ++r)
+    {
+      std::list<int> path = search.GetPathToTarget();
+
+      if (path.size() > 1 && RandInt(0, 3) != 0)
+      {
+        std::list<int>::const_iterator next = path.begin();
+
+        std::advance(next, std::min((int)path.size()-1, RandInt(1, 3)));
+
+        search.MoveSource(*next);
+      }
+
+      else
+      {
+        search.MoveSource(RandomNode(G));
+      }
+
+      Check(search, Cycle(search), G, CompactG, pool, "MoveSource");
+    }
+  }
+}
+
+//---------------------------- TestMoveTarget --------------------------------
+//
+//  the target moves to a node next to it, as it does when a bot replans to
+//  a moving opponent, usually along with the source. Now and then the
+//  target is moved part way through a search, or jumps anywhere on the grid
+//-----------------------------------------------------------------------------
+void TestMoveTarget(bool bRoundCosts)
+{
+  NavGraph G(false);
+
+  CreateGrid(G, bRoundCosts);
+
+  CompactNavGraph CompactG(G);
+  WorkspacePool   pool;
+
+  for (int s=0; s<NumSearches; ++s)
+  {
+    DStarLite search(CompactG, RandomNode(G), RandomNode(G), &pool);
+
+    Check(search, Cycle(search), G, CompactG, pool, "MoveTarget");
+
+    for (int r=0; r<NumRepairs; ++r)
+    {
+      std::vector<int> neighbours = Neighbours(G, search.Target());
+
+      if (RandInt(0, 5) == 0 || neighbours.empty())
+      {
+        search.MoveTarget(RandomNode(G));
+      }
+
+      else
+      {
+        search.MoveTarget(neighbours[RandInt(0, neighbours.size()-1)]);
+      }
+
+      //interrupt the repair and move the target again
+      if (RandInt(0, 3) == 0)
+      {
+        for (int c=RandInt(0, 20); c>0 && search.CycleOnce() == search_incomplete; --c);
+
+        neighbours = Neighbours(G, search.Target());
+
+        if (!neighbours.empty()) search.MoveTarget(neighbours[RandInt(0, neighbours.size()-1)]);
+      }
+
+      std::vector<int> SourceNeighbours = Neighbours(G, search.Source());
+
+      if (RandBool() && !SourceNeighbours.empty())
+      {
+        search.MoveSource(SourceNeighbours[RandInt(0, SourceNeighbours.size()-1)]);
+      }
+
+      Check(search, Cycle(search), G, CompactG, pool, "MoveTarget");
+    }
+  }
+}
+
+//--------------------------- TestSetEdgeCost --------------------------------
+//
+//  the cost of an edge on the path found is raised, or an edge raised
+//  earlier is put back, as when a door closes and opens. A* is run over a
+//  copy of the graph with the same costs. Costs are never made lower than
+//  the straight line distance or the heuristic would overestimate
+//-----------------------------------------------------------------------------
+void TestSetEdgeCost(bool bRoundCosts)
+{
+  NavGraph G(false);
+
+  CreateGrid(G, bRoundCosts);
+
+  CompactNavGraph CompactG(G);
+  WorkspacePool   pool;
+
+  for (int s=0; s<NumSearches; ++s)
+  {
+    NavGraph        ChangedG(G);
+    CompactNavGraph ChangedCompactG(ChangedG);
+
+    DStarLite search(CompactG, RandomNode(G), RandomNode(G), &pool);
+
+    Check(search, Cycle(search), ChangedG, ChangedCompactG, pool, "SetEdgeCost");
+
+    std::vector<std::pair<int, int> > raised;
+
+    for (int r=0; r<NumRepairs; ++r)
+    {
+      std::list<int> path = search.GetPathToTarget();
+
+      int from, to;
+      double cost;
+
+      if (!raised.empty() && (RandInt(0, 2) == 0 || path.size() < 2))
+      {
+        from = raised.back().first;
+        to   = raised.back().second;
+        cost = G.GetEdge(from, to).Cost();
+
+        raised.pop_back();
+      }
+
+      else if (path.size() > 1)
+      {
+        std::list<int>::const_iterator edge = path.begin();
+
+        std::advance(edge, RandInt(0, path.size()-2));
+
+        from = *edge;
+        to   = *++edge;
+        cost = G.GetEdge(from, to).Cost() * (RandBool() ? 4.0 : 1000.0);
+
+        raised.push_back(std::make_pair(from, to));
+      }
+
+      else
+      {
+        continue;
+      }
+
+      ChangedG.SetEdgeCost(from, to, cost);
+      ChangedG.SetEdgeCost(to, from, cost);
+      ChangedCompactG.Rebuild();
+
+      //the edge can be given either way round
+      if (RandBool()) search.SetEdgeCost(from, to, cost);
+      else            search.SetEdgeCost(to, from, cost);
+
+      //move the source along as well now and then
+      if (RandInt(0, 3) == 0 && path.size() > 2)
+      {
+        search.MoveSource(*++path.begin());
+      }
+
+      Check(search, Cycle(search), ChangedG, ChangedCompactG, pool, "SetEdgeCost");
+    }
+  }
+}
+
+
+int main(int argc, char* argv[])
+{
+  unsigned Seed = 1;
+
+  if (argc > 1)
+  {
+    Seed = (unsigned)std::strtoul(argv[1], NULL, 10);
+  }
+
+  srand(Seed);
+
+  for (int round=0; round<2; ++round)
+  {
+    const bool bRoundCosts = round == 1;
+
+    TestMoveSource(bRoundCosts);
+    TestMoveTarget(bRoundCosts);
+    TestSetEdgeCost(bRoundCosts);
+  }
+
+  std::cout << "seed " << Seed << ": " << NumChecks << " D* Lite repairs checked against A*, "
+            << NumFailures << " failed" << std::endl;
+
+  return NumFailures == 0 ? 0 : 1;
+}
@@ -10,7 +10,8 @@
 //          planner in the creation of paths. 
 //
 //-----------------------------------------------------------------------------
-#include "2d/vector2D.h"
+#include "2D/Vector2D.h"
+#include "Graph/NodeTypeEnumerations.h"
 
 class PathEdge
 {
@@ -25,22 +26,41 @@ private:
 
   int      m_iDoorID;
 
+  //the navgraph nodes at the source and destination, or invalid_node_index
+  //if an end isn't at a node (such as the start of a path at the bot's
+  //position)
+  int      m_iSourceNode;
+  int      m_iDestinationNode;
+
 public:
   
   PathEdge(Vector2D Source,
            Vector2D Destination,
            int      Behavior,
-           int      DoorID = 0):m_vSource(Source),
-                                m_vDestination(Destination),
-                                m_iBehavior(Behavior),
-                                m_iDoorID(DoorID)
+           int      DoorID = 0,
+           int      SourceNode = invalid_node_index,
+           int      DestinationNode = invalid_node_index):m_vSource(Source),
+                                                          m_vDestination(Destination),
+                                                          m_iBehavior(Behavior),
+                                                          m_iDoorID(DoorID),
+                                                          m_iSourceNode(SourceNode),
+                                                          m_iDestinationNode(DestinationNode)
   {}
 
   Vector2D Destination()const{return m_vDestination;}
-  void     SetDestination(Vector2D NewDest){m_vDestination = NewDest;}
+  void     SetDestination(Vector2D NewDest, int NewDestNode = invalid_node_index)
+  {
+    m_vDestination = NewDest; m_iDestinationNode = NewDestNode;
+  }
   
   Vector2D Source()const{return m_vSource;}
-  void     SetSource(Vector2D NewSource){m_vSource = NewSource;}
+  void     SetSource(Vector2D NewSource, int NewSourceNode = invalid_node_index)
+  {
+    m_vSource = NewSource; m_iSourceNode = NewSourceNode;
+  }
+
+  int      SourceNode()const{return m_iSourceNode;}
+  int      DestinationNode()const{return m_iDestinationNode;}
 
   int      DoorID()const{return m_iDoorID;}
   int      Behavior()const{return m_iBehavior;}
@@ -7,11 +7,77 @@
 //
 //  Author: Mat Buckland (www.ai-junkie.com)
 //
-//  Desc:   a template class to manage a number of graph searches, and to 
+//  Desc:   a template class to manage a number of graph searches, and to
 //          distribute the calculation of each search over several update-steps
+//
+//          Each search is registered with a priority, which gives it a soft
+//          deadline: the number of update-steps it should be finished in.
+//          Every update-step the searches are served earliest deadline
+//          first, so urgent searches get their cycles before routine ones,
+//          but a routine search that has waited long enough comes ahead of
+//          any urgent search registered after its deadline fell due, so no
+//          search can be starved.
+//
+//          If it is given a number of threads the searches are run on a
+//          pool of worker threads instead of the main thread. Each search
+//          then gets the whole budget of search cycles to itself every
+//          update, and the bots are told of any that have finished once the
+//          workers are done. The searches only read the navgraph and the
+//          triggers, which nothing else touches while the workers are busy.
 //-----------------------------------------------------------------------------
 #include <list>
+#include <vector>
 #include <cassert>
+#include <algorithm>
+
+#include "TimeSlicedGraphAlgorithms.h"
+#include "misc/ThreadPool.h"
+
+
+//the priorities a search can be registered with
+enum
+{
+  search_priority_low,
+  search_priority_normal,
+  search_priority_high,
+
+  num_search_priorities
+};
+
+
+//------------------------------ PathSearchStats ------------------------------
+//
+//  timings of the searches of one priority that have completed, measured in
+//  update-steps from the first update-step a search could be given cycles
+//  in. The queue wait is the time from then to it being given its first
+//  cycle, and the latency the time from then to the bot being told the
+//  result, so a search served and finished straight away scores zero for
+//  both
+//-----------------------------------------------------------------------------
+struct PathSearchStats
+{
+  int    NumCompleted;
+
+  //the number of searches that finished after their deadline
+  int    NumLate;
+
+  int    TotalQueueWait;
+  int    MaxQueueWait;
+
+  int    TotalLatency;
+  int    MaxLatency;
+
+  PathSearchStats():NumCompleted(0),
+                    NumLate(0),
+                    TotalQueueWait(0),
+                    MaxQueueWait(0),
+                    TotalLatency(0),
+                    MaxLatency(0)
+  {}
+
+  double AverageQueueWait()const{return NumCompleted ? (double)TotalQueueWait / NumCompleted : 0.0;}
+  double AverageLatency()const{return NumCompleted ? (double)TotalLatency / NumCompleted : 0.0;}
+};
 
 
 
@@ -20,40 +86,153 @@ class PathManager
 {
 private:
 
+  struct SearchRequest
+  {
+    path_planner* pPlanner;
+
+    int           Priority;
+
+    //the first update-step the search could be given cycles in, the one it
+    //was given its first cycle in (or -1 if it has yet to be given one) and
+    //the one it should be finished by
+    int           Registered;
+    int           Started;
+    int           Deadline;
+
+    SearchRequest(path_planner* pPlanner,
+                  int           Priority,
+                  int           Registered,
+                  int           Deadline):pPlanner(pPlanner),
+                                          Priority(Priority),
+                                          Registered(Registered),
+                                          Started(-1),
+                                          Deadline(Deadline)
+    {}
+
+    //earliest deadline first. The higher priority search wins a tie
+    bool operator<(const SearchRequest& rhs)const
+    {
+      if (Deadline != rhs.Deadline) return Deadline < rhs.Deadline;
+
+      return Priority > rhs.Priority;
+    }
+  };
+
+  //predicate for finding a planner's request
+  class IsRequestOf
+  {
+    path_planner* m_pPlanner;
+
+  public:
+
+    IsRequestOf(path_planner* pPlanner):m_pPlanner(pPlanner){}
+
+    bool operator()(const SearchRequest& r)const{return r.pPlanner == m_pPlanner;}
+  };
+
   //a container of all the active search requests
-  std::list<path_planner*>  m_SearchRequests;
+  std::list<SearchRequest>  m_SearchRequests;
 
-  //this is the total number of search cycles allocated to the manager. 
-  //Each update-step these are divided equally amongst all registered path
-  //requests
+  //this is the total number of search cycles allocated to the manager.
+  //Each update-step these are given to the registered path requests in
+  //order of their deadlines
   unsigned int              m_iNumSearchCyclesPerUpdate;
 
+  //the number of update-steps a search of each priority should be
+  //finished in
+  int                       m_Deadlines[num_search_priorities];
+
+  //the number of times UpdateSearches has been called
+  int                       m_iUpdateStep;
+
+  PathSearchStats           m_Stats[num_search_priorities];
+
+  //the worker threads the searches are run on. NULL if they are run on
+  //the main thread
+  ThreadPool*               m_pThreadPool;
+
+  //the searches being run by the workers and the result of each
+  std::vector<path_planner*> m_Batch;
+  std::vector<int>          m_BatchResults;
+
+  //the searches that have terminated this update-step, and their results,
+  //in the order the bots are to be told of them
+  std::vector<path_planner*> m_Finished;
+  std::vector<int>          m_FinishedResults;
+
+  PathManager(const PathManager&);
+  PathManager& operator=(const PathManager&);
+
+  //the searches made by the path planners borrow their workspaces from
+  //here so that starting a search doesn't allocate
+  SearchWorkspacePool<typename path_planner::EdgeType> m_WorkspacePool;
+
+  //records the timings of a search that has terminated and queues up its
+  //owner to be told the result
+  void Finish(const SearchRequest& request, int result);
+
+  //tells the bots the results of the searches that have terminated
+  void NotifyFinished();
+
+  void UpdateSearchesInParallel();
+
 public:
-    
-  PathManager(unsigned int NumCyclesPerUpdate):m_iNumSearchCyclesPerUpdate(NumCyclesPerUpdate){}
 
-  //every time this is called the total amount of search cycles available will
-  //be shared out equally between all the active path requests. If a search
-  //completes successfully or fails the method will notify the relevant bot
+  //if NumThreads is greater than zero the searches are run on that many
+  //worker threads
+  PathManager(unsigned int NumCyclesPerUpdate,
+              int          NumThreads = 0):m_iNumSearchCyclesPerUpdate(NumCyclesPerUpdate),
+                                           m_iUpdateStep(0),
+                                           m_pThreadPool(NULL)
+  {
+    m_Deadlines[search_priority_low]    = 30;
+    m_Deadlines[search_priority_normal] = 10;
+    m_Deadlines[search_priority_high]   = 2;
+
+    if (NumThreads > 0) m_pThreadPool = new ThreadPool(NumThreads);
+  }
+
+  ~PathManager(){delete m_pThreadPool;}
+
+  //every time this is called the search cycles available are given to the
+  //active path requests in order of their deadlines. If a search completes
+  //successfully or fails the method will notify the relevant bot.
+  //
+  //If the searches are run on worker threads this blocks until the workers
+  //have finished. The bots are told of the searches that completed in
+  //deadline order either way, so the results don't depend on the number of
+  //threads or which search finished first
   void UpdateSearches();
 
-  //a path planner should call this method to register a search with the 
+  //a path planner should call this method to register a search with the
   //manager. (The method checks to ensure the path planner is only registered
   //once)
-  void Register(path_planner* pPathPlanner);
+  void Register(path_planner* pPathPlanner, int priority = search_priority_normal);
 
   void UnRegister(path_planner* pPathPlanner);
 
+  //sets the number of update-steps a search of the given priority should
+  //be finished in
+  void SetDeadline(int priority, int NumUpdateSteps);
+
   //returns the amount of path requests currently active.
   int  GetNumActiveSearches()const{return m_SearchRequests.size();}
+
+  bool isThreaded()const{return m_pThreadPool != NULL;}
+
+  const PathSearchStats& GetStats(int priority)const{return m_Stats[priority];}
+
+  void ResetStats();
+
+  SearchWorkspacePool<typename path_planner::EdgeType>* GetWorkspacePool(){return &m_WorkspacePool;}
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 //------------------------- UpdateSearches ------------------------------------
 //
-//  This method iterates through all the active path planning requests 
-//  updating their searches until the user specified total number of search
-//  cycles has been satisfied.
+//  This method iterates through all the active path planning requests, most
+//  urgent first, updating their searches until the user specified total
+//  number of search cycles has been satisfied.
 //
 //  If a path is found or the search is unsuccessful the relevant agent is
 //  notified accordingly by Telegram
@@ -61,36 +240,154 @@ public:
 template <class path_planner>
 inline void PathManager<path_planner>::UpdateSearches()
 {
+  ++m_iUpdateStep;
+
+  //list::sort is stable so searches with the same deadline and priority
+  //stay in the order they were registered
+  m_SearchRequests.sort();
+
+  if (m_pThreadPool)
+  {
+    UpdateSearchesInParallel(); return;
+  }
+
   int NumCyclesRemaining = m_iNumSearchCyclesPerUpdate;
 
-  //iterate through the search requests until either all requests have been
-  //fulfilled or there are no search cycles remaining for this update-step.
-  std::list<path_planner*>::iterator curPath = m_SearchRequests.begin();
-  while (NumCyclesRemaining-- && !m_SearchRequests.empty())
+  //give each search in turn as many cycles as it needs until either all
+  //requests have been fulfilled or there are no search cycles remaining for
+  //this update-step.
+  typename std::list<SearchRequest>::iterator curPath = m_SearchRequests.begin();
+  while (NumCyclesRemaining && curPath != m_SearchRequests.end())
   {
-    //make one search cycle of this path request
-    int result = (*curPath)->CycleOnce();
+    if (curPath->Started < 0) curPath->Started = m_iUpdateStep;
+
+    int result = search_incomplete;
+
+    while (NumCyclesRemaining && result == search_incomplete)
+    {
+      //make one search cycle of this path request
+      result = curPath->pPlanner->CycleSearchOnce();
+
+      --NumCyclesRemaining;
+    }
 
     //if the search has terminated remove from the list
     if ( (result == target_found) || (result == target_not_found) )
     {
-      //remove this path from the path list
-      curPath = m_SearchRequests.erase(curPath);       
+      Finish(*curPath, result);
+
+      curPath = m_SearchRequests.erase(curPath);
+    }
+  }
+
+  NotifyFinished();
+}
+
+//--------------------------- UpdateSearchesInParallel ------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::UpdateSearchesInParallel()
+{
+  assert (m_pThreadPool && "<PathManager::UpdateSearchesInParallel>: no worker threads");
+
+  if (m_SearchRequests.empty()) return;
+
+  m_Batch.clear();
+
+  typename std::list<SearchRequest>::iterator curPath = m_SearchRequests.begin();
+  for (curPath; curPath != m_SearchRequests.end(); ++curPath)
+  {
+    if (curPath->Started < 0) curPath->Started = m_iUpdateStep;
+
+    m_Batch.push_back(curPath->pPlanner);
+  }
+
+  m_BatchResults.assign(m_Batch.size(), search_incomplete);
+
+  //each search runs until it terminates or has used up its cycles. The
+  //workers take the searches in deadline order
+  m_pThreadPool->ParallelFor(0, (int)m_Batch.size(), [this](int i)
+  {
+    int result = search_incomplete;
+
+    for (unsigned int cycle=0;
+         (cycle < m_iNumSearchCyclesPerUpdate) && (result == search_incomplete);
+         ++cycle)
+    {
+      result = m_Batch[i]->CycleSearchOnce();
     }
-    //move on to the next
-    else
+
+    m_BatchResults[i] = result;
+  });
+
+  //remove the finished searches before telling the bots about them, because
+  //a bot is likely to ask for a new path as soon as it hears of the result
+  curPath = m_SearchRequests.begin();
+  for (unsigned int i=0; i<m_Batch.size(); ++i)
+  {
+    if (m_BatchResults[i] == search_incomplete)
     {
       ++curPath;
     }
-
-    //the iterator may now be pointing to the end of the list. If this is so,
-    // it must be reset to the beginning.
-    if (curPath == m_SearchRequests.end())
+    else
     {
-      curPath = m_SearchRequests.begin();
+      Finish(*curPath, m_BatchResults[i]);
+
+      curPath = m_SearchRequests.erase(curPath);
     }
+  }
 
-  }//end while
+  NotifyFinished();
+}
+
+//------------------------------- Finish --------------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::Finish(const SearchRequest& request,
+                                              int                  result)
+{
+  PathSearchStats& stats = m_Stats[request.Priority];
+
+  const int QueueWait = request.Started - request.Registered;
+  const int Latency   = m_iUpdateStep - request.Registered;
+
+  ++stats.NumCompleted;
+
+  if (m_iUpdateStep > request.Deadline) ++stats.NumLate;
+
+  stats.TotalQueueWait += QueueWait;
+  stats.TotalLatency   += Latency;
+
+  stats.MaxQueueWait = std::max(stats.MaxQueueWait, QueueWait);
+  stats.MaxLatency   = std::max(stats.MaxLatency, Latency);
+
+  m_Finished.push_back(request.pPlanner);
+  m_FinishedResults.push_back(result);
+}
+
+//---------------------------- NotifyFinished ---------------------------------
+//
+//  the searches are finished in the order they were served, which is their
+//  deadline order (see UpdateSearches), so the bots are told of the results
+//  earliest deadline first, not in the order the searches were registered.
+//
+//  Before any bot is told, the planners are given all the results of the
+//  update-step at once so they can prepare their paths in one batch
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::NotifyFinished()
+{
+  if (m_Finished.empty()) return;
+
+  path_planner::PreparePaths(m_Finished, m_FinishedResults, m_pThreadPool);
+
+  for (unsigned int i=0; i<m_Finished.size(); ++i)
+  {
+    m_Finished[i]->NotifyOwnerOfResult(m_FinishedResults[i]);
+  }
+
+  m_Finished.clear();
+  m_FinishedResults.clear();
 }
 
 //--------------------------- Register ----------------------------------------
@@ -98,15 +395,26 @@ inline void PathManager<path_planner>::UpdateSearches()
 //  this is called to register a search with the manager.
 //-----------------------------------------------------------------------------
 template <class path_planner>
-inline void PathManager<path_planner>::Register(path_planner* pPathPlanner)
+inline void PathManager<path_planner>::Register(path_planner* pPathPlanner,
+                                                int           priority)
 {
+  assert (priority >= 0 && priority < num_search_priorities &&
+          "<PathManager::Register>: invalid priority");
+
   //make sure the bot does not already have a current search in the queue
-  if(std::find(m_SearchRequests.begin(),
-               m_SearchRequests.end(),
-               pPathPlanner) == m_SearchRequests.end())
-  { 
-    //add to the list
-    m_SearchRequests.push_back(pPathPlanner);
+  if(std::find_if(m_SearchRequests.begin(),
+                  m_SearchRequests.end(),
+                  IsRequestOf(pPathPlanner)) == m_SearchRequests.end())
+  {
+    //the step counter is advanced at the start of UpdateSearches, so the
+    //search is first eligible for cycles in the next update-step. It should
+    //be finished within its deadline's number of steps from then
+    const int FirstStep = m_iUpdateStep + 1;
+
+    m_SearchRequests.push_back(SearchRequest(pPathPlanner,
+                                             priority,
+                                             FirstStep,
+                                             FirstStep + m_Deadlines[priority] - 1));
   }
 }
 
@@ -115,12 +423,31 @@ inline void PathManager<path_planner>::Register(path_planner* pPathPlanner)
 template <class path_planner>
 inline void PathManager<path_planner>::UnRegister(path_planner* pPathPlanner)
 {
-  m_SearchRequests.remove(pPathPlanner);
-
+  m_SearchRequests.remove_if(IsRequestOf(pPathPlanner));
 }
 
+//----------------------------- SetDeadline -----------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::SetDeadline(int priority, int NumUpdateSteps)
+{
+  assert (priority >= 0 && priority < num_search_priorities &&
+          "<PathManager::SetDeadline>: invalid priority");
+
+  m_Deadlines[priority] = NumUpdateSteps;
+}
 
+//------------------------------ ResetStats -----------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::ResetStats()
+{
+  for (int p=0; p<num_search_priorities; ++p)
+  {
+    m_Stats[p] = PathSearchStats();
+  }
+}
 
 
 
-#endif
\ No newline at end of file
+#endif
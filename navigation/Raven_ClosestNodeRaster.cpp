@@ -0,0 +1,129 @@
+#include "Raven_ClosestNodeRaster.h"
+#include "../Raven_Map.h"
+#include "../Raven_Door.h"
+#include "2D/geometry.h"
+#include "Graph/NodeTypeEnumerations.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+//------------------------------- ctor ----------------------------------------
+//-----------------------------------------------------------------------------
+Raven_ClosestNodeRaster::Raven_ClosestNodeRaster(const Raven_Map& map,
+                                                 double           CellSize):m_Map(map),
+                                                                            m_dCellSize(CellSize),
+                                                                            m_iNumCellsX(0),
+                                                                            m_iNumCellsY(0),
+                                                                            m_dBoundingRadius(0.0),
+                                                                            m_iNumLookups(0),
+                                                                            m_iNumMisses(0)
+{}
+
+//----------------------------- isObstructed ----------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_ClosestNodeRaster::isObstructed(Vector2D A,
+                                           Vector2D B,
+                                           double   BoundingRadius)const
+{
+  if (m_Map.GetWallSpace().doesCapsuleIntersect(A, B, BoundingRadius))
+  {
+    return true;
+  }
+
+  //a door's walls never stray more than a unit from where they lie when
+  //the door is closed
+  const double r = BoundingRadius + 1;
+
+  std::vector<Raven_Door*>::const_iterator curDoor = m_Map.GetDoors().begin();
+  for (curDoor; curDoor != m_Map.GetDoors().end(); ++curDoor)
+  {
+    if (DistBetweenLineSegmentsSq(A, B, (*curDoor)->ClosedFrom(), (*curDoor)->ClosedTo()) < r*r)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//-------------------------------- Create -------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_ClosestNodeRaster::Create(double BoundingRadius)
+{
+  m_dBoundingRadius = BoundingRadius;
+
+  m_iNumCellsX = (int)ceil(m_Map.GetSizeX() / m_dCellSize);
+  m_iNumCellsY = (int)ceil(m_Map.GetSizeY() / m_dCellSize);
+
+  m_ClosestNode.assign(m_iNumCellsX * m_iNumCellsY, invalid_node_index);
+
+  //every position in a cell is within this distance of its centre. A bot
+  //this much bigger that can walk from the centre to a node shows a bot can
+  //walk to the node from anywhere in the cell
+  const double HalfDiagonal = m_dCellSize * sqrt(2.0) * 0.5;
+
+  const double range = m_Map.GetCellSpaceNeighborhoodRange();
+
+  std::vector<std::pair<double, int> > candidates;
+
+  for (int y=0; y<m_iNumCellsY; ++y)
+  {
+    for (int x=0; x<m_iNumCellsX; ++x)
+    {
+      Vector2D centre((x + 0.5) * m_dCellSize, (y + 0.5) * m_dCellSize);
+
+      //the nodes around the centre, closest first
+      candidates.clear();
+
+      m_Map.GetCellSpace()->CalculateNeighbors(centre, range);
+
+      for (Raven_Map::NavGraph::NodeType* pN = m_Map.GetCellSpace()->begin();
+           !m_Map.GetCellSpace()->end();
+           pN = m_Map.GetCellSpace()->next())
+      {
+        candidates.push_back(std::make_pair(Vec2DDistanceSq(centre, pN->Pos()), pN->Index()));
+      }
+
+      std::sort(candidates.begin(), candidates.end());
+
+      //store the closest node a bot at the centre can walk to, if it can be
+      //walked to from anywhere in the cell
+      for (unsigned int c=0; c<candidates.size(); ++c)
+      {
+        Vector2D NodePos = m_Map.GetNavGraph().GetNode(candidates[c].second).Pos();
+
+        if (isObstructed(centre, NodePos, BoundingRadius)) continue;
+
+        if (!isObstructed(centre, NodePos, BoundingRadius + HalfDiagonal))
+        {
+          m_ClosestNode[y * m_iNumCellsX + x] = candidates[c].second;
+        }
+
+        break;
+      }
+    }
+  }
+}
+
+//---------------------------- GetClosestNode ---------------------------------
+//-----------------------------------------------------------------------------
+int Raven_ClosestNodeRaster::GetClosestNode(Vector2D pos, double BoundingRadius)
+{
+  ++m_iNumLookups;
+
+  const int x = (int)floor(pos.x / m_dCellSize);
+  const int y = (int)floor(pos.y / m_dCellSize);
+
+  //the raster is made once, for the bots' size when the map is loaded.
+  //Remaking it for a bot of another size would cost more than testing the
+  //nodes around pos
+  if (BoundingRadius != m_dBoundingRadius ||
+      x < 0 || y < 0 || x >= m_iNumCellsX || y >= m_iNumCellsY ||
+      m_ClosestNode[y * m_iNumCellsX + x] == invalid_node_index)
+  {
+    ++m_iNumMisses; return invalid_node_index;
+  }
+
+  return m_ClosestNode[y * m_iNumCellsX + x];
+}
@@ -0,0 +1,78 @@
+#ifndef RAVEN_CLOSESTNODERASTER_H
+#define RAVEN_CLOSESTNODERASTER_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_ClosestNodeRaster.h
+//
+//  Desc:   a grid over the map holding, for each small square cell, the
+//          navgraph node closest to the cell's centre that a bot can walk
+//          to in a straight line. Finding the node closest to a bot is then
+//          a lookup rather than a test of the path to each node nearby.
+//
+//          A node is only stored if a bot can walk to it from anywhere in
+//          the cell, with every door closed. Cells where that isn't so,
+//          such as those beside walls and in doorways, are left empty and
+//          the nodes around a position in them must be tested as before.
+//
+//          The raster is made when the map is loaded, once the walls and
+//          doors are in place and the size of the bots is known. It only
+//          answers for bots of that size.
+//-----------------------------------------------------------------------------
+#include <vector>
+
+#include "2D/Vector2D.h"
+
+class Raven_Map;
+
+
+class Raven_ClosestNodeRaster
+{
+private:
+
+  const Raven_Map&  m_Map;
+
+  double            m_dCellSize;
+
+  int               m_iNumCellsX;
+  int               m_iNumCellsY;
+
+  //the bounding radius of the bots the raster was made for. Zero until it
+  //has been made
+  double            m_dBoundingRadius;
+
+  //the node stored for each cell, or invalid_node_index
+  std::vector<int>  m_ClosestNode;
+
+  int               m_iNumLookups;
+  int               m_iNumMisses;
+
+  //returns true if a bot of the given bounding radius walking from A to B
+  //would bump into a wall, or into a door were it closed
+  bool isObstructed(Vector2D A, Vector2D B, double BoundingRadius)const;
+
+  Raven_ClosestNodeRaster(const Raven_ClosestNodeRaster&);
+  Raven_ClosestNodeRaster& operator=(const Raven_ClosestNodeRaster&);
+
+public:
+
+  Raven_ClosestNodeRaster(const Raven_Map& map, double CellSize);
+
+  //works out the node stored for each cell for bots of the given bounding
+  //radius. Call this once the map's walls and doors are in place
+  void Create(double BoundingRadius);
+
+  //returns the node stored for the cell pos is in: the node closest to the
+  //centre of the cell that a bot of the given bounding radius can walk to.
+  //This is not necessarily the node closest to pos itself. Returns
+  //invalid_node_index if the raster doesn't hold one for the cell, or wasn't
+  //made for bots of this size, and the nodes around pos must be tested
+  int  GetClosestNode(Vector2D pos, double BoundingRadius);
+
+  int  NumLookups()const{return m_iNumLookups;}
+  int  NumMisses()const{return m_iNumMisses;}
+};
+
+
+
+#endif
@@ -0,0 +1,122 @@
+#include "Raven_ItemFlowFields.h"
+
+#include <vector>
+#include <algorithm>
+
+
+//------------------------------- ctor ----------------------------------------
+//-----------------------------------------------------------------------------
+Raven_ItemFlowFields::Raven_ItemFlowFields(const Raven_Map& map):m_Map(map),
+                                                                 m_iNumCalculations(0)
+{}
+
+//------------------------------- dtor ----------------------------------------
+//-----------------------------------------------------------------------------
+Raven_ItemFlowFields::~Raven_ItemFlowFields()
+{
+  for (FieldMap::iterator it = m_Fields.begin(); it != m_Fields.end(); ++it)
+  {
+    delete it->second.pField;
+  }
+}
+
+//------------------------------ GetField -------------------------------------
+//-----------------------------------------------------------------------------
+const Raven_ItemFlowFields::FlowField& Raven_ItemFlowFields::GetField(int ItemType)
+{
+  FieldMap::iterator it = m_Fields.find(ItemType);
+
+  if (it == m_Fields.end())
+  {
+    Field field;
+
+    field.pField       = new FlowField(m_Map.GetCompactNavGraph());
+    field.TriggerStamp = m_Map.GetNumTriggerStateChanges() - 1;
+
+    it = m_Fields.insert(FieldMap::value_type(ItemType, field)).first;
+  }
+
+  //nothing can have changed if no trigger has changed state
+  if (it->second.TriggerStamp == m_Map.GetNumTriggerStateChanges())
+  {
+    return *it->second.pField;
+  }
+
+  it->second.TriggerStamp = m_Map.GetNumTriggerStateChanges();
+
+  //find the nodes of the active givers of this type
+  std::vector<int> goals;
+
+  const Raven_Map::TriggerSystem::TriggerList& triggers = m_Map.GetTriggers();
+
+  Raven_Map::TriggerSystem::TriggerList::const_iterator trg;
+  for (trg = triggers.begin(); trg != triggers.end(); ++trg)
+  {
+    if ((*trg)->EntityType() == ItemType &&
+        (*trg)->isActive()                &&
+        (*trg)->GraphNodeIndex() >= 0)
+    {
+      goals.push_back((*trg)->GraphNodeIndex());
+    }
+  }
+
+  std::sort(goals.begin(), goals.end());
+
+  //only calculate the field again if the givers have changed. The first
+  //time through the field's goals are empty so it's calculated if there
+  //are any givers
+  if (goals != it->second.pField->Goals())
+  {
+    it->second.pField->Calculate(goals);
+
+    ++m_iNumCalculations;
+  }
+
+  return *it->second.pField;
+}
+
+//---------------------------- GetCostToItem ----------------------------------
+//-----------------------------------------------------------------------------
+double Raven_ItemFlowFields::GetCostToItem(int ItemType, int source)
+{
+  const FlowField& field = GetField(ItemType);
+
+  if (!field.isReachable(source)) return -1;
+
+  return field.Cost(source);
+}
+
+//---------------------------- GetPathToItem ----------------------------------
+//-----------------------------------------------------------------------------
+double Raven_ItemFlowFields::GetPathToItem(int                   ItemType,
+                                           int                   source,
+                                           std::list<int>&       path,
+                                           std::list<PathEdge>&  PathEdges)
+{
+  const FlowField& field = GetField(ItemType);
+
+  if (!field.isReachable(source)) return -1;
+
+  const Raven_Map::CompactNavGraph& G = m_Map.GetCompactNavGraph();
+
+  int nd = source;
+
+  path.push_back(nd);
+
+  //follow the field until it runs out at a giver
+  for (const FlowField::EdgeType* pE = field.NextEdge(nd); pE; pE = field.NextEdge(nd))
+  {
+    PathEdges.push_back(PathEdge(G.GetNode(pE->From()).Pos(),
+                                 G.GetNode(pE->To()).Pos(),
+                                 pE->Flags(),
+                                 pE->IDofIntersectingEntity(),
+                                 pE->From(),
+                                 pE->To()));
+
+    nd = pE->To();
+
+    path.push_back(nd);
+  }
+
+  return field.Cost(source);
+}
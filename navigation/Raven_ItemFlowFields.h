@@ -0,0 +1,82 @@
+#ifndef RAVEN_ITEMFLOWFIELDS_H
+#define RAVEN_ITEMFLOWFIELDS_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_ItemFlowFields.h
+//
+//  Desc:   a flow field over the navgraph for each type of item, leading
+//          from every node to the nearest active giver of that type. All
+//          the bots share them, so finding the way to the nearest health
+//          or weapon is a walk along the field rather than a search.
+//
+//          A field is brought up to date when it is next used after any
+//          trigger has changed state, and is only calculated again if the
+//          givers of its type that are active have changed. Doors don't
+//          alter the cost of the navgraph's edges so they don't affect the
+//          fields.
+//-----------------------------------------------------------------------------
+#include <map>
+#include <list>
+
+#include "Graph/GraphFlowField.h"
+#include "PathEdge.h"
+#include "../Raven_Map.h"
+
+
+class Raven_ItemFlowFields
+{
+public:
+
+  typedef GraphFlowField<Raven_Map::CompactNavGraph> FlowField;
+
+private:
+
+  struct Field
+  {
+    FlowField*    pField;
+
+    //the number of trigger state changes when the field was last checked
+    unsigned int  TriggerStamp;
+  };
+
+  typedef std::map<int, Field> FieldMap;
+
+  const Raven_Map&  m_Map;
+
+  FieldMap          m_Fields;
+
+  int               m_iNumCalculations;
+
+  Raven_ItemFlowFields(const Raven_ItemFlowFields&);
+  Raven_ItemFlowFields& operator=(const Raven_ItemFlowFields&);
+
+public:
+
+  //the map's navgraph and triggers must be in place before the fields
+  //are used
+  Raven_ItemFlowFields(const Raven_Map& map);
+
+  ~Raven_ItemFlowFields();
+
+  //returns the field leading to the active givers of the item type
+  const FlowField&  GetField(int ItemType);
+
+  //returns the cost from the node to the nearest active item of the type,
+  //or -1 if none can be reached
+  double            GetCostToItem(int ItemType, int source);
+
+  //fills in the path from the node to the nearest active item of the type
+  //and returns its cost, or returns -1 if none can be reached
+  double            GetPathToItem(int                   ItemType,
+                                  int                   source,
+                                  std::list<int>&       path,
+                                  std::list<PathEdge>&  PathEdges);
+
+  //the number of times a field has been calculated
+  int               NumCalculations()const{return m_iNumCalculations;}
+};
+
+
+
+#endif
@@ -0,0 +1,91 @@
+#include "Raven_PathCache.h"
+
+
+//------------------------------- ctor ----------------------------------------
+//-----------------------------------------------------------------------------
+Raven_PathCache::Raven_PathCache(unsigned int MaxSize):m_iMaxSize(MaxSize),
+                                                       m_iNumHits(0),
+                                                       m_iNumMisses(0)
+{}
+
+//-------------------------------- Find ---------------------------------------
+//-----------------------------------------------------------------------------
+const Raven_PathCache::CachedPath*
+Raven_PathCache::Find(int           SearchType,
+                      int           Source,
+                      int           Target,
+                      unsigned int  DoorStamp)
+{
+  if (!isEnabled()) return NULL;
+
+  PathMap::iterator it = m_Paths.find(Key(SearchType, Source, Target));
+
+  if (it == m_Paths.end())
+  {
+    ++m_iNumMisses; return NULL;
+  }
+
+  //a stale path will never be valid again so it may as well go now
+  if (it->second.DoorStamp != DoorStamp)
+  {
+    m_LeastRecentlyUsed.erase(it->second.Use);
+    m_Paths.erase(it);
+
+    ++m_iNumMisses; return NULL;
+  }
+
+  //move the path to the back of the queue for removal
+  m_LeastRecentlyUsed.splice(m_LeastRecentlyUsed.end(),
+                             m_LeastRecentlyUsed,
+                             it->second.Use);
+
+  ++m_iNumHits;
+
+  return &it->second.Path;
+}
+
+//------------------------------- Store ---------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathCache::Store(int                 SearchType,
+                            int                 Source,
+                            int                 Target,
+                            const CachedPath&   path,
+                            unsigned int        DoorStamp)
+{
+  if (!isEnabled()) return;
+
+  const Key key(SearchType, Source, Target);
+
+  PathMap::iterator it = m_Paths.find(key);
+
+  if (it == m_Paths.end())
+  {
+    //make room for the new path
+    if (m_Paths.size() >= m_iMaxSize)
+    {
+      m_Paths.erase(m_LeastRecentlyUsed.front());
+      m_LeastRecentlyUsed.pop_front();
+    }
+
+    it = m_Paths.insert(PathMap::value_type(key, Entry())).first;
+
+    it->second.Use = m_LeastRecentlyUsed.insert(m_LeastRecentlyUsed.end(), key);
+  }
+  else
+  {
+    m_LeastRecentlyUsed.splice(m_LeastRecentlyUsed.end(),
+                               m_LeastRecentlyUsed,
+                               it->second.Use);
+  }
+
+  it->second.Path      = path;
+  it->second.DoorStamp = DoorStamp;
+}
+
+//------------------------------- Clear ---------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathCache::Clear()
+{
+  m_Paths.clear();
+  m_LeastRecentlyUsed.clear();
+}
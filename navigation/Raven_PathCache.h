@@ -0,0 +1,121 @@
+#ifndef RAVEN_PATHCACHE_H
+#define RAVEN_PATHCACHE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_PathCache.h
+//
+//  Desc:   a cache of the paths found by the bots' path planners, shared by
+//          all the bots so a route one bot has searched for can be handed
+//          straight to the next bot that asks for it.
+//
+//          A path is stored under the kind of search that found it, the
+//          node it starts from and the node it leads to. Only paths to
+//          positions are stored: the planners read paths to items from the
+//          map's item flow fields, which keep track of the triggers
+//          themselves.
+//
+//          Any door changing state drops every path. Rather than search the
+//          cache each time, every path is stamped with the number of door
+//          changes there had been when it was stored and is ignored once
+//          that number has moved on.
+//-----------------------------------------------------------------------------
+#include <map>
+#include <list>
+
+#include "PathEdge.h"
+
+
+class Raven_PathCache
+{
+public:
+
+  //a path as held in the cache
+  struct CachedPath
+  {
+    //the nodes on the path, from source to target
+    std::list<int>       Nodes;
+
+    std::list<PathEdge>  Edges;
+
+    double               Cost;
+  };
+
+private:
+
+  struct Key
+  {
+    int SearchType;
+    int Source;
+    int Target;
+
+    Key(int SearchType, int Source, int Target):SearchType(SearchType),
+                                                Source(Source),
+                                                Target(Target)
+    {}
+
+    bool operator<(const Key& rhs)const
+    {
+      if (SearchType != rhs.SearchType) return SearchType < rhs.SearchType;
+      if (Source != rhs.Source)         return Source < rhs.Source;
+
+      return Target < rhs.Target;
+    }
+  };
+
+  struct Entry
+  {
+    CachedPath                     Path;
+
+    //the number of door state changes when the path was stored
+    unsigned int                   DoorStamp;
+
+    //this entry's position in m_LeastRecentlyUsed
+    std::list<Key>::iterator       Use;
+  };
+
+  typedef std::map<Key, Entry> PathMap;
+
+  PathMap         m_Paths;
+
+  //the keys of the stored paths, the least recently used first
+  std::list<Key>  m_LeastRecentlyUsed;
+
+  //once this many paths are stored the least recently used is dropped to
+  //make room for a new one
+  unsigned int    m_iMaxSize;
+
+  int             m_iNumHits;
+  int             m_iNumMisses;
+
+public:
+
+  //a MaxSize of zero disables the cache
+  Raven_PathCache(unsigned int MaxSize);
+
+  //returns the path stored for the given search, or NULL if there isn't a
+  //valid one. DoorStamp is the current number of door state changes
+  const CachedPath* Find(int           SearchType,
+                         int           Source,
+                         int           Target,
+                         unsigned int  DoorStamp);
+
+  //stores the path found by a search
+  void              Store(int                 SearchType,
+                          int                 Source,
+                          int                 Target,
+                          const CachedPath&   path,
+                          unsigned int        DoorStamp);
+
+  void              Clear();
+
+  bool              isEnabled()const{return m_iMaxSize > 0;}
+
+  int               Size()const{return m_Paths.size();}
+  int               NumHits()const{return m_iNumHits;}
+  int               NumMisses()const{return m_iNumMisses;}
+};
+
+
+
+#endif
@@ -1,18 +1,22 @@
 #include "Raven_PathPlanner.h"
 #include "../Raven_Game.h"
 #include "misc/utils.h"
-#include "graph/GraphAlgorithms.h"
+#include "Graph/GraphAlgorithms.h"
 #include "misc/Cgdi.h"
 #include "../Raven_Bot.h"
 #include "../constants.h"
 #include "../Raven_UserOptions.h"
-#include "pathmanager.h"
+#include "PathManager.h"
+#include "Raven_PathCache.h"
+#include "Raven_ItemFlowFields.h"
+#include "Raven_ClosestNodeRaster.h"
+#include "Raven_PathSmoother.h"
 #include "SearchTerminationPolicies.h"
 #include "../lua/Raven_Scriptor.h"
 #include "misc/CellSpacePartition.h"
 #include "../Raven_Messages.h"
 #include "Messaging/MessageDispatcher.h"
-#include "graph/NodeTypeEnumerations.h"
+#include "Graph/NodeTypeEnumerations.h"
 
 
 #include "Debug/DebugConsole.h"
@@ -23,7 +27,13 @@
 //-----------------------------------------------------------------------------
 Raven_PathPlanner::Raven_PathPlanner(Raven_Bot* owner):m_pOwner(owner),
                m_NavGraph(m_pOwner->GetWorld()->GetMap()->GetNavGraph()),
-               m_pCurrentSearch(NULL)
+               m_CompactNavGraph(m_pOwner->GetWorld()->GetMap()->GetCompactNavGraph()),
+               m_pCurrentSearch(NULL),
+               m_pReplanner(NULL),
+               m_iLastTargetNode(no_closest_node_found),
+               m_dMinHierarchicalPathDistance(script->GetDouble("MinHierarchicalPathDistance")),
+               m_bCacheResult(false),
+               m_bPathPrepared(false)
 {
 }
 
@@ -32,6 +42,8 @@ Raven_PathPlanner::Raven_PathPlanner(Raven_Bot* owner):m_pOwner(owner),
 Raven_PathPlanner::~Raven_PathPlanner()
 {
   GetReadyForNewSearch();
+
+  delete m_pReplanner;
 }
 
 //------------------------------ GetReadyForNewSearch -----------------------------------
@@ -44,15 +56,50 @@ void Raven_PathPlanner::GetReadyForNewSearch()
   //unregister any existing search with the path manager
   m_pOwner->GetWorld()->GetPathManager()->UnRegister(this);
 
-  //clean up memory used by any existing search
-  delete m_pCurrentSearch;    
+  //clean up any existing search. This hands its workspace back to the
+  //path manager. The replanner is kept for the next request
+  if (m_pCurrentSearch != m_pReplanner) delete m_pCurrentSearch;
   m_pCurrentSearch = 0;
+
+  m_bCacheResult  = false;
+  m_bPathPrepared = false;
+}
+
+//------------------------------ UseCachedPath --------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathPlanner::UseCachedPath(int SearchType, int source, int target)
+{
+  Raven_Map* pMap = m_pOwner->GetWorld()->GetMap();
+
+  m_iDoorStamp = pMap->GetNumDoorStateChanges();
+
+  const Raven_PathCache::CachedPath* pPath = pMap->GetPathCache()->Find(SearchType,
+                                                                        source,
+                                                                        target,
+                                                                        m_iDoorStamp);
+
+  if (pPath)
+  {
+    m_pCurrentSearch = new Graph_SearchPrecalculated_TS<EdgeType>(
+                                  (Graph_SearchTimeSliced<EdgeType>::SearchType)SearchType,
+                                  pPath->Nodes,
+                                  pPath->Edges,
+                                  pPath->Cost);
+
+    return true;
+  }
+
+  m_bCacheResult = pMap->GetPathCache()->isEnabled();
+  m_iCacheSource = source;
+  m_iCacheTarget = target;
+
+  return false;
 }
 
 //---------------------------- GetCostToNode ----------------------------------
 //
 //  returns the cost to travel from the bot's current position to a specific 
- // graph node. This method makes use of the pre-calculated lookup table
+ // graph node. This method makes use of the map's cost oracle
 //-----------------------------------------------------------------------------
 double Raven_PathPlanner::GetCostToNode(unsigned int NodeIdx)const
 {
@@ -69,9 +116,8 @@ double Raven_PathPlanner::GetCostToNode(unsigned int NodeIdx)const
 
 //------------------------ GetCostToClosestItem ---------------------------
 //
-//  returns the cost to the closest instance of the giver type. This method
-//  makes use of the pre-calculated lookup table. Returns -1 if no active
-//  trigger found
+//  returns the cost to the closest instance of the giver type. This is read
+//  from the map's item flow fields. Returns -1 if no active trigger found
 //-----------------------------------------------------------------------------
 double Raven_PathPlanner::GetCostToClosestItem(unsigned int GiverType)const
 {
@@ -81,163 +127,235 @@ double Raven_PathPlanner::GetCostToClosestItem(unsigned int GiverType)const
   //if no closest node found return failure
   if (nd == invalid_node_index) return -1;
 
-  double ClosestSoFar = MaxDouble;
+  return m_pOwner->GetWorld()->GetMap()->GetItemFlowFields()->GetCostToItem(GiverType, nd);
+}
+
+
+//----------------------------- BuildPath ----------------------------------
+//
+//  extracts the path from m_pCurrentSearch and adds additional edges
+//  appropriate to the search type. A path planned on the hierarchical
+//  navgraph only has its first stretch refined. The path isn't smoothed
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::BuildPath()
+{
+  assert (m_pCurrentSearch && 
+          "<Raven_PathPlanner::BuildPath>: no current search");
 
-  //iterate through all the triggers to find the closest *active* trigger of 
-  //type GiverType
-  const Raven_Map::TriggerSystem::TriggerList& triggers = m_pOwner->GetWorld()->GetMap()->GetTriggers();
+  m_Path.clear();
+  m_Remainder = PathRemainder();
 
-  Raven_Map::TriggerSystem::TriggerList::const_iterator it;
-  for (it = triggers.begin(); it != triggers.end(); ++it)
+  if (m_pCurrentSearch->GetType() == Graph_SearchTimeSliced<EdgeType>::HierarchicalAStar)
   {
-    if ( ((*it)->EntityType() == GiverType) && (*it)->isActive())
+    typedef Graph_SearchHierarchical_TS<Raven_Map::HierarchicalNavGraph> HierarchicalSearch;
+
+    m_Remainder.m_Route        = static_cast<const HierarchicalSearch*>(m_pCurrentSearch)->GetRoute();
+    m_Remainder.m_vDestination = m_vDestinationPos;
+
+    //the route is a single node if the bot and the destination share their
+    //closest node
+    if (m_Remainder.empty())
     {
-      double cost = 
-      m_pOwner->GetWorld()->GetMap()->CalculateCostToTravelBetweenNodes(nd,
-                                                      (*it)->GraphNodeIndex());
+      m_Path.push_back(PathEdge(GetNodePosition(m_Remainder.m_Route.back()),
+                                m_vDestinationPos,
+                                NavGraphEdge::normal,
+                                0,
+                                m_Remainder.m_Route.back()));
+    }
 
-      if (cost < ClosestSoFar)
-      {
-        ClosestSoFar = cost;
-      }
+    else
+    {
+      RefineNextSegment(m_Remainder, m_Path);
     }
   }
 
-  //return a negative value if no active trigger of the type found
-  if (isEqual(ClosestSoFar, MaxDouble))
+  else
   {
-    return -1;
+    m_Path = m_pCurrentSearch->GetPathAsPathEdges();
   }
 
-  return ClosestSoFar;
-}
-
-
-//----------------------------- GetPath ------------------------------------
-//
-//  called by an agent after it has been notified that a search has terminated
-//  successfully. The method extracts the path from m_pCurrentSearch, adds
-//  additional edges appropriate to the search type and returns it as a list of
-//  PathEdges.
-//-----------------------------------------------------------------------------
-Raven_PathPlanner::Path Raven_PathPlanner::GetPath()
-{
-  assert (m_pCurrentSearch && 
-          "<Raven_PathPlanner::GetPathAsNodes>: no current search");
-
-  Path path =  m_pCurrentSearch->GetPathAsPathEdges();
-
   int closest = GetClosestNodeToPosition(m_pOwner->Pos());
 
-  path.push_front(PathEdge(m_pOwner->Pos(),
-                            GetNodePosition(closest),
-                            NavGraphEdge::normal));
+  m_Path.push_front(PathEdge(m_pOwner->Pos(),
+                             GetNodePosition(closest),
+                             NavGraphEdge::normal,
+                             0,
+                             invalid_node_index,
+                             closest));
 
   
   //if the bot requested a path to a location then an edge leading to the
   //destination must be added
   if (m_pCurrentSearch->GetType() == Graph_SearchTimeSliced<EdgeType>::AStar)
   {   
-    path.push_back(PathEdge(path.back().Destination(),
-                            m_vDestinationPos,
-                            NavGraphEdge::normal));
+    m_Path.push_back(PathEdge(m_Path.back().Destination(),
+                              m_vDestinationPos,
+                              NavGraphEdge::normal,
+                              0,
+                              m_Path.back().DestinationNode()));
   }
 
-  //smooth paths if required
+  m_bPathPrepared = true;
+}
+
+//---------------------------- PreparePaths -----------------------------------
+//
+//  the path manager calls this with the searches that have terminated in an
+//  update-step before any of the bots is told the results. The paths of
+//  those that found their targets are put together and then smoothed in one
+//  batch, on the pool's threads if one is given
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::PreparePaths(const std::vector<Raven_PathPlanner*>& planners,
+                                     const std::vector<int>&                results,
+                                     ThreadPool*                            pPool)
+{
+  std::vector<Raven_PathSmoother::PathToSmooth> batch;
+
+  for (unsigned int p=0; p<planners.size(); ++p)
+  {
+    if (results[p] != target_found) continue;
+
+    planners[p]->BuildPath();
+
+    batch.push_back(Raven_PathSmoother::PathToSmooth(&planners[p]->m_Path, planners[p]->m_pOwner));
+  }
+
+  if (batch.empty()) return;
+
+  Raven_PathSmoother* pSmoother = planners.front()->m_pOwner->GetWorld()->GetMap()->GetPathSmoother();
+
   if (UserOptions->m_bSmoothPathsQuick)
   {
-    SmoothPathEdgesQuick(path);
+    pSmoother->SmoothBatch(batch, Raven_PathSmoother::quick, pPool);
   }
 
   if (UserOptions->m_bSmoothPathsPrecise)
   {
-    SmoothPathEdgesPrecise(path);
+    pSmoother->SmoothBatch(batch, Raven_PathSmoother::precise, pPool);
   }
-
-  return path;
 }
 
-//--------------------------- SmoothPathEdgesQuick ----------------------------
+//----------------------------- GetPath ------------------------------------
 //
-//  smooths a path by removing extraneous edges.
+//  called by an agent after it has been notified that a search has terminated
+//  successfully. Returns the path prepared by PreparePaths, or prepares it
+//  now if the search was run without the path manager.
 //-----------------------------------------------------------------------------
-void Raven_PathPlanner::SmoothPathEdgesQuick(Path& path)
+Raven_PathPlanner::Path Raven_PathPlanner::GetPath(PathRemainder* pRemainder)
 {
-  //create a couple of iterators and point them at the front of the path
-  Path::iterator e1(path.begin()), e2(path.begin());
+  if (!m_bPathPrepared)
+  {
+    BuildPath();
 
-  //increment e2 so it points to the edge following e1.
-  ++e2;
+    SmoothPath(m_Path);
+  }
+
+  Path          path      = m_Path;
+  PathRemainder remainder = m_Remainder;
 
-  //while e2 is not the last edge in the path, step through the edges checking
-  //to see if the agent can move without obstruction from the source node of
-  //e1 to the destination node of e2. If the agent can move between those 
-  //positions then the two edges are replaced with a single edge.
-  while (e2 != path.end())
+  //a path planned on the hierarchical navgraph is handed over a stretch at
+  //a time if the caller can take the remainder, else all at once
+  if (pRemainder)
   {
-    //check for obstruction, adjust and remove the edges accordingly
-    if ( (e2->Behavior() == EdgeType::normal) &&
-          m_pOwner->canWalkBetween(e1->Source(), e2->Destination()) )
-    {
-      e1->SetDestination(e2->Destination());
-      e2 = path.erase(e2);
-    }
+    *pRemainder = remainder;
+  }
 
-    else
-    {
-      e1 = e2;
-      ++e2;
-    }
+  else while (!remainder.empty())
+  {
+    ExtendPath(remainder, path);
   }
+
+  return path;
 }
 
+//---------------------------- ExtendPath -------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::ExtendPath(PathRemainder& remainder, Path& path)
+{
+  if (remainder.empty()) return;
+
+  Path stretch;
 
-//----------------------- SmoothPathEdgesPrecise ---------------------------------
+  RefineNextSegment(remainder, stretch);
+
+  //the stretch is smoothed on its own so the edge the bot is following
+  //isn't changed under it
+  SmoothPath(stretch);
+
+  path.splice(path.end(), stretch);
+}
+
+//------------------------- RefineNextSegment ---------------------------------
 //
-//  smooths a path by removing extraneous edges.
+//  the hierarchy should always be able to refine a stretch of a route it has
+//  planned. If it can't, the stretch is found with A* over the whole navgraph
+//  rather than leaving a gap in the path, and if that fails too the rest of
+//  the route is dropped and the remainder marked as failed
 //-----------------------------------------------------------------------------
-void Raven_PathPlanner::SmoothPathEdgesPrecise(Path& path)
+void Raven_PathPlanner::RefineNextSegment(PathRemainder& remainder, Path& path)const
 {
-  //create a couple of iterators
-  Path::iterator e1, e2;
+  assert (!remainder.empty() && "<Raven_PathPlanner::RefineNextSegment>: nothing to refine");
+
+  const Raven_Map::HierarchicalNavGraph* pGraph = m_pOwner->GetWorld()->GetMap()->GetHierarchicalNavGraph();
 
-  //point e1 to the beginning of the path
-  e1 = path.begin();
-    
-  while (e1 != path.end())
+  const int from = remainder.m_Route[remainder.m_iNext];
+  const int to   = remainder.m_Route[remainder.m_iNext+1];
+
+  ++remainder.m_iNext;
+
+  std::vector<const EdgeType*> edges;
+
+  if (pGraph->RefineSegment(from, to, edges))
   {
-    //point e2 to the edge immediately following e1
-    e2 = e1; 
-    ++e2;
-
-    //while e2 is not the last edge in the path, step through the edges
-    //checking to see if the agent can move without obstruction from the 
-    //source node of e1 to the destination node of e2. If the agent can move
-    //between those positions then the any edges between e1 and e2 are
-    //replaced with a single edge.
-    while (e2 != path.end())
+    for (unsigned int e=0; e<edges.size(); ++e)
     {
-      //check for obstruction, adjust and remove the edges accordingly
-      if ( (e2->Behavior() == EdgeType::normal) &&
-            m_pOwner->canWalkBetween(e1->Source(), e2->Destination()) )
-      {
-        e1->SetDestination(e2->Destination());
-        e2 = path.erase(++e1, ++e2);
-        e1 = e2;
-        --e1;
-      }
+      path.push_back(PathEdge(GetNodePosition(edges[e]->From()),
+                              GetNodePosition(edges[e]->To()),
+                              edges[e]->Flags(),
+                              edges[e]->IDofIntersectingEntity(),
+                              edges[e]->From(),
+                              edges[e]->To()));
+    }
+  }
 
-      else
-      {
-        ++e2;
-      }
+  else
+  {
+    typedef Graph_SearchAStar_TS<Raven_Map::CompactNavGraph, Heuristic_Euclid> AStar;
+
+    AStar search(m_CompactNavGraph,
+                 from,
+                 to,
+                 m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());
+
+    int result;
+
+    do
+    {
+      result = search.CycleOnce();
     }
+    while (result == search_incomplete);
 
-    ++e1;
-  }
-}
+    if (result != target_found)
+    {
+      remainder.m_iNext   = remainder.m_Route.size() - 1;
+      remainder.m_bFailed = true;
 
+      return;
+    }
 
+    path.splice(path.end(), search.GetPathAsPathEdges());
+  }
+
+  //the last stretch ends at the destination
+  if (remainder.empty())
+  {
+    path.push_back(PathEdge(GetNodePosition(remainder.m_Route.back()),
+                            remainder.m_vDestination,
+                            NavGraphEdge::normal,
+                            0,
+                            remainder.m_Route.back()));
+  }
+}
 
 //---------------------------- CycleOnce --------------------------------------
 //
@@ -246,12 +364,54 @@ void Raven_PathPlanner::SmoothPathEdgesPrecise(Path& path)
 //-----------------------------------------------------------------------------
 int Raven_PathPlanner::CycleOnce()const
 {
-  assert (m_pCurrentSearch && "<Raven_PathPlanner::CycleOnce>: No search object instantiated");
+  int result = CycleSearchOnce();
+
+  NotifyOwnerOfResult(result);
+
+  return result;
+}
+
+//---------------------------- CycleSearchOnce --------------------------------
+//-----------------------------------------------------------------------------
+int Raven_PathPlanner::CycleSearchOnce()const
+{
+  assert (m_pCurrentSearch && "<Raven_PathPlanner::CycleSearchOnce>: No search object instantiated");
+
+  return m_pCurrentSearch->CycleOnce();
+}
+
+//-------------------------- NotifyOwnerOfResult ------------------------------
+//
+//  messages the owner with either Msg_NoPathAvailable or Msg_PathReady if
+//  the search has terminated
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::NotifyOwnerOfResult(int result)const
+{
+  typedef Graph_SearchHierarchical_TS<Raven_Map::HierarchicalNavGraph> HierarchicalSearch;
+
+  std::list<int> PathToTarget;
 
-  int result = m_pCurrentSearch->CycleOnce();
+  //a hierarchical path is refined as the bot follows it, so only its
+  //waypoints are looked at here
+  if (result == target_found)
+  {
+    if (m_pCurrentSearch->GetType() == Graph_SearchTimeSliced<EdgeType>::HierarchicalAStar)
+    {
+      const std::vector<int>& route = static_cast<const HierarchicalSearch*>(m_pCurrentSearch)->GetRoute();
+
+      PathToTarget.assign(route.begin(), route.end());
+    }
+
+    else
+    {
+      PathToTarget = m_pCurrentSearch->GetPathToTarget();
+    }
+  }
 
-  //let the bot know of the failure to find a path
-  if (result == target_not_found)
+  //let the bot know of the failure to find a path. A search that can't
+  //trace the path it found (a repaired search whose costs are inconsistent)
+  //has failed too
+  if (result == target_not_found || (result == target_found && PathToTarget.empty()))
   {
      Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
                              SENDER_ID_IRRELEVANT,
@@ -268,8 +428,24 @@ int Raven_PathPlanner::CycleOnce()const
     //represent a giver trigger. Consequently, it's worth passing the pointer
     //to the trigger in the extra info field of the message. (The pointer
     //will just be NULL if no trigger)
-    void* pTrigger = 
-    m_NavGraph.GetNode(m_pCurrentSearch->GetPathToTarget().back()).ExtraInfo();
+    void* pTrigger = m_NavGraph.GetNode(PathToTarget.back()).ExtraInfo();
+
+    //share the path with any other bots that want it
+    if (m_bCacheResult)
+    {
+      Raven_PathCache::CachedPath path;
+
+      path.Nodes = PathToTarget;
+      path.Edges = m_pCurrentSearch->GetPathAsPathEdges();
+      path.Cost  = m_pCurrentSearch->GetCostToTarget();
+
+      m_pOwner->GetWorld()->GetMap()->GetPathCache()->Store(
+                           m_pCurrentSearch->GetType(),
+                           m_iCacheSource,
+                           m_iCacheTarget,
+                           path,
+                           m_iDoorStamp);
+    }
 
     Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
                             SENDER_ID_IRRELEVANT,
@@ -277,8 +453,35 @@ int Raven_PathPlanner::CycleOnce()const
                             Msg_PathReady,
                             pTrigger);
   }
+}
 
-  return result;
+//------------------------------ SmoothPath -----------------------------------
+//
+//  smoothing is done by the map's path smoother, which knows which
+//  shortcuts between nodes can be walked for all the bots
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::SmoothPath(Path& path)const
+{
+  Raven_PathSmoother* pSmoother = m_pOwner->GetWorld()->GetMap()->GetPathSmoother();
+
+  if (UserOptions->m_bSmoothPathsQuick)
+  {
+    pSmoother->SmoothQuick(path, m_pOwner);
+  }
+
+  if (UserOptions->m_bSmoothPathsPrecise)
+  {
+    pSmoother->SmoothPrecise(path, m_pOwner);
+  }
+}
+
+//---------------------------- isSameOrNextTo ---------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathPlanner::isSameOrNextTo(int nd, int other)const
+{
+  if (nd == other) return true;
+
+  return other != no_closest_node_found && m_NavGraph.isEdgePresent(other, nd);
 }
 
 //------------------------ GetClosestNodeToPosition ---------------------------
@@ -287,8 +490,18 @@ int Raven_PathPlanner::CycleOnce()const
 //-----------------------------------------------------------------------------
 int Raven_PathPlanner::GetClosestNodeToPosition(Vector2D pos)const
 {
+  //for most positions a nearby node can be looked up. This is the node
+  //closest to the centre of pos's cell, which is walkable from pos but may
+  //not be the very closest. Only positions close to walls or doors need the
+  //nodes around them testing
+  int ClosestNode = m_pOwner->GetWorld()->GetMap()->GetClosestNodeRaster()->GetClosestNode(pos,
+                                                                      m_pOwner->BRadius());
+
+  if (ClosestNode != invalid_node_index) return ClosestNode;
+
+  ClosestNode = no_closest_node_found;
+
   double ClosestSoFar = MaxDouble;
-  int   ClosestNode  = no_closest_node_found;
 
   //when the cell space is queried this the the range searched for neighboring
   //graph nodes. This value is inversely proportional to the density of a 
@@ -332,7 +545,7 @@ int Raven_PathPlanner::GetClosestNodeToPosition(Vector2D pos)const
 //  method then returns true.
 //        
 //-----------------------------------------------------------------------------
-bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
+bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos, int priority)
 { 
   #ifdef SHOW_NAVINFO
     debug_con << "------------------------------------------------" << "";
@@ -390,15 +603,80 @@ bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
     debug_con << "Closest node to target is " << ClosestNodeToTarget << "";
 #endif
 
-  //create an instance of a the distributed A* search class
-  typedef Graph_SearchAStar_TS<Raven_Map::NavGraph, Heuristic_Euclid> AStar;
-   
-  m_pCurrentSearch = new AStar(m_NavGraph,
-                               ClosestNodeToBot,
-                               ClosestNodeToTarget);
+  //long paths across a large map are planned on the hierarchical navgraph.
+  //These aren't cached: the route is found on the first cycle over the small
+  //abstract graph, so a cache hit would save next to nothing, and caching
+  //the whole path would mean refining it up front instead of a stretch at a
+  //time as the bot follows it.
+  //Otherwise use the path if another bot has already found it, or create an
+  //instance of a the distributed A* search class. A* over a navgraph laid
+  //out as a grid uses jump point search, and a replan repairs the last search
+  typedef Graph_SearchAStar_TS<Raven_Map::CompactNavGraph, Heuristic_Euclid> AStar;
+  typedef Graph_SearchJPS_TS<Raven_Map::CompactNavGraph>                     JumpPointSearch;
+  typedef Graph_SearchHierarchical_TS<Raven_Map::HierarchicalNavGraph>       HierarchicalSearch;
+
+  const Raven_Map::HierarchicalNavGraph* pHierarchy = m_pOwner->GetWorld()->GetMap()->GetHierarchicalNavGraph();
+  const Raven_Map::NavGridLayout*        pGrid      = m_pOwner->GetWorld()->GetMap()->GetNavGridLayout();
+
+  //a request for a path to the same node as last time, or to one next to
+  //it, is a replan
+  const bool bReplan = isSameOrNextTo(ClosestNodeToTarget, m_iLastTargetNode);
+
+  m_iLastTargetNode = ClosestNodeToTarget;
+
+  if (pHierarchy &&
+      Vec2DDistance(m_pOwner->Pos(), TargetPos) > m_dMinHierarchicalPathDistance)
+  {
+    m_pCurrentSearch = new HierarchicalSearch(*pHierarchy,
+                                              ClosestNodeToBot,
+                                              ClosestNodeToTarget);
+  }
+
+  else if (!UseCachedPath(Graph_SearchTimeSliced<EdgeType>::AStar, ClosestNodeToBot, ClosestNodeToTarget))
+  {
+    //replans use D* Lite. The first search to a node costs about as much as
+    //A*, but each replan after it only expands the nodes whose cost to the
+    //target is affected by the bot or the target having moved
+    if (bReplan)
+    {
+      if (m_pReplanner && isSameOrNextTo(ClosestNodeToTarget, m_pReplanner->Target()))
+      {
+        m_pReplanner->MoveSource(ClosestNodeToBot);
+        m_pReplanner->MoveTarget(ClosestNodeToTarget);
+      }
+
+      else
+      {
+        delete m_pReplanner;
+
+        m_pReplanner = new Replanner(m_CompactNavGraph,
+                                     ClosestNodeToBot,
+                                     ClosestNodeToTarget,
+                                     m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());
+      }
+
+      m_pCurrentSearch = m_pReplanner;
+    }
+
+    else if (pGrid)
+    {
+      m_pCurrentSearch = new JumpPointSearch(*pGrid,
+                                             ClosestNodeToBot,
+                                             ClosestNodeToTarget,
+                                             m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());
+    }
+
+    else
+    {
+      m_pCurrentSearch = new AStar(m_CompactNavGraph,
+                                   ClosestNodeToBot,
+                                   ClosestNodeToTarget,
+                                   m_pOwner->GetWorld()->GetPathManager()->GetWorkspacePool());
+    }
+  }
 
   //and register the search with the path manager
-  m_pOwner->GetWorld()->GetPathManager()->Register(this);
+  m_pOwner->GetWorld()->GetPathManager()->Register(this, priority);
 
   return true;
 }
@@ -407,11 +685,13 @@ bool Raven_PathPlanner::RequestPathToPosition(Vector2D TargetPos)
 //------------------------------ RequestPathToItem -----------------------------
 //
 // Given an item type, this method determines the closest reachable graph node
-// to the bot's position and then creates a instance of the time-sliced 
-// Dijkstra's algorithm, which it registers with the search manager
+// to the bot's position and then reads the path to the nearest item of that
+// type from the map's item flow fields. The path is registered with the
+// search manager as a finished search so the bot is told of it in the usual
+// way
 //
 //-----------------------------------------------------------------------------
-bool Raven_PathPlanner::RequestPathToItem(unsigned int ItemType)
+bool Raven_PathPlanner::RequestPathToItem(unsigned int ItemType, int priority)
 {    
   //clear the waypoint list and delete any active search
   GetReadyForNewSearch();
@@ -432,16 +712,22 @@ bool Raven_PathPlanner::RequestPathToItem(unsigned int ItemType)
     return false; 
   }
 
-  //create an instance of the search algorithm
-  typedef FindActiveTrigger<Trigger<Raven_Bot> > t_con; 
-  typedef Graph_SearchDijkstras_TS<Raven_Map::NavGraph, t_con> DijSearch;
-  
-  m_pCurrentSearch = new DijSearch(m_NavGraph,
-                                   ClosestNodeToBot,
-                                   ItemType);  
+  //the path is empty if no item of the type can be reached
+  std::list<int>      path;
+  std::list<PathEdge> PathEdges;
+
+  double cost = m_pOwner->GetWorld()->GetMap()->GetItemFlowFields()->GetPathToItem(ItemType,
+                                                                                   ClosestNodeToBot,
+                                                                                   path,
+                                                                                   PathEdges);
+
+  m_pCurrentSearch = new Graph_SearchPrecalculated_TS<EdgeType>(Graph_SearchTimeSliced<EdgeType>::Dijkstra,
+                                                                path,
+                                                                PathEdges,
+                                                                cost);
 
   //register the search with the path manager
-  m_pOwner->GetWorld()->GetPathManager()->Register(this);
+  m_pOwner->GetWorld()->GetPathManager()->Register(this, priority);
 
   return true;
 }
@@ -10,7 +10,9 @@
 //  Desc:   class to handle the creation of paths through a navigation graph
 //-----------------------------------------------------------------------------
 #include <list>
+#include <vector>
 #include "TimeSlicedGraphAlgorithms.h"
+#include "PathManager.h"
 #include "Graph/GraphAlgorithms.h"
 #include "Graph/SparseGraph.h"
 #include "PathEdge.h"
@@ -27,12 +29,43 @@ private:
   //for legibility
   enum {no_closest_node_found = -1};
 
+  typedef Graph_SearchDStarLite_TS<Raven_Map::CompactNavGraph, Heuristic_Euclid> Replanner;
+
 public:
 
   //for ease of use typdef the graph edge/node types used by the navgraph
   typedef Raven_Map::NavGraph::EdgeType           EdgeType;
   typedef Raven_Map::NavGraph::NodeType           NodeType;
   typedef std::list<PathEdge>                     Path;
+
+  //the part of a path planned across the hierarchical navgraph that has not
+  //yet been refined into edges. See GetPath and ExtendPath
+  class PathRemainder
+  {
+  private:
+
+    friend class Raven_PathPlanner;
+
+    //the waypoints of the route and the one the refined path has reached
+    std::vector<int>  m_Route;
+    unsigned int      m_iNext;
+
+    //where the path ends
+    Vector2D          m_vDestination;
+
+    //true if a stretch of the route couldn't be refined
+    bool              m_bFailed;
+
+  public:
+
+    PathRemainder():m_iNext(0), m_bFailed(false){}
+
+    bool empty()const{return m_iNext + 1 >= m_Route.size();}
+
+    //true if the path stops short of the destination because a stretch of
+    //it couldn't be refined. The bot must ask for a new path
+    bool failed()const{return m_bFailed;}
+  };
   
 private:
 
@@ -42,24 +75,68 @@ private:
   //a reference to the navgraph
   const Raven_Map::NavGraph&          m_NavGraph;
 
+  //the same navgraph laid out for fast searching. All searches use this
+  const Raven_Map::CompactNavGraph&   m_CompactNavGraph;
+
   //a pointer to an instance of the current graph search algorithm.
   Graph_SearchTimeSliced<EdgeType>*  m_pCurrentSearch;
+
+  //the search for the last path to a position, kept so that it can be
+  //repaired if the bot asks for a path to the same place again, or to a
+  //place a node away. The node closest to the position last asked for is
+  //recorded to spot this
+  Replanner*                          m_pReplanner;
+  int                                 m_iLastTargetNode;
+
+  //requests for paths to positions further away than this are planned on
+  //the hierarchical navgraph, if the map has one
+  double                              m_dMinHierarchicalPathDistance;
   
   //this is the position the bot wishes to plan a path to reach
   Vector2D                            m_vDestinationPos;
 
+  //true if the result of the current search is to be stored in the path
+  //cache, under the given source and target. The door state changes at
+  //the time of the request are stored with it so a path found by a search
+  //that saw a door change is never used
+  bool                                m_bCacheResult;
+  int                                 m_iCacheSource;
+  int                                 m_iCacheTarget;
+  unsigned int                        m_iDoorStamp;
+
+  //the path found by the current search, ready to be handed to the bot,
+  //and what is left of it if it was planned on the hierarchical navgraph.
+  //See PreparePaths
+  Path                                m_Path;
+  PathRemainder                       m_Remainder;
+  bool                                m_bPathPrepared;
+
+  //returns true if nd is other or one of its neighbours
+  bool  isSameOrNextTo(int nd, int other)const;
+
+  //if the path cache holds the result of the given search this makes the
+  //current search one that returns it and returns true. Otherwise it notes
+  //the search so that its result can be cached
+  bool  UseCachedPath(int SearchType, int source, int target);
+
+
+  //appends the edges between the next two waypoints of a hierarchical path
+  //to path, and the edge to the destination if they are the last two. If
+  //there is no way between them the remainder is emptied and marked failed
+  void  RefineNextSegment(PathRemainder& remainder, Path& path)const;
+
 
   //returns the index of the closest visible and unobstructed graph node to
   //the given position
   int   GetClosestNodeToPosition(Vector2D pos)const;
 
-  //smooths a path by removing extraneous edges. (may not remove all
-  //extraneous edges)
-  void  SmoothPathEdgesQuick(Path& path);
+  //smooths the path if the user has asked for it
+  void  SmoothPath(Path& path)const;
 
-  //smooths a path by removing extraneous edges. (removes *all* extraneous
-  //edges)
-  void  SmoothPathEdgesPrecise(Path& path);
+  //puts together the path found by the current search in m_Path, without
+  //smoothing it. Only the first stretch of a path planned on the
+  //hierarchical navgraph is refined, the rest is left in m_Remainder
+  void  BuildPath();
 
   //called at the commencement of a new search request. It clears up the 
   //appropriate lists and memory in preparation for a new search request
@@ -74,18 +151,33 @@ public:
   Raven_PathPlanner(Raven_Bot* owner);
 
   //creates an instance of the A* time-sliced search and registers it with
-  //the path manager
-  bool       RequestPathToItem(unsigned int ItemType);
+  //the path manager. The priority is one of the search_priority enumerations
+  //from PathManager.h and decides how soon the search is carried out
+  bool       RequestPathToItem(unsigned int ItemType,
+                               int          priority = search_priority_normal);
 
   //creates an instance of the Dijkstra's time-sliced search and registers 
-  //it with the path manager
-  bool       RequestPathToPosition(Vector2D TargetPos);
+  //it with the path manager. If the bot asks for a path to the same place
+  //as last time, because it has strayed from the path or its target has
+  //only moved a little, the last search is repaired instead
+  bool       RequestPathToPosition(Vector2D TargetPos,
+                                   int      priority = search_priority_normal);
 
   //called by an agent after it has been notified that a search has terminated
-  //successfully. The method extracts the path from m_pCurrentSearch, adds
-  //additional edges appropriate to the search type and returns it as a list of
+  //successfully. The method returns the path found by m_pCurrentSearch, with
+  //the additional edges appropriate to the search type, as a list of
   //PathEdges.
-  Path       GetPath();
+  //
+  //If the path was planned on the hierarchical navgraph and pRemainder is
+  //given, only the first stretch of the path is refined into edges and
+  //returned. The rest is left in pRemainder for ExtendPath. If a stretch
+  //can't be refined the path stops short and pRemainder is marked failed
+  Path       GetPath(PathRemainder* pRemainder = NULL);
+
+  //refines the next stretch of the remainder of a path and appends it to
+  //path. Does nothing if the remainder is empty. If the stretch can't be
+  //refined the remainder is marked failed
+  void       ExtendPath(PathRemainder& remainder, Path& path);
 
   //returns the cost to travel from the bot's current position to a specific 
   //graph node. This method makes use of the pre-calculated lookup table
@@ -104,6 +196,21 @@ public:
   //msg_PathReady messages
   int        CycleOnce()const;
 
+  //the two halves of CycleOnce. CycleSearchOnce runs one cycle of the search
+  //without telling the bot the outcome, so the path manager may call it
+  //from a worker thread. NotifyOwnerOfResult must then be called from the
+  //main thread once the search has terminated
+  int        CycleSearchOnce()const;
+  void       NotifyOwnerOfResult(int result)const;
+
+  //the path manager calls this with the searches that have terminated in an
+  //update-step, and their results, before any bot is told of them. The
+  //paths found are put together and smoothed in one batch, shared out
+  //between the threads of the pool if one is given
+  static void PreparePaths(const std::vector<Raven_PathPlanner*>& planners,
+                           const std::vector<int>&                results,
+                           ThreadPool*                            pPool);
+
   Vector2D   GetDestination()const{return m_vDestinationPos;}
   void       SetDestination(Vector2D NewPos){m_vDestinationPos = NewPos;}
 
@@ -0,0 +1,271 @@
+#include "Raven_PathSmoother.h"
+#include "../Raven_Map.h"
+#include "../Raven_Bot.h"
+#include "../Raven_Door.h"
+#include "2D/geometry.h"
+#include "Graph/GraphEdgeTypes.h"
+#include "Graph/NodeTypeEnumerations.h"
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+
+
+//------------------------------- ctor ----------------------------------------
+//-----------------------------------------------------------------------------
+Raven_PathSmoother::Raven_PathSmoother(const Raven_Map& map,
+                                       int              MaxNodesForTable):m_Map(map),
+                                                                          m_iMaxNodesForTable(MaxNodesForTable),
+                                                                          m_dBoundingRadius(0.0),
+                                                                          m_iWordsPerRow(0),
+                                                                          m_iNumTests(0),
+                                                                          m_iNumSweeps(0),
+                                                                          m_iNumTableWalks(0),
+                                                                          m_iNumTableSweeps(0)
+{}
+
+//------------------------------ CreateTable ----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathSmoother::CreateTable(const Raven_Bot* pBot, ThreadPool& pool)
+{
+  const int NumNodes = m_Map.GetNavGraph().NumNodes();
+
+  if (NumNodes > m_iMaxNodesForTable) return;
+
+  m_iWordsPerRow = NumNodes / 32 + 1;
+
+  m_Walkable.assign(NumNodes * m_iWordsPerRow, 0);
+  m_NearDoor.assign(NumNodes * m_iWordsPerRow, 0);
+
+  m_dBoundingRadius = pBot->BRadius();
+  m_iNumTableWalks  = 0;
+  m_iNumTableSweeps = 0;
+
+  //the rows share no words so each can be filled in on its own thread
+  pool.ParallelFor(0, NumNodes, [this, pBot](int nd)
+  {
+    FillRow(nd, pBot);
+  });
+}
+
+//-------------------------------- FillRow ------------------------------------
+//
+//  the bot's sweep from one position to another can give a different answer
+//  to the sweep back, so the walks from nd to every node are swept rather
+//  than taking the walk back from the other node's row. Walks near a door
+//  are swept when they are asked about, so only their near door bit is set
+//  here
+//-----------------------------------------------------------------------------
+void Raven_PathSmoother::FillRow(int nd, const Raven_Bot* pBot)
+{
+  const Raven_Map::NavGraph& graph = m_Map.GetNavGraph();
+
+  const int row = nd * m_iWordsPerRow;
+
+  if (graph.GetNode(nd).Index() == invalid_node_index)
+  {
+    std::fill(m_NearDoor.begin() + row, m_NearDoor.begin() + row + m_iWordsPerRow, ~0u);
+
+    return;
+  }
+
+  const Vector2D A = graph.GetNode(nd).Pos();
+
+  for (int other=0; other<graph.NumNodes(); ++other)
+  {
+    const unsigned int bit  = 1u << (other % 32);
+    const int          word = row + other / 32;
+
+    if (graph.GetNode(other).Index() == invalid_node_index ||
+        isNearDoor(A, graph.GetNode(other).Pos(), m_dBoundingRadius))
+    {
+      m_NearDoor[word] |= bit;
+    }
+
+    else
+    {
+      ++m_iNumTableWalks;
+
+      if (Sweep(pBot, A, graph.GetNode(other).Pos(), m_iNumTableSweeps)) m_Walkable[word] |= bit;
+    }
+  }
+}
+
+//------------------------------ isNearDoor -----------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathSmoother::isNearDoor(Vector2D A,
+                                    Vector2D B,
+                                    double   BoundingRadius)const
+{
+  //a door's walls never stray more than a unit from where they lie when
+  //the door is closed
+  const double r = BoundingRadius + 1;
+
+  std::vector<Raven_Door*>::const_iterator curDoor = m_Map.GetDoors().begin();
+  for (curDoor; curDoor != m_Map.GetDoors().end(); ++curDoor)
+  {
+    if (DistBetweenLineSegmentsSq(A, B, (*curDoor)->ClosedFrom(), (*curDoor)->ClosedTo()) < r*r)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//---------------------------- canWalkBetween ---------------------------------
+//-----------------------------------------------------------------------------
+bool Raven_PathSmoother::canWalkBetween(const Raven_Bot* pBot,
+                                        Vector2D         A,
+                                        int              NodeA,
+                                        Vector2D         B,
+                                        int              NodeB)
+{
+  ++m_iNumTests;
+
+  if (NodeA != invalid_node_index && NodeB != invalid_node_index &&
+      pBot->BRadius() == m_dBoundingRadius)
+  {
+    const unsigned int bit  = 1u << (NodeB % 32);
+    const int          word = NodeA * m_iWordsPerRow + NodeB / 32;
+
+    //whether a bot can get past a door depends on whether it is open at the
+    //time, so those walks are always swept
+    if (!(m_NearDoor[word] & bit)) return (m_Walkable[word] & bit) != 0;
+  }
+
+  return Sweep(pBot, A, B, m_iNumSweeps);
+}
+
+//-------------------------------- Sweep --------------------------------------
+//
+//  the bot's sweep tests circles of its bounding radius spaced along the
+//  shortcut. They cover the whole shortcut, so a wall crossing it is sure
+//  to be hit (unless it is no longer than the radius, when nothing is
+//  tested), and they stay within the radius of it, so a wall further away
+//  than that can't be. Both are settled with a single query of the walls
+//  and only the shortcuts in between are swept
+//-----------------------------------------------------------------------------
+bool Raven_PathSmoother::Sweep(const Raven_Bot*  pBot,
+                               Vector2D          A,
+                               Vector2D          B,
+                               std::atomic<int>& NumSweeps)const
+{
+  const double r = pBot->BRadius();
+
+  if (Vec2DDistanceSq(A, B) > r*r && m_Map.GetWallSpace().isSegmentObstructed(A, B))
+  {
+    return false;
+  }
+
+  if (!m_Map.GetWallSpace().doesCapsuleIntersect(A, B, r)) return true;
+
+  ++NumSweeps;
+
+  return pBot->canWalkBetween(A, B);
+}
+
+//------------------------------ SmoothQuick ----------------------------------
+//
+//  smooths a path by removing extraneous edges.
+//-----------------------------------------------------------------------------
+void Raven_PathSmoother::SmoothQuick(std::list<PathEdge>& path, const Raven_Bot* pBot)
+{
+  //create a couple of iterators and point them at the front of the path
+  std::list<PathEdge>::iterator e1(path.begin()), e2(path.begin());
+
+  //increment e2 so it points to the edge following e1.
+  ++e2;
+
+  //while e2 is not the last edge in the path, step through the edges checking
+  //to see if the agent can move without obstruction from the source node of
+  //e1 to the destination node of e2. If the agent can move between those
+  //positions then the two edges are replaced with a single edge.
+  while (e2 != path.end())
+  {
+    //check for obstruction, adjust and remove the edges accordingly
+    if ( (e2->Behavior() == NavGraphEdge::normal) &&
+          canWalkBetween(pBot, e1->Source(), e1->SourceNode(), e2->Destination(), e2->DestinationNode()) )
+    {
+      e1->SetDestination(e2->Destination(), e2->DestinationNode());
+      e2 = path.erase(e2);
+    }
+
+    else
+    {
+      e1 = e2;
+      ++e2;
+    }
+  }
+}
+
+//----------------------------- SmoothPrecise ---------------------------------
+//
+//  smooths a path by removing extraneous edges.
+//-----------------------------------------------------------------------------
+void Raven_PathSmoother::SmoothPrecise(std::list<PathEdge>& path, const Raven_Bot* pBot)
+{
+  //create a couple of iterators
+  std::list<PathEdge>::iterator e1, e2;
+
+  //point e1 to the beginning of the path
+  e1 = path.begin();
+
+  while (e1 != path.end())
+  {
+    //point e2 to the edge immediately following e1
+    e2 = e1;
+    ++e2;
+
+    //while e2 is not the last edge in the path, step through the edges
+    //checking to see if the agent can move without obstruction from the
+    //source node of e1 to the destination node of e2. If the agent can move
+    //between those positions then the any edges between e1 and e2 are
+    //replaced with a single edge.
+    while (e2 != path.end())
+    {
+      //check for obstruction, adjust and remove the edges accordingly
+      if ( (e2->Behavior() == NavGraphEdge::normal) &&
+            canWalkBetween(pBot, e1->Source(), e1->SourceNode(), e2->Destination(), e2->DestinationNode()) )
+      {
+        e1->SetDestination(e2->Destination(), e2->DestinationNode());
+        e2 = path.erase(++e1, ++e2);
+        e1 = e2;
+        --e1;
+      }
+
+      else
+      {
+        ++e2;
+      }
+    }
+
+    ++e1;
+  }
+}
+
+//------------------------------ SmoothBatch ----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathSmoother::SmoothBatch(std::vector<PathToSmooth>& batch,
+                                     SmoothingMethod            method,
+                                     ThreadPool*                pPool)
+{
+  void (Raven_PathSmoother::*Smooth)(std::list<PathEdge>&, const Raven_Bot*) =
+    method == quick ? &Raven_PathSmoother::SmoothQuick : &Raven_PathSmoother::SmoothPrecise;
+
+  if (!pPool)
+  {
+    for (unsigned int p=0; p<batch.size(); ++p)
+    {
+      (this->*Smooth)(*batch[p].pPath, batch[p].pBot);
+    }
+
+    return;
+  }
+
+  //the table is only read, and the walls and doors stay put, so the paths
+  //can be smoothed at the same time
+  pPool->ParallelFor(0, (int)batch.size(), [this, &batch, Smooth](int p)
+  {
+    (this->*Smooth)(*batch[p].pPath, batch[p].pBot);
+  });
+}
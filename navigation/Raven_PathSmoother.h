@@ -0,0 +1,140 @@
+#ifndef RAVEN_PATHSMOOTHER_H
+#define RAVEN_PATHSMOOTHER_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_PathSmoother.h
+//
+//  Desc:   smooths the paths found by the bots' path planners by removing
+//          edges a bot can cut across.
+//
+//          Deciding whether an edge can be cut means sweeping the bot's
+//          bounding circle along the shortcut to see if it hits a wall.
+//          Most shortcuts run from one navgraph node to another, and as the
+//          walls don't move the answer for a pair of nodes never changes.
+//          So it is worked out for every pair when the map is loaded and
+//          kept in a table of bits shared by all the bots. Only shortcuts
+//          that start or end away from a node, or that pass near a door,
+//          are swept every time.
+//
+//          With the table filled in, smoothing a path precisely costs
+//          little more than smoothing it quickly. The paths of all the
+//          searches that finish in an update can be smoothed together in
+//          one batch, shared out between threads if there are any.
+//-----------------------------------------------------------------------------
+#include <list>
+#include <vector>
+#include <atomic>
+
+#include "2D/Vector2D.h"
+#include "PathEdge.h"
+
+class Raven_Map;
+class Raven_Bot;
+class ThreadPool;
+
+
+class Raven_PathSmoother
+{
+public:
+
+  enum SmoothingMethod {quick, precise};
+
+  //a path to be smoothed in a batch and the bot that is to follow it
+  struct PathToSmooth
+  {
+    std::list<PathEdge>*  pPath;
+    const Raven_Bot*      pBot;
+
+    PathToSmooth(std::list<PathEdge>* path, const Raven_Bot* bot):pPath(path), pBot(bot){}
+  };
+
+private:
+
+  const Raven_Map&   m_Map;
+
+  //the table is only kept for navgraphs with no more than this many nodes,
+  //as its size grows with the square of the number of nodes
+  int                m_iMaxNodesForTable;
+
+  //the bounding radius of the bots the table was filled in for. Zero until
+  //it has been
+  double             m_dBoundingRadius;
+
+  //a row of bits for each node, with a bit for every node. Each row starts
+  //on a new word so that rows can be filled in on different threads.
+  //m_Walkable records whether a bot can walk from the row's node to the
+  //other node and m_NearDoor whether the walk passes near a door, in which
+  //case the walkable bit isn't used
+  int                        m_iWordsPerRow;
+  std::vector<unsigned int>  m_Walkable;
+  std::vector<unsigned int>  m_NearDoor;
+
+  //counted from whichever thread is smoothing or filling in the table
+  std::atomic<int>   m_iNumTests;
+  std::atomic<int>   m_iNumSweeps;
+  std::atomic<int>   m_iNumTableWalks;
+  std::atomic<int>   m_iNumTableSweeps;
+
+  //fills in the row of the table for node nd
+  void FillRow(int nd, const Raven_Bot* pBot);
+
+  //returns true if any door could come within reach of a bot of the given
+  //bounding radius walking between A and B
+  bool isNearDoor(Vector2D A, Vector2D B, double BoundingRadius)const;
+
+  //returns true if the bot can walk between A and B, sweeping its bounding
+  //circle from one to the other, and counting the sweep in NumSweeps, only
+  //if a cheaper test can't tell
+  bool Sweep(const Raven_Bot*  pBot,
+             Vector2D          A,
+             Vector2D          B,
+             std::atomic<int>& NumSweeps)const;
+
+  //returns true if the bot can walk between the positions, which are the
+  //positions of the given nodes or invalid_node_index
+  bool canWalkBetween(const Raven_Bot* pBot,
+                      Vector2D         A,
+                      int              NodeA,
+                      Vector2D         B,
+                      int              NodeB);
+
+  Raven_PathSmoother(const Raven_PathSmoother&);
+  Raven_PathSmoother& operator=(const Raven_PathSmoother&);
+
+public:
+
+  Raven_PathSmoother(const Raven_Map& map, int MaxNodesForTable);
+
+  //fills in the table for bots the size of pBot, sharing the rows out
+  //between the threads of the pool. Nothing is done if the navgraph has
+  //more than MaxNodesForTable nodes. The walls and doors must be in place
+  void  CreateTable(const Raven_Bot* pBot, ThreadPool& pool);
+
+  //smooths a path by removing extraneous edges. (may not remove all
+  //extraneous edges)
+  void  SmoothQuick(std::list<PathEdge>& path, const Raven_Bot* pBot);
+
+  //smooths a path by removing extraneous edges. (removes *all* extraneous
+  //edges)
+  void  SmoothPrecise(std::list<PathEdge>& path, const Raven_Bot* pBot);
+
+  //smooths each path of the batch with the given method. If a pool is
+  //given the paths are shared out between its threads. Nothing must move
+  //and no door may open or close until this returns
+  void  SmoothBatch(std::vector<PathToSmooth>& batch,
+                    SmoothingMethod            method,
+                    ThreadPool*                pPool = NULL);
+
+  //the number of shortcuts tested while smoothing and the number of those
+  //that had to be swept, and likewise for the walks between nodes worked
+  //out to fill in the table
+  int   NumTests()const{return m_iNumTests;}
+  int   NumSweeps()const{return m_iNumSweeps;}
+  int   NumTableWalks()const{return m_iNumTableWalks;}
+  int   NumTableSweeps()const{return m_iNumTableSweeps;}
+};
+
+
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   SearchWorkspace.h
+//
+//  Desc:   the per node arrays a graph search works in, and a pool to keep
+//          them in between searches.
+//
+//          A search needs a cost, a priority, a frontier edge and a shortest
+//          path tree edge for every node in the graph, plus an indexed
+//          priority queue over them. An incremental search (D* Lite) also
+//          needs a one step lookahead cost. Creating these for every search
+//          means allocating and clearing several NumNodes() sized arrays
+//          just to look at the handful of nodes a short search visits.
+//
+//          A SearchWorkspace is allocated once and reused. Each node is
+//          stamped with the generation of the search that last wrote to it,
+//          and Reset starts a new generation, so a node left over from an
+//          earlier search reads as untouched without being cleared. Starting
+//          a search is therefore O(1) rather than O(NumNodes).
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+
+#include "misc/PriorityQueue.h"
+
+
+template <class edge_type>
+class SearchWorkspace
+{
+private:
+
+  //the generation each node was last written in
+  std::vector<unsigned int>      m_Generations;
+
+  unsigned int                   m_iGeneration;
+
+  //the value the priority queue orders nodes by
+  std::vector<double>            m_Keys;
+
+  //the cost to reach each node. Searches that order nodes by this cost
+  //(Dijkstra) use m_Keys for it instead
+  std::vector<double>            m_Costs;
+
+  //the one step lookahead cost of an incremental search (D* Lite's rhs)
+  std::vector<double>            m_Lookaheads;
+
+  std::vector<const edge_type*>  m_ShortestPathTree;
+  std::vector<const edge_type*>  m_SearchFrontier;
+
+  IndexedPriorityQLow<double>*   m_pPQ;
+
+  //gives a node left over from an earlier search its starting values
+  void Validate(int n)
+  {
+    if (m_Generations[n] != m_iGeneration)
+    {
+      m_Generations[n]      = m_iGeneration;
+      m_Keys[n]             = 0.0;
+      m_Costs[n]            = 0.0;
+      m_Lookaheads[n]       = 0.0;
+      m_ShortestPathTree[n] = NULL;
+      m_SearchFrontier[n]   = NULL;
+    }
+  }
+
+  SearchWorkspace(const SearchWorkspace&);
+  SearchWorkspace& operator=(const SearchWorkspace&);
+
+public:
+
+  SearchWorkspace(int NumNodes):m_iGeneration(0), m_pPQ(NULL)
+  {
+    Reset(NumNodes);
+  }
+
+  ~SearchWorkspace(){delete m_pPQ;}
+
+  //readies the workspace for a new search of a graph with NumNodes nodes.
+  //This only touches the arrays if the number of nodes has changed
+  void Reset(int NumNodes);
+
+  int  NumNodes()const{return m_Keys.size();}
+
+  bool isTouched(int n)const{return m_Generations[n] == m_iGeneration;}
+
+  //accessors used while searching
+  double&            Key(int n){Validate(n); return m_Keys[n];}
+  double&            Cost(int n){Validate(n); return m_Costs[n];}
+  double&            Lookahead(int n){Validate(n); return m_Lookaheads[n];}
+  const edge_type*&  SPT(int n){Validate(n); return m_ShortestPathTree[n];}
+  const edge_type*&  Frontier(int n){Validate(n); return m_SearchFrontier[n];}
+
+  IndexedPriorityQLow<double>& PQ(){return *m_pPQ;}
+
+  //accessors used to read the results of a search
+  double            Key(int n)const{return isTouched(n) ? m_Keys[n] : 0.0;}
+  double            Cost(int n)const{return isTouched(n) ? m_Costs[n] : 0.0;}
+  double            Lookahead(int n)const{return isTouched(n) ? m_Lookaheads[n] : 0.0;}
+  const edge_type*  SPT(int n)const{return isTouched(n) ? m_ShortestPathTree[n] : NULL;}
+
+  //returns a copy of the shortest path tree in the form the searches in
+  //GraphAlgorithms.h return it
+  std::vector<const edge_type*> GetSPT()const;
+};
+
+
+//------------------------------- Reset ---------------------------------------
+//-----------------------------------------------------------------------------
+template <class edge_type>
+void SearchWorkspace<edge_type>::Reset(int NumNodes)
+{
+  if (NumNodes != this->NumNodes() || m_pPQ == NULL)
+  {
+    m_Generations.assign(NumNodes, 0);
+    m_Keys.assign(NumNodes, 0.0);
+    m_Costs.assign(NumNodes, 0.0);
+    m_Lookaheads.assign(NumNodes, 0.0);
+    m_ShortestPathTree.assign(NumNodes, NULL);
+    m_SearchFrontier.assign(NumNodes, NULL);
+
+    delete m_pPQ;
+    m_pPQ = new IndexedPriorityQLow<double>(m_Keys, NumNodes);
+
+    m_iGeneration = 0;
+  }
+
+  ++m_iGeneration;
+
+  //after four billion searches the generation wraps around, so every node
+  //must be restamped to stop stale ones reading as current
+  if (m_iGeneration == 0)
+  {
+    m_Generations.assign(NumNodes, 0);
+
+    m_iGeneration = 1;
+  }
+
+  m_pPQ->clear();
+}
+
+//------------------------------- GetSPT --------------------------------------
+//-----------------------------------------------------------------------------
+template <class edge_type>
+std::vector<const edge_type*> SearchWorkspace<edge_type>::GetSPT()const
+{
+  std::vector<const edge_type*> spt(NumNodes(), NULL);
+
+  for (int n=0; n<NumNodes(); ++n)
+  {
+    spt[n] = SPT(n);
+  }
+
+  return spt;
+}
+
+
+//------------------------- SearchWorkspacePool -------------------------------
+//
+//  keeps the workspaces of finished searches so new searches can reuse them.
+//  A search acquires a workspace when it starts and releases it when it is
+//  destroyed, so the pool grows to the largest number of searches that have
+//  been active at once and then stops allocating. A search that is kept to
+//  be repaired (D* Lite) keeps its workspace until it is destroyed
+//-----------------------------------------------------------------------------
+template <class edge_type>
+class SearchWorkspacePool
+{
+private:
+
+  std::vector<SearchWorkspace<edge_type>*>  m_FreeWorkspaces;
+
+  //the number of workspaces handed out and not yet returned
+  int                                       m_iNumInUse;
+
+  SearchWorkspacePool(const SearchWorkspacePool&);
+  SearchWorkspacePool& operator=(const SearchWorkspacePool&);
+
+public:
+
+  SearchWorkspacePool():m_iNumInUse(0){}
+
+  ~SearchWorkspacePool()
+  {
+    assert (m_iNumInUse == 0 &&
+            "<SearchWorkspacePool::~SearchWorkspacePool>: workspaces still in use");
+
+    for (unsigned int w=0; w<m_FreeWorkspaces.size(); ++w)
+    {
+      delete m_FreeWorkspaces[w];
+    }
+  }
+
+  //returns a workspace ready for a search of a graph with NumNodes nodes
+  SearchWorkspace<edge_type>* Acquire(int NumNodes)
+  {
+    ++m_iNumInUse;
+
+    if (m_FreeWorkspaces.empty())
+    {
+      return new SearchWorkspace<edge_type>(NumNodes);
+    }
+
+    SearchWorkspace<edge_type>* pWorkspace = m_FreeWorkspaces.back();
+    m_FreeWorkspaces.pop_back();
+
+    pWorkspace->Reset(NumNodes);
+
+    return pWorkspace;
+  }
+
+  void Release(SearchWorkspace<edge_type>* pWorkspace)
+  {
+    assert (m_iNumInUse > 0 && "<SearchWorkspacePool::Release>: nothing to release");
+
+    --m_iNumInUse;
+
+    m_FreeWorkspaces.push_back(pWorkspace);
+  }
+
+  int NumInUse()const{return m_iNumInUse;}
+  int NumFree()const{return m_FreeWorkspaces.size();}
+};
+
+
+
+#endif
@@ -18,12 +18,18 @@
 #include <list>
 #include <queue>
 #include <stack>
+#include <set>
+#include <map>
+#include <algorithm>
 
-#include "graph/SparseGraph.h"
+#include "Graph/SparseGraph.h"
+#include "Graph/HierarchicalGraph.h"
+#include "Graph/GridLayout.h"
 #include "misc/PriorityQueue.h"
 #include "Graph/AStarHeuristicPolicies.h"
 #include "SearchTerminationPolicies.h"
 #include "PathEdge.h"
+#include "SearchWorkspace.h"
 
 
 
@@ -41,7 +47,7 @@ class Graph_SearchTimeSliced
 {
 public:
 
-  enum SearchType{AStar, Dijkstra};
+  enum SearchType{AStar, Dijkstra, HierarchicalAStar};
 
 private:
 
@@ -96,47 +102,48 @@ private:
 
   const graph_type&              m_Graph;
 
-  //indexed into my node. Contains the 'real' accumulative cost to that node
-  std::vector<double>            m_GCosts; 
+  //the per node arrays the search works in. A node's cost is the 'real'
+  //accumulative cost to that node (G) and its key, which the workspace's
+  //priority queue is ordered by, is G plus the heuristic cost from the
+  //node to the target (F)
+  SearchWorkspace<Edge>*         m_pWorkspace;
 
-  //indexed into by node. Contains the cost from adding m_GCosts[n] to
-  //the heuristic cost from n to the target node. This is the vector the
-  //iPQ indexes into.
-  std::vector<double>            m_FCosts;
-
-  std::vector<const Edge*>       m_ShortestPathTree;
-  std::vector<const Edge*>       m_SearchFrontier;
+  //the pool the workspace was borrowed from. NULL if the search created
+  //its own
+  SearchWorkspacePool<Edge>*     m_pPool;
 
   int                            m_iSource;
   int                            m_iTarget;
 
-  //create an indexed priority queue of nodes. The nodes with the
-  //lowest overall F cost (G+H) are positioned at the front.
-  IndexedPriorityQLow<double>*    m_pPQ;
+  const SearchWorkspace<Edge>&   Workspace()const{return *m_pWorkspace;}
 
  
 public:
 
-  Graph_SearchAStar_TS(const graph_type& G,
-                      int                source,
-                      int                target):Graph_SearchTimeSliced<Edge>(AStar),
+  Graph_SearchAStar_TS(const graph_type&          G,
+                      int                        source,
+                      int                        target,
+                      SearchWorkspacePool<Edge>* pPool = NULL):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
   
                                               m_Graph(G),
-                                              m_ShortestPathTree(G.NumNodes()),                              
-                                              m_SearchFrontier(G.NumNodes()),
-                                              m_GCosts(G.NumNodes(), 0.0),
-                                              m_FCosts(G.NumNodes(), 0.0),
+                                              m_pPool(pPool),
                                               m_iSource(source),
                                               m_iTarget(target)
   { 
-     //create the PQ   
-     m_pPQ =new IndexedPriorityQLow<double>(m_FCosts, m_Graph.NumNodes());
+    m_pWorkspace = m_pPool ? m_pPool->Acquire(m_Graph.NumNodes())
+                           : new SearchWorkspace<Edge>(m_Graph.NumNodes());
 
     //put the source node on the queue
-    m_pPQ->insert(m_iSource);
+    m_pWorkspace->Key(m_iSource) = 0.0;
+
+    m_pWorkspace->PQ().insert(m_iSource);
   }
 
-   ~Graph_SearchAStar_TS(){delete m_pPQ;}
+  ~Graph_SearchAStar_TS()
+  {
+    if (m_pPool) m_pPool->Release(m_pWorkspace);
+    else         delete m_pWorkspace;
+  }
 
 
   //When called, this method pops the next node off the PQ and examines all
@@ -145,7 +152,7 @@ public:
   int                      CycleOnce();
 
   //returns the vector of edges that the algorithm has examined
-  std::vector<const Edge*> GetSPT()const{return m_ShortestPathTree;}
+  std::vector<const Edge*> GetSPT()const{return Workspace().GetSPT();}
 
   //returns a vector of node indexes that comprise the shortest path
   //from the source to the target
@@ -155,24 +162,26 @@ public:
   std::list<PathEdge>    GetPathAsPathEdges()const;
 
   //returns the total cost to the target
-  double            GetCostToTarget()const{return m_GCosts[m_iTarget];}
+  double            GetCostToTarget()const{return Workspace().Cost(m_iTarget);}
 };
 
 //-----------------------------------------------------------------------------
 template <class graph_type, class heuristic>
 int Graph_SearchAStar_TS<graph_type, heuristic>::CycleOnce()
 {
+  SearchWorkspace<Edge>& ws = *m_pWorkspace;
+
   //if the PQ is empty the target has not been found
-  if (m_pPQ->empty())
+  if (ws.PQ().empty())
   {
     return target_not_found;
   }
 
   //get lowest cost node from the queue
-  int NextClosestNode = m_pPQ->Pop();
+  int NextClosestNode = ws.PQ().Pop();
 
   //put the node on the SPT
-  m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+  ws.SPT(NextClosestNode) = ws.Frontier(NextClosestNode);
 
   //if the target has been found exit
   if (NextClosestNode == m_iTarget)
@@ -181,7 +190,7 @@ int Graph_SearchAStar_TS<graph_type, heuristic>::CycleOnce()
   }
 
   //now to test all the edges attached to this node
-  graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+  typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
   for (const Edge* pE=ConstEdgeItr.begin();
       !ConstEdgeItr.end();
        pE=ConstEdgeItr.next())
@@ -190,31 +199,31 @@ int Graph_SearchAStar_TS<graph_type, heuristic>::CycleOnce()
     double HCost = heuristic::Calculate(m_Graph, m_iTarget, pE->To()); 
 
     //calculate the 'real' cost to this node from the source (G)
-    double GCost = m_GCosts[NextClosestNode] + pE->Cost();
+    double GCost = ws.Cost(NextClosestNode) + pE->Cost();
 
     //if the node has not been added to the frontier, add it and update
     //the G and F costs
-    if (m_SearchFrontier[pE->To()] == NULL)
+    if (ws.Frontier(pE->To()) == NULL)
     {
-      m_FCosts[pE->To()] = GCost + HCost;
-      m_GCosts[pE->To()] = GCost;
+      ws.Key(pE->To())  = GCost + HCost;
+      ws.Cost(pE->To()) = GCost;
 
-      m_pPQ->insert(pE->To());
+      ws.PQ().insert(pE->To());
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.Frontier(pE->To()) = pE;
     }
 
     //if this node is already on the frontier but the cost to get here
     //is cheaper than has been found previously, update the node
     //costs and frontier accordingly.
-    else if ((GCost < m_GCosts[pE->To()]) && (m_ShortestPathTree[pE->To()]==NULL))
+    else if ((GCost < ws.Cost(pE->To())) && (ws.SPT(pE->To())==NULL))
     {
-      m_FCosts[pE->To()] = GCost + HCost;
-      m_GCosts[pE->To()] = GCost;
+      ws.Key(pE->To())  = GCost + HCost;
+      ws.Cost(pE->To()) = GCost;
 
-      m_pPQ->ChangePriority(pE->To());
+      ws.PQ().ChangePriority(pE->To());
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.Frontier(pE->To()) = pE;
     }
   }
   
@@ -232,13 +241,15 @@ Graph_SearchAStar_TS<graph_type, heuristic>::GetPathToTarget()const
   //just return an empty path if no target or no path found
   if (m_iTarget < 0)  return path;    
 
+  const SearchWorkspace<Edge>& ws = Workspace();
+
   int nd = m_iTarget;
 
   path.push_back(nd);
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (ws.SPT(nd) != 0))
   {
-    nd = m_ShortestPathTree[nd]->From();
+    nd = ws.SPT(nd)->From();
 
     path.push_front(nd);
   }
@@ -260,16 +271,22 @@ Graph_SearchAStar_TS<graph_type, heuristic>::GetPathAsPathEdges()const
   //just return an empty path if no target or no path found
   if (m_iTarget < 0)  return path;    
 
+  const SearchWorkspace<Edge>& ws = Workspace();
+
   int nd = m_iTarget;
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (ws.SPT(nd) != 0))
   {
-    path.push_front(PathEdge(m_Graph.GetNode(m_ShortestPathTree[nd]->From()).Pos(),
-                             m_Graph.GetNode(m_ShortestPathTree[nd]->To()).Pos(),
-                             m_ShortestPathTree[nd]->Flags(),
-                             m_ShortestPathTree[nd]->IDofIntersectingEntity()));
+    const Edge* pE = ws.SPT(nd);
+
+    path.push_front(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                             m_Graph.GetNode(pE->To()).Pos(),
+                             pE->Flags(),
+                             pE->IDofIntersectingEntity(),
+                             pE->From(),
+                             pE->To()));
 
-    nd = m_ShortestPathTree[nd]->From();
+    nd = pE->From();
   }
 
   return path;
@@ -293,48 +310,49 @@ private:
 
   const graph_type&                   m_Graph;
 
-  //indexed into my node. Contains the accumulative cost to that node
-  std::vector<double>             m_CostToThisNode; 
+  //the per node arrays the search works in. A node's key, which the
+  //workspace's priority queue is ordered by, is the accumulative cost to
+  //that node
+  SearchWorkspace<Edge>*          m_pWorkspace;
 
-  std::vector<const Edge*>  m_ShortestPathTree;
-  std::vector<const Edge*>  m_SearchFrontier;
+  //the pool the workspace was borrowed from. NULL if the search created
+  //its own
+  SearchWorkspacePool<Edge>*      m_pPool;
 
   int                            m_iSource;
   int                            m_iTarget;
 
-  //create an indexed priority queue of nodes. The nodes with the
-  //lowest overall F cost (G+H) are positioned at the front.
-  IndexedPriorityQLow<double>*     m_pPQ;
+  const SearchWorkspace<Edge>&   Workspace()const{return *m_pWorkspace;}
 
  
 
 public:
 
-  Graph_SearchDijkstras_TS(const graph_type&  G,
-                          int                   source,
-                          int                   target):Graph_SearchTimeSliced<Edge>(Dijkstra),
+  Graph_SearchDijkstras_TS(const graph_type&          G,
+                          int                        source,
+                          int                        target,
+                          SearchWorkspacePool<Edge>* pPool = NULL):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::Dijkstra),
   
                                               m_Graph(G),
-                                              m_ShortestPathTree(G.NumNodes()),                              
-                                              m_SearchFrontier(G.NumNodes()),
-                                              m_CostToThisNode(G.NumNodes(), 0.0),
+                                              m_pPool(pPool),
                                               m_iSource(source),
                                               m_iTarget(target)
   { 
-     //create the PQ         ,
-     m_pPQ =new IndexedPriorityQLow<double>(m_CostToThisNode, m_Graph.NumNodes());
+    m_pWorkspace = m_pPool ? m_pPool->Acquire(m_Graph.NumNodes())
+                           : new SearchWorkspace<Edge>(m_Graph.NumNodes());
 
     //put the source node on the queue
-    m_pPQ->insert(m_iSource);
+    m_pWorkspace->Key(m_iSource) = 0.0;
+
+    m_pWorkspace->PQ().insert(m_iSource);
   }
 
-  //let the search class take care of tidying up memory (the wary amongst
-  //you may prefer to use std::auto_ptr or similar to replace the pointer
-  //to the termination condition)
-   ~Graph_SearchDijkstras_TS()
-   {
-     delete m_pPQ;
-   }
+  //hand the workspace back to the pool it came from
+  ~Graph_SearchDijkstras_TS()
+  {
+    if (m_pPool) m_pPool->Release(m_pWorkspace);
+    else         delete m_pWorkspace;
+  }
 
 
   //When called, this method pops the next node off the PQ and examines all
@@ -343,7 +361,7 @@ public:
   int              CycleOnce();
 
   //returns the vector of edges that the algorithm has examined
-  std::vector<const Edge*> GetSPT()const{return m_ShortestPathTree;}
+  std::vector<const Edge*> GetSPT()const{return Workspace().GetSPT();}
 
   //returns a vector of node indexes that comprise the shortest path
   //from the source to the target
@@ -353,24 +371,26 @@ public:
   std::list<PathEdge>    GetPathAsPathEdges()const;
 
   //returns the total cost to the target
-  double            GetCostToTarget()const{return m_CostToThisNode[m_iTarget];}
+  double            GetCostToTarget()const{return Workspace().Key(m_iTarget);}
 };
 
 //-----------------------------------------------------------------------------
 template <class graph_type, class termination_condition>
 int Graph_SearchDijkstras_TS<graph_type, termination_condition>::CycleOnce()
 {
+  SearchWorkspace<Edge>& ws = *m_pWorkspace;
+
   //if the PQ is empty the target has not been found
-  if (m_pPQ->empty())
+  if (ws.PQ().empty())
   {
     return target_not_found;
   }
 
   //get lowest cost node from the queue
-  int NextClosestNode = m_pPQ->Pop();
+  int NextClosestNode = ws.PQ().Pop();
 
   //move this node from the frontier to the spanning tree
-  m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+  ws.SPT(NextClosestNode) = ws.Frontier(NextClosestNode);
 
   //if the target has been found exit
   if (termination_condition::isSatisfied(m_Graph, m_iTarget, NextClosestNode))
@@ -384,25 +404,25 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::CycleOnce()
   }
 
   //now to test all the edges attached to this node
-  graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+  typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
   for (const Edge* pE=ConstEdgeItr.begin();
       !ConstEdgeItr.end();
        pE=ConstEdgeItr.next())
   {
     //the total cost to the node this edge points to is the cost to the
     //current node plus the cost of the edge connecting them.
-    double NewCost = m_CostToThisNode[NextClosestNode] + pE->Cost();
+    double NewCost = ws.Key(NextClosestNode) + pE->Cost();
 
     //if this edge has never been on the frontier make a note of the cost
     //to get to the node it points to, then add the edge to the frontier
     //and the destination node to the PQ.
-    if (m_SearchFrontier[pE->To()] == 0)
+    if (ws.Frontier(pE->To()) == 0)
     {
-      m_CostToThisNode[pE->To()] = NewCost;
+      ws.Key(pE->To()) = NewCost;
 
-      m_pPQ->insert(pE->To());
+      ws.PQ().insert(pE->To());
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.Frontier(pE->To()) = pE;
     }
 
     //else test to see if the cost to reach the destination node via the
@@ -410,16 +430,16 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::CycleOnce()
     //this path is cheaper, we assign the new cost to the destination
     //node, update its entry in the PQ to reflect the change and add the
     //edge to the frontier
-    else if ( (NewCost < m_CostToThisNode[pE->To()]) &&
-              (m_ShortestPathTree[pE->To()] == 0) )
+    else if ( (NewCost < ws.Key(pE->To())) &&
+              (ws.SPT(pE->To()) == 0) )
     {
-      m_CostToThisNode[pE->To()] = NewCost;
+      ws.Key(pE->To()) = NewCost;
 
       //because the cost is less than it was previously, the PQ must be
       //re-sorted to account for this.
-      m_pPQ->ChangePriority(pE->To());
+      ws.PQ().ChangePriority(pE->To());
 
-      m_SearchFrontier[pE->To()] = pE;
+      ws.Frontier(pE->To()) = pE;
     }
   }
   
@@ -437,13 +457,15 @@ Graph_SearchDijkstras_TS<graph_type, termination_condition>::GetPathToTarget()co
   //just return an empty path if no target or no path found
   if (m_iTarget < 0)  return path;    
 
+  const SearchWorkspace<Edge>& ws = Workspace();
+
   int nd = m_iTarget;
 
   path.push_back(nd);
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (ws.SPT(nd) != 0))
   {
-    nd = m_ShortestPathTree[nd]->From();
+    nd = ws.SPT(nd)->From();
 
     path.push_front(nd);
   }
@@ -465,19 +487,1159 @@ Graph_SearchDijkstras_TS<graph_type, termination_condition>::GetPathAsPathEdges(
   //just return an empty path if no target or no path found
   if (m_iTarget < 0)  return path;    
 
+  const SearchWorkspace<Edge>& ws = Workspace();
+
   int nd = m_iTarget;
     
-  while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+  while ((nd != m_iSource) && (ws.SPT(nd) != 0))
   {
-    path.push_front(PathEdge(m_Graph.GetNode(m_ShortestPathTree[nd]->From()).Pos(),
-                             m_Graph.GetNode(m_ShortestPathTree[nd]->To()).Pos(),
-                             m_ShortestPathTree[nd]->Flags(),
-                             m_ShortestPathTree[nd]->IDofIntersectingEntity()));
+    const Edge* pE = ws.SPT(nd);
+
+    path.push_front(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                             m_Graph.GetNode(pE->To()).Pos(),
+                             pE->Flags(),
+                             pE->IDofIntersectingEntity(),
+                             pE->From(),
+                             pE->To()));
     
-    nd = m_ShortestPathTree[nd]->From();
+    nd = pE->From();
+  }
+
+  return path;
+}
+
+//------------------------ Graph_SearchPrecalculated_TS -----------------------
+//
+//  stands in for a search whose result is already known, such as a path
+//  taken from a cache, so it can be handled like any other search. It finds
+//  its target on the first cycle, unless it was given an empty path. Nothing
+//  is known of the rest of the search so the shortest path tree it returns
+//  is empty
+//-----------------------------------------------------------------------------
+template <class edge_type>
+class Graph_SearchPrecalculated_TS : public Graph_SearchTimeSliced<edge_type>
+{
+private:
+
+  typedef typename Graph_SearchTimeSliced<edge_type>::SearchType SearchType;
+
+  std::list<int>       m_Path;
+  std::list<PathEdge>  m_PathEdges;
+
+  double               m_dCost;
+
+public:
+
+  //type is the type of search that originally found the path
+  Graph_SearchPrecalculated_TS(SearchType                 type,
+                               const std::list<int>&      path,
+                               const std::list<PathEdge>& PathEdges,
+                               double                     cost):Graph_SearchTimeSliced<edge_type>(type),
+                                                                m_Path(path),
+                                                                m_PathEdges(PathEdges),
+                                                                m_dCost(cost)
+  {}
+
+  //an empty path means there is no path to the target
+  int                           CycleOnce(){return m_Path.empty() ? target_not_found : target_found;}
+
+  std::vector<const edge_type*> GetSPT()const{return std::vector<const edge_type*>();}
+
+  double                        GetCostToTarget()const{return m_dCost;}
+
+  std::list<int>                GetPathToTarget()const{return m_Path;}
+
+  std::list<PathEdge>           GetPathAsPathEdges()const{return m_PathEdges;}
+};
+
+//------------------------ Graph_SearchHierarchical_TS ------------------------
+//
+//  plans a path across a HierarchicalGraph. The abstract graph is small
+//  enough for the whole route to be found on the first cycle. GetRoute
+//  returns the route's waypoints so the path between them can be refined a
+//  segment at a time, while GetPathToTarget and GetPathAsPathEdges refine
+//  all of it. The search only examines abstract edges so the shortest path
+//  tree it returns is empty
+//-----------------------------------------------------------------------------
+template <class hierarchical_graph_type>
+class Graph_SearchHierarchical_TS : public Graph_SearchTimeSliced<typename hierarchical_graph_type::EdgeType>
+{
+private:
+
+  typedef typename hierarchical_graph_type::EdgeType Edge;
+
+private:
+
+  const hierarchical_graph_type&  m_Graph;
+
+  int                             m_iSource;
+  int                             m_iTarget;
+
+  //the waypoints of the route, empty until it has been found
+  std::vector<int>                m_Route;
+
+  double                          m_dCost;
+
+  //fills edges with the edges of the whole path, source to target. Returns
+  //false, leaving edges empty, if a segment of the route can't be refined
+  bool                            RefineRoute(std::vector<const Edge*>& edges)const;
+
+public:
+
+  Graph_SearchHierarchical_TS(const hierarchical_graph_type& G,
+                              int                            source,
+                              int                            target):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::HierarchicalAStar),
+                                                                     m_Graph(G),
+                                                                     m_iSource(source),
+                                                                     m_iTarget(target),
+                                                                     m_dCost(0.0)
+  {}
+
+  int                      CycleOnce()
+  {
+    return m_Graph.FindRoute(m_iSource, m_iTarget, m_Route, m_dCost) ? target_found : target_not_found;
+  }
+
+  std::vector<const Edge*> GetSPT()const{return std::vector<const Edge*>();}
+
+  double                   GetCostToTarget()const{return m_dCost;}
+
+  std::list<int>           GetPathToTarget()const;
+
+  std::list<PathEdge>      GetPathAsPathEdges()const;
+
+  //the waypoints of the route across the abstract graph
+  const std::vector<int>&  GetRoute()const{return m_Route;}
+};
+
+//----------------------------- RefineRoute -----------------------------------
+//-----------------------------------------------------------------------------
+template <class hierarchical_graph_type>
+bool Graph_SearchHierarchical_TS<hierarchical_graph_type>::RefineRoute(std::vector<const Edge*>& edges)const
+{
+  std::vector<const Edge*> segment;
+
+  edges.clear();
+
+  for (unsigned int w=1; w<m_Route.size(); ++w)
+  {
+    if (!m_Graph.RefineSegment(m_Route[w-1], m_Route[w], segment))
+    {
+      edges.clear();
+
+      return false;
+    }
+
+    edges.insert(edges.end(), segment.begin(), segment.end());
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <class hierarchical_graph_type>
+std::list<int>
+Graph_SearchHierarchical_TS<hierarchical_graph_type>::GetPathToTarget()const
+{
+  std::list<int> path;
+
+  std::vector<const Edge*> edges;
+
+  //a path with a gap in it is no path at all
+  if (m_Route.empty() || !RefineRoute(edges)) return path;
+
+  path.push_back(m_Route.front());
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    path.push_back(edges[e]->To());
+  }
+
+  return path;
+}
+
+//-------------------------- GetPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class hierarchical_graph_type>
+std::list<PathEdge>
+Graph_SearchHierarchical_TS<hierarchical_graph_type>::GetPathAsPathEdges()const
+{
+  std::list<PathEdge> path;
+
+  std::vector<const Edge*> edges;
+
+  RefineRoute(edges);
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    path.push_back(PathEdge(m_Graph.GetGraph().GetNode(edges[e]->From()).Pos(),
+                            m_Graph.GetGraph().GetNode(edges[e]->To()).Pos(),
+                            edges[e]->Flags(),
+                            edges[e]->IDofIntersectingEntity(),
+                            edges[e]->From(),
+                            edges[e]->To()));
+  }
+
+  return path;
+}
+
+//---------------------------- Graph_SearchJPS_TS -----------------------------
+//
+//  A* with jump point search, for graphs laid out on a regular grid. On a
+//  grid many paths of equal cost lead between two nodes and plain A* ends
+//  up expanding most of the nodes along all of them. Jump point search
+//  instead moves in a straight line from each node it expands, skipping
+//  the nodes that can be reached as cheaply some other way, until it
+//  reaches one where the path might have to turn. Only those jump points
+//  go on the priority queue.
+//
+//  Each jump point's shortest path tree entry is the first edge of the
+//  jump that reached it, so the jump can be retraced to rebuild the path
+//  edge by edge. The search finds a path as cheap as A* would
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class Graph_SearchJPS_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
+{
+private:
+
+  typedef typename graph_type::EdgeType Edge;
+  typedef GridLayout<graph_type>        Grid;
+
+private:
+
+  const Grid&                    m_Grid;
+
+  //a node's cost is the cost to reach it from the source (G) and its key is
+  //G plus the distance from the node to the target (F)
+  SearchWorkspace<Edge>*         m_pWorkspace;
+
+  //the pool the workspace was borrowed from. NULL if the search created
+  //its own
+  SearchWorkspacePool<Edge>*     m_pPool;
+
+  int                            m_iSource;
+  int                            m_iTarget;
+
+  //the target's cell
+  int                            m_iTargetColumn;
+  int                            m_iTargetRow;
+
+  const SearchWorkspace<Edge>&   Workspace()const{return *m_pWorkspace;}
+
+  Vector2D         Pos(int nd)const{return m_Grid.GetGraph().GetNode(nd).Pos();}
+
+  //moves from the given cell in the given direction and returns the node of
+  //the first jump point reached, or invalid_node_index if the jump runs into
+  //an empty cell
+  int              Jump(int col, int row, int dc, int dr)const;
+
+  //adds the jump point reached from node in the given direction to the
+  //frontier, or updates its cost if the jump is cheaper
+  void             AddJumpPoint(int nd, int JumpPoint, int dc, int dr);
+
+  //appends the edges of the jump that leads to a jump point to edges, in
+  //reverse order, and returns the node the jump started from
+  int              RetraceJump(int JumpPoint, std::vector<const Edge*>& edges)const;
+
+public:
+
+  //the grid must be a grid (see GridLayout::isGrid)
+  Graph_SearchJPS_TS(const Grid&                G,
+                     int                        source,
+                     int                        target,
+                     SearchWorkspacePool<Edge>* pPool = NULL):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
+                                                              m_Grid(G),
+                                                              m_pPool(pPool),
+                                                              m_iSource(source),
+                                                              m_iTarget(target),
+                                                              m_iTargetColumn(G.Column(target)),
+                                                              m_iTargetRow(G.Row(target))
+  {
+    assert (G.isGrid() && "<Graph_SearchJPS_TS::ctor>: the graph isn't a grid");
+
+    m_pWorkspace = m_pPool ? m_pPool->Acquire(m_Grid.GetGraph().NumNodes())
+                           : new SearchWorkspace<Edge>(m_Grid.GetGraph().NumNodes());
+
+    m_pWorkspace->Key(m_iSource) = 0.0;
+
+    m_pWorkspace->PQ().insert(m_iSource);
+  }
+
+  ~Graph_SearchJPS_TS()
+  {
+    if (m_pPool) m_pPool->Release(m_pWorkspace);
+    else         delete m_pWorkspace;
+  }
+
+  //pops the next jump point off the PQ and jumps from it in each direction
+  //the path might continue in
+  int                      CycleOnce();
+
+  std::vector<const Edge*> GetSPT()const{return Workspace().GetSPT();}
+
+  std::list<int>           GetPathToTarget()const;
+
+  std::list<PathEdge>      GetPathAsPathEdges()const;
+
+  double                   GetCostToTarget()const{return Workspace().Cost(m_iTarget);}
+};
+
+//-------------------------------- Jump ---------------------------------------
+//
+//  a jump stops at the target, or where a neighbouring cell can only be
+//  reached cheaply through the current one (a forced neighbour). A diagonal
+//  jump also stops where a straight jump from it would stop
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int Graph_SearchJPS_TS<graph_type>::Jump(int col, int row, int dc, int dr)const
+{
+  for (;;)
+  {
+    col += dc;
+    row += dr;
+
+    if (!m_Grid.isOpen(col, row)) return invalid_node_index;
+
+    if (col == m_iTargetColumn && row == m_iTargetRow) return m_iTarget;
+
+    if (dc != 0 && dr != 0)
+    {
+      if ((m_Grid.isOpen(col-dc, row+dr) && !m_Grid.isOpen(col-dc, row)) ||
+          (m_Grid.isOpen(col+dc, row-dr) && !m_Grid.isOpen(col, row-dr)))
+      {
+        return m_Grid.NodeAt(col, row);
+      }
+
+      if (Jump(col, row, dc, 0) != invalid_node_index ||
+          Jump(col, row, 0, dr) != invalid_node_index)
+      {
+        return m_Grid.NodeAt(col, row);
+      }
+    }
+
+    else if (dc != 0)
+    {
+      if ((m_Grid.isOpen(col+dc, row+1) && !m_Grid.isOpen(col, row+1)) ||
+          (m_Grid.isOpen(col+dc, row-1) && !m_Grid.isOpen(col, row-1)))
+      {
+        return m_Grid.NodeAt(col, row);
+      }
+    }
+
+    else
+    {
+      if ((m_Grid.isOpen(col+1, row+dr) && !m_Grid.isOpen(col+1, row)) ||
+          (m_Grid.isOpen(col-1, row+dr) && !m_Grid.isOpen(col-1, row)))
+      {
+        return m_Grid.NodeAt(col, row);
+      }
+    }
+  }
+}
+
+//---------------------------- AddJumpPoint -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void Graph_SearchJPS_TS<graph_type>::AddJumpPoint(int nd, int JumpPoint, int dc, int dr)
+{
+  SearchWorkspace<Edge>& ws = *m_pWorkspace;
+
+  if (JumpPoint == m_iSource || ws.SPT(JumpPoint) != NULL) return;
+
+  //a jump is a straight line of edges each costing the distance they
+  //span, so it costs the distance between its ends
+  const double GCost = ws.Cost(nd) + Vec2DDistance(Pos(nd), Pos(JumpPoint));
+  const double HCost = Vec2DDistance(Pos(JumpPoint), Pos(m_iTarget));
+
+  const Edge* pFirstEdge = m_Grid.GetEdge(nd, m_Grid.NodeAt(m_Grid.Column(nd) + dc,
+                                                            m_Grid.Row(nd) + dr));
+
+  if (ws.Frontier(JumpPoint) == NULL)
+  {
+    ws.Key(JumpPoint)      = GCost + HCost;
+    ws.Cost(JumpPoint)     = GCost;
+    ws.Frontier(JumpPoint) = pFirstEdge;
+
+    ws.PQ().insert(JumpPoint);
+  }
+
+  else if (GCost < ws.Cost(JumpPoint))
+  {
+    ws.Key(JumpPoint)      = GCost + HCost;
+    ws.Cost(JumpPoint)     = GCost;
+    ws.Frontier(JumpPoint) = pFirstEdge;
+
+    ws.PQ().ChangePriority(JumpPoint);
+  }
+}
+
+//----------------------------- CycleOnce -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int Graph_SearchJPS_TS<graph_type>::CycleOnce()
+{
+  SearchWorkspace<Edge>& ws = *m_pWorkspace;
+
+  if (ws.PQ().empty())
+  {
+    return target_not_found;
+  }
+
+  const int nd = ws.PQ().Pop();
+
+  ws.SPT(nd) = ws.Frontier(nd);
+
+  if (nd == m_iTarget)
+  {
+    return target_found;
+  }
+
+  const int col = m_Grid.Column(nd);
+  const int row = m_Grid.Row(nd);
+
+  //the directions worth jumping in, as pairs of column and row steps
+  int Directions[8][2];
+  int NumDirections = 0;
+
+  if (nd == m_iSource)
+  {
+    for (int dr=-1; dr<2; ++dr)
+    {
+      for (int dc=-1; dc<2; ++dc)
+      {
+        if (dc == 0 && dr == 0) continue;
+
+        Directions[NumDirections][0] = dc;
+        Directions[NumDirections][1] = dr;
+        ++NumDirections;
+      }
+    }
+  }
+
+  else
+  {
+    //the direction of the jump that reached this node
+    const int dc = m_Grid.Column(ws.SPT(nd)->To()) - m_Grid.Column(ws.SPT(nd)->From());
+    const int dr = m_Grid.Row(ws.SPT(nd)->To())    - m_Grid.Row(ws.SPT(nd)->From());
+
+    auto AddDirection = [&](int c, int r)
+    {
+      Directions[NumDirections][0] = c;
+      Directions[NumDirections][1] = r;
+      ++NumDirections;
+    };
+
+    if (dc != 0 && dr != 0)
+    {
+      AddDirection(dc, dr);
+      AddDirection(dc, 0);
+      AddDirection(0, dr);
+
+      if (!m_Grid.isOpen(col-dc, row)) AddDirection(-dc, dr);
+      if (!m_Grid.isOpen(col, row-dr)) AddDirection(dc, -dr);
+    }
+
+    else if (dc != 0)
+    {
+      AddDirection(dc, 0);
+
+      if (!m_Grid.isOpen(col, row+1)) AddDirection(dc, 1);
+      if (!m_Grid.isOpen(col, row-1)) AddDirection(dc, -1);
+    }
+
+    else
+    {
+      AddDirection(0, dr);
+
+      if (!m_Grid.isOpen(col+1, row)) AddDirection(1, dr);
+      if (!m_Grid.isOpen(col-1, row)) AddDirection(-1, dr);
+    }
+  }
+
+  for (int d=0; d<NumDirections; ++d)
+  {
+    const int JumpPoint = Jump(col, row, Directions[d][0], Directions[d][1]);
+
+    if (JumpPoint != invalid_node_index)
+    {
+      AddJumpPoint(nd, JumpPoint, Directions[d][0], Directions[d][1]);
+    }
+  }
+
+  return search_incomplete;
+}
+
+//----------------------------- RetraceJump -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int Graph_SearchJPS_TS<graph_type>::RetraceJump(int                       JumpPoint,
+                                                std::vector<const Edge*>& edges)const
+{
+  const Edge* pFirst = Workspace().SPT(JumpPoint);
+
+  const int dc = m_Grid.Column(pFirst->To()) - m_Grid.Column(pFirst->From());
+  const int dr = m_Grid.Row(pFirst->To())    - m_Grid.Row(pFirst->From());
+
+  //step back along the jump from its end to its start
+  int nd = JumpPoint;
+
+  while (nd != pFirst->To())
+  {
+    const int prev = m_Grid.NodeAt(m_Grid.Column(nd) - dc, m_Grid.Row(nd) - dr);
+
+    edges.push_back(m_Grid.GetEdge(prev, nd));
+
+    nd = prev;
+  }
+
+  edges.push_back(pFirst);
+
+  return pFirst->From();
+}
+
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::list<int>
+Graph_SearchJPS_TS<graph_type>::GetPathToTarget()const
+{
+  std::list<int> path;
+
+  if (m_iTarget < 0) return path;
+
+  path.push_back(m_iTarget);
+
+  std::vector<const Edge*> edges;
+
+  int nd = m_iTarget;
+
+  while (nd != m_iSource && Workspace().SPT(nd) != NULL)
+  {
+    nd = RetraceJump(nd, edges);
+  }
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    path.push_front(edges[e]->From());
+  }
+
+  return path;
+}
+
+//-------------------------- GetPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::list<PathEdge>
+Graph_SearchJPS_TS<graph_type>::GetPathAsPathEdges()const
+{
+  std::list<PathEdge> path;
+
+  if (m_iTarget < 0) return path;
+
+  std::vector<const Edge*> edges;
+
+  int nd = m_iTarget;
+
+  while (nd != m_iSource && Workspace().SPT(nd) != NULL)
+  {
+    nd = RetraceJump(nd, edges);
+  }
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    path.push_front(PathEdge(Pos(edges[e]->From()),
+                             Pos(edges[e]->To()),
+                             edges[e]->Flags(),
+                             edges[e]->IDofIntersectingEntity(),
+                             edges[e]->From(),
+                             edges[e]->To()));
+  }
+
+  return path;
+}
+
+//------------------------ Graph_SearchDStarLite_TS ---------------------------
+//
+//  D* Lite. It searches back from the target to the source, and the costs
+//  it finds are kept when the search terminates so the search can be
+//  repaired rather than repeated. If the source moves (the bot has moved
+//  along the path or strayed from it), the target moves or an edge's cost
+//  changes, only the nodes whose cost to the target is affected are
+//  expanded again, so the work done scales with the size of the change
+//  rather than the map.
+//
+//  Call MoveSource, MoveTarget or SetEdgeCost and cycle the search again to
+//  replan.
+//
+//  Each node has a cost to the target (g) and a one step lookahead cost
+//  (rhs). A node is on the queue while they differ. Keys are ordered by
+//  their first element and then their second, so the queue is a std::set
+//  rather than an IndexedPriorityQLow. The per node values are kept in a
+//  SearchWorkspace, which the search holds for as long as it exists. The
+//  graph must be undirected
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+class Graph_SearchDStarLite_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
+{
+private:
+
+  typedef typename graph_type::EdgeType Edge;
+
+  typedef std::pair<double, double>     Key;
+  typedef std::pair<Key, int>           QueueEntry;
+
+  //the first element of the key of a node that isn't queued
+  enum {not_queued = -1};
+
+private:
+
+  const graph_type&               m_Graph;
+
+  int                             m_iSource;
+  int                             m_iTarget;
+
+  //the amount the first elements of the keys on the queue have fallen
+  //short by since the source moved
+  double                          m_dKeyModifier;
+
+  //the per node values. A node's cost is g, its lookahead is rhs and its
+  //key is the first element of the key it was queued with. The second
+  //element is always min(g, rhs), because a node is taken off the queue
+  //before either is changed
+  SearchWorkspace<Edge>*          m_pWorkspace;
+
+  //the pool the workspace was borrowed from. NULL if the search created
+  //its own
+  SearchWorkspacePool<Edge>*      m_pPool;
+
+  //the nodes waiting to be expanded
+  std::set<QueueEntry>            m_Queue;
+
+  //used by MoveTarget to collect the nodes whose costs are kept. It is
+  //kept between calls so it only allocates while it grows
+  std::vector<int>                m_Subtree;
+
+  //edge costs that differ from those in the graph
+  std::map<std::pair<int, int>, double>  m_CostOverrides;
+
+  //the number of nodes expanded since the search was created
+  int                             m_iNumExpansions;
+
+  //a node the search has yet to reach reads as unreachable and unqueued
+  double           G(int nd)const{return m_pWorkspace->isTouched(nd) ? m_pWorkspace->Cost(nd) : MaxDouble;}
+  double           RHS(int nd)const{return m_pWorkspace->isTouched(nd) ? m_pWorkspace->Lookahead(nd) : MaxDouble;}
+  bool             isQueued(int nd)const{return m_pWorkspace->isTouched(nd) && m_pWorkspace->Key(nd) != not_queued;}
+
+  void             SetG(int nd, double g){Touch(nd); m_pWorkspace->Cost(nd) = g;}
+  void             SetRHS(int nd, double rhs){Touch(nd); m_pWorkspace->Lookahead(nd) = rhs;}
+  void             Touch(int nd);
+
+  double           EdgeCost(const Edge* pE)const;
+
+  Key              CalculateKey(int nd)const;
+
+  //the first elements of the keys are sums of edge costs and straight
+  //line distances. The costs are rounded (a map file stores them to six
+  //figures), so two keys that should be equal can differ slightly either
+  //way. Read as unequal, a node that could still raise the source's cost
+  //is taken for one that can't and the search stops early with too low a
+  //cost. This treats first elements within the rounding as equal and
+  //decides by the second elements
+  static bool      isLess(const Key& lhs, const Key& rhs);
+
+  //the amount two keys' first elements can differ by through rounding
+  static double    Rounding(const Key& lhs, const Key& rhs){return 1e-5 * std::max(lhs.first, rhs.first);}
+
+  //returns true if a node on the queue has a key less than key by isLess.
+  //The queue is ordered exactly, so that node isn't always at the front:
+  //every node whose key is within the rounding of key is looked at
+  bool             isQueuedBefore(const Key& key)const;
+
+  void             Enqueue(int nd);
+  void             Dequeue(int nd);
+
+  //recalculates a node's rhs and queues it if it has become inconsistent
+  void             UpdateNode(int nd);
+
+  //returns the edge leading from nd towards the target on the cheapest
+  //path, or NULL if the target can't be reached from nd
+  const Edge*      BestEdgeFrom(int nd)const;
+
+  //returns the edges from the source to the target, or an empty vector if
+  //following the cheapest edges doesn't lead there
+  std::vector<const Edge*> GetPathEdges()const;
+
+  Graph_SearchDStarLite_TS(const Graph_SearchDStarLite_TS&);
+  Graph_SearchDStarLite_TS& operator=(const Graph_SearchDStarLite_TS&);
+
+public:
+
+  Graph_SearchDStarLite_TS(const graph_type&          G,
+                           int                        source,
+                           int                        target,
+                           SearchWorkspacePool<Edge>* pPool = NULL);
+
+  ~Graph_SearchDStarLite_TS()
+  {
+    if (m_pPool) m_pPool->Release(m_pWorkspace);
+    else         delete m_pWorkspace;
+  }
+
+  //the source has moved to NewSource. The search must be cycled again
+  void                     MoveSource(int NewSource);
+
+  //the target has moved to NewTarget. The search must be cycled again. The
+  //more of the old search's nodes lie beyond the new target the less there
+  //is to repair
+  void                     MoveTarget(int NewTarget);
+
+  //changes the cost of the edges joining two nodes. The search must be
+  //cycled again
+  void                     SetEdgeCost(int from, int to, double cost);
+
+  int                      CycleOnce();
+
+  std::vector<const Edge*> GetSPT()const;
+
+  std::list<int>           GetPathToTarget()const;
+
+  std::list<PathEdge>      GetPathAsPathEdges()const;
+
+  double                   GetCostToTarget()const{return G(m_iSource);}
+
+  int                      Source()const{return m_iSource;}
+  int                      Target()const{return m_iTarget;}
+
+  int                      NumExpansions()const{return m_iNumExpansions;}
+};
+
+//-------------------------------- ctor ---------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+Graph_SearchDStarLite_TS<graph_type, heuristic>::Graph_SearchDStarLite_TS(const graph_type&          G,
+                                                                          int                        source,
+                                                                          int                        target,
+                                                                          SearchWorkspacePool<Edge>* pPool):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
+                                                                                                            m_Graph(G),
+                                                                                                            m_iSource(source),
+                                                                                                            m_iTarget(target),
+                                                                                                            m_dKeyModifier(0.0),
+                                                                                                            m_pPool(pPool),
+                                                                                                            m_iNumExpansions(0)
+{
+  assert (!G.isDigraph() && "<Graph_SearchDStarLite_TS::ctor>: the graph must be undirected");
+
+  m_pWorkspace = m_pPool ? m_pPool->Acquire(m_Graph.NumNodes())
+                         : new SearchWorkspace<Edge>(m_Graph.NumNodes());
+
+  SetRHS(m_iTarget, 0.0);
+
+  Enqueue(m_iTarget);
+}
+
+//-------------------------------- Touch --------------------------------------
+//
+//  gives a node the search has yet to reach its starting values
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::Touch(int nd)
+{
+  if (m_pWorkspace->isTouched(nd)) return;
+
+  m_pWorkspace->Cost(nd)      = MaxDouble;
+  m_pWorkspace->Lookahead(nd) = MaxDouble;
+  m_pWorkspace->Key(nd)       = not_queued;
+}
+
+//------------------------------- EdgeCost ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+double Graph_SearchDStarLite_TS<graph_type, heuristic>::EdgeCost(const Edge* pE)const
+{
+  if (m_CostOverrides.empty()) return pE->Cost();
+
+  std::map<std::pair<int, int>, double>::const_iterator it =
+    m_CostOverrides.find(std::make_pair(pE->From(), pE->To()));
+
+  return it == m_CostOverrides.end() ? pE->Cost() : it->second;
+}
+
+//----------------------------- CalculateKey ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+typename Graph_SearchDStarLite_TS<graph_type, heuristic>::Key
+Graph_SearchDStarLite_TS<graph_type, heuristic>::CalculateKey(int nd)const
+{
+  const double cost = std::min(G(nd), RHS(nd));
+
+  if (cost == MaxDouble) return Key(MaxDouble, MaxDouble);
+
+  return Key(cost + heuristic::Calculate(m_Graph, m_iSource, nd) + m_dKeyModifier, cost);
+}
+
+//-------------------------------- isLess -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+bool Graph_SearchDStarLite_TS<graph_type, heuristic>::isLess(const Key& lhs, const Key& rhs)
+{
+  if (fabs(lhs.first - rhs.first) > Rounding(lhs, rhs)) return lhs.first < rhs.first;
+
+  return lhs.second < rhs.second;
+}
+
+//---------------------------- isQueuedBefore ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+bool Graph_SearchDStarLite_TS<graph_type, heuristic>::isQueuedBefore(const Key& key)const
+{
+  typename std::set<QueueEntry>::const_iterator entry = m_Queue.begin();
+
+  for (entry; entry != m_Queue.end(); ++entry)
+  {
+    //the rest of the queue is further above key than the rounding
+    if (entry->first.first - key.first > Rounding(entry->first, key)) return false;
+
+    if (isLess(entry->first, key)) return true;
+  }
+
+  return false;
+}
+
+//--------------------------- Enqueue / Dequeue -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::Enqueue(int nd)
+{
+  const Key key = CalculateKey(nd);
+
+  Touch(nd);
+
+  m_pWorkspace->Key(nd) = key.first;
+
+  m_Queue.insert(QueueEntry(key, nd));
+}
+
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::Dequeue(int nd)
+{
+  if (!isQueued(nd)) return;
+
+  m_Queue.erase(QueueEntry(Key(m_pWorkspace->Key(nd), std::min(G(nd), RHS(nd))), nd));
+
+  m_pWorkspace->Key(nd) = not_queued;
+}
+
+//------------------------------ UpdateNode -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::UpdateNode(int nd)
+{
+  Dequeue(nd);
+
+  if (nd != m_iTarget)
+  {
+    double rhs = MaxDouble;
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const Edge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      if (G(pE->To()) != MaxDouble)
+      {
+        rhs = std::min(rhs, G(pE->To()) + EdgeCost(pE));
+      }
+    }
+
+    SetRHS(nd, rhs);
+  }
+
+  if (G(nd) != RHS(nd)) Enqueue(nd);
+}
+
+//------------------------------ MoveSource -----------------------------------
+//
+//  rather than recalculate the key of every node on the queue, keys are
+//  allowed to fall short by the distance the source has moved, which keeps
+//  them lower bounds. Each is corrected when it reaches the front
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::MoveSource(int NewSource)
+{
+  m_dKeyModifier += heuristic::Calculate(m_Graph, m_iSource, NewSource);
+
+  m_iSource = NewSource;
+}
+
+//------------------------------ MoveTarget -----------------------------------
+//
+//  the search can carry on from any costs, so long as each node's rhs is
+//  worked out from them and every inconsistent node is queued. The nodes
+//  whose cheapest path to the old target passes through the new one keep
+//  the cost of the rest of that path, which is their cost to the new
+//  target. Every other node is given the cost of going on from the old
+//  target to the new one, and only those with a cheaper path need to be
+//  expanded again. The queue is rebuilt, so the keys are exact again
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::MoveTarget(int NewTarget)
+{
+  if (NewTarget == m_iTarget) return;
+
+  //find the nodes by following the cheapest edges back from the new
+  //target. A consistent node's cost is more than that of the node its
+  //cheapest edge leads to, so this can't go round in a circle
+  const double NewTargetCost = G(NewTarget);
+
+  m_Subtree.clear();
+
+  if (NewTargetCost != MaxDouble) m_Subtree.push_back(NewTarget);
+
+  for (unsigned int i=0; i<m_Subtree.size(); ++i)
+  {
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, m_Subtree[i]);
+
+    for (const Edge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      const int nd = pE->To();
+
+      if (nd == m_iTarget || G(nd) == MaxDouble || G(nd) != RHS(nd)) continue;
+
+      const Edge* pBest = BestEdgeFrom(nd);
+
+      if (pBest && pBest->To() == m_Subtree[i]) m_Subtree.push_back(nd);
+    }
+  }
+
+  //their new costs are held in their rhs while the other nodes' costs are
+  //extended
+  for (unsigned int i=0; i<m_Subtree.size(); ++i)
+  {
+    m_pWorkspace->Lookahead(m_Subtree[i]) = G(m_Subtree[i]) - NewTargetCost;
+  }
+
+  m_Queue.clear();
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (!m_pWorkspace->isTouched(nd)) continue;
+
+    if (NewTargetCost == MaxDouble) m_pWorkspace->Cost(nd)  = MaxDouble;
+    else if (G(nd) != MaxDouble)    m_pWorkspace->Cost(nd) += NewTargetCost;
+
+    m_pWorkspace->Key(nd) = not_queued;
+  }
+
+  for (unsigned int i=0; i<m_Subtree.size(); ++i)
+  {
+    m_pWorkspace->Cost(m_Subtree[i]) = m_pWorkspace->Lookahead(m_Subtree[i]);
+  }
+
+  m_iTarget      = NewTarget;
+  m_dKeyModifier = 0.0;
+
+  SetRHS(m_iTarget, 0.0);
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (m_pWorkspace->isTouched(nd)) UpdateNode(nd);
+  }
+}
+
+//------------------------------ SetEdgeCost ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+void Graph_SearchDStarLite_TS<graph_type, heuristic>::SetEdgeCost(int from, int to, double cost)
+{
+  m_CostOverrides[std::make_pair(from, to)] = cost;
+  m_CostOverrides[std::make_pair(to, from)] = cost;
+
+  UpdateNode(from);
+  UpdateNode(to);
+}
+
+//------------------------------- CycleOnce -----------------------------------
+//
+//  expands the node at the front of the queue. The search terminates once
+//  the source is consistent and no node on the queue could lower its cost
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+int Graph_SearchDStarLite_TS<graph_type, heuristic>::CycleOnce()
+{
+  if (m_Queue.empty() ||
+      (!isQueuedBefore(CalculateKey(m_iSource)) && RHS(m_iSource) == G(m_iSource)))
+  {
+    return G(m_iSource) == MaxDouble ? target_not_found : target_found;
+  }
+
+  const Key OldKey = m_Queue.begin()->first;
+  const int nd     = m_Queue.begin()->second;
+  const Key NewKey = CalculateKey(nd);
+
+  ++m_iNumExpansions;
+
+  Dequeue(nd);
+
+  //the key is out of date because the source has moved
+  if (OldKey < NewKey)
+  {
+    Enqueue(nd);
+  }
+
+  //the node's cost has fallen so its neighbours' may have too
+  else if (G(nd) > RHS(nd))
+  {
+    SetG(nd, RHS(nd));
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const Edge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      UpdateNode(pE->To());
+    }
+  }
+
+  //the node's cost has risen, so it and its neighbours must be recalculated
+  else
+  {
+    SetG(nd, MaxDouble);
+
+    UpdateNode(nd);
+
+    typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+    for (const Edge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+    {
+      UpdateNode(pE->To());
+    }
+  }
+
+  return search_incomplete;
+}
+
+//----------------------------- BestEdgeFrom ----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+const typename graph_type::EdgeType*
+Graph_SearchDStarLite_TS<graph_type, heuristic>::BestEdgeFrom(int nd)const
+{
+  const Edge* pBest    = NULL;
+  double      BestCost = MaxDouble;
+
+  typename graph_type::ConstEdgeIterator EdgeItr(m_Graph, nd);
+
+  for (const Edge* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+  {
+    if (G(pE->To()) == MaxDouble) continue;
+
+    const double cost = EdgeCost(pE) + G(pE->To());
+
+    if (cost < BestCost)
+    {
+      BestCost = cost;
+      pBest    = pE;
+    }
+  }
+
+  return pBest;
+}
+
+//----------------------------- GetPathEdges ----------------------------------
+//
+//  if the costs are consistent the cheapest edges lead to the target. If
+//  they aren't, a node may have no edge to follow or the edges may go round
+//  in a circle, so a path that hasn't reached the target after visiting
+//  every node is abandoned
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::vector<const typename graph_type::EdgeType*>
+Graph_SearchDStarLite_TS<graph_type, heuristic>::GetPathEdges()const
+{
+  std::vector<const Edge*> edges;
+
+  if (G(m_iSource) == MaxDouble) return edges;
+
+  int nd = m_iSource;
+
+  while (nd != m_iTarget)
+  {
+    const Edge* pE = BestEdgeFrom(nd);
+
+    if (pE == NULL || (int)edges.size() >= m_Graph.NumNodes())
+    {
+      edges.clear(); break;
+    }
+
+    edges.push_back(pE);
+
+    nd = pE->To();
+  }
+
+  return edges;
+}
+
+//-------------------------------- GetSPT -------------------------------------
+//
+//  the edge each node with a known cost would follow towards the target
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::vector<const typename graph_type::EdgeType*>
+Graph_SearchDStarLite_TS<graph_type, heuristic>::GetSPT()const
+{
+  std::vector<const Edge*> spt(m_Graph.NumNodes(), NULL);
+
+  for (int nd=0; nd<m_Graph.NumNodes(); ++nd)
+  {
+    if (nd != m_iTarget && G(nd) != MaxDouble) spt[nd] = BestEdgeFrom(nd);
+  }
+
+  return spt;
+}
+
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::list<int>
+Graph_SearchDStarLite_TS<graph_type, heuristic>::GetPathToTarget()const
+{
+  std::list<int> path;
+
+  if (G(m_iSource) == MaxDouble) return path;
+
+  std::vector<const Edge*> edges = GetPathEdges();
+
+  if (edges.empty() && m_iSource != m_iTarget) return path;
+
+  path.push_back(m_iSource);
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    path.push_back(edges[e]->To());
+  }
+
+  return path;
+}
+
+//-------------------------- GetPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type, class heuristic>
+std::list<PathEdge>
+Graph_SearchDStarLite_TS<graph_type, heuristic>::GetPathAsPathEdges()const
+{
+  std::list<PathEdge> path;
+
+  std::vector<const Edge*> edges = GetPathEdges();
+
+  for (unsigned int e=0; e<edges.size(); ++e)
+  {
+    const Edge* pE = edges[e];
+
+    path.push_back(PathEdge(m_Graph.GetNode(pE->From()).Pos(),
+                            m_Graph.GetNode(pE->To()).Pos(),
+                            pE->Flags(),
+                            pE->IDofIntersectingEntity(),
+                            pE->From(),
+                            pE->To()));
   }
 
   return path;
 }
 
-#endif
\ No newline at end of file
+#endif
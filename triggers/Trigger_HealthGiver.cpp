@@ -15,6 +15,17 @@ Trigger_HealthGiver::Trigger_HealthGiver(std::ifstream& datafile):
   Read(datafile);
 }
 
+Trigger_HealthGiver::Trigger_HealthGiver(int      id,
+                                         Vector2D pos,
+                                         double   radius,
+                                         int      HealthGiven,
+                                         int      GraphNodeIndex):
+
+     Trigger_Respawning<Raven_Bot>(id)
+{
+  Init(pos, radius, HealthGiven, GraphNodeIndex);
+}
+
 
 void Trigger_HealthGiver::Try(Raven_Bot* pBot)
 {
@@ -45,12 +56,20 @@ void Trigger_HealthGiver::Render()
 void Trigger_HealthGiver::Read(std::ifstream& in)
 {
   double x, y, r;
-  int GraphNodeIndex;
+  int HealthGiven, GraphNodeIndex;
   
-  in >> x >> y  >> r >> m_iHealthGiven >> GraphNodeIndex;
+  in >> x >> y  >> r >> HealthGiven >> GraphNodeIndex;
+
+  Init(Vector2D(x,y), r, HealthGiven, GraphNodeIndex);
+}
+
+
+void Trigger_HealthGiver::Init(Vector2D pos, double radius, int HealthGiven, int GraphNodeIndex)
+{
+  m_iHealthGiven = HealthGiven;
 
-  SetPos(Vector2D(x,y)); 
-  SetBRadius(r);
+  SetPos(pos); 
+  SetBRadius(radius);
   SetGraphNodeIndex(GraphNodeIndex);
 
   //create this trigger's region of fluence
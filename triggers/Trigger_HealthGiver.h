@@ -24,11 +24,21 @@ private:
 
   //the amount of health an entity receives when it runs over this trigger
   int   m_iHealthGiven;
+
+  //sets up the trigger once its properties have been read
+  void  Init(Vector2D pos, double radius, int HealthGiven, int GraphNodeIndex);
   
 public:
 
   Trigger_HealthGiver(std::ifstream& datafile);
 
+  //this ctor is used when loading a binary map
+  Trigger_HealthGiver(int      id,
+                      Vector2D pos,
+                      double   radius,
+                      int      HealthGiven,
+                      int      GraphNodeIndex);
+
   //if triggered, the bot's health will be incremented
   void Try(Raven_Bot* pBot);
   
@@ -11,7 +11,7 @@
 //-----------------------------------------------------------------------------
 #include "Triggers/Trigger.h"
 #include "Messaging/MessageDispatcher.h"
-#include "misc/cgdi.h"
+#include "misc/Cgdi.h"
 
 template <class entity_type>
 class Trigger_OnButtonSendMsg : public Trigger<entity_type>
@@ -24,6 +24,9 @@ private:
   //the message that is sent
   int             m_iMessageToSend;
 
+  //sets up the trigger once its properties have been read
+  void Init(unsigned int receiver, int MessageToSend, Vector2D pos, double radius);
+
 public:
 
   Trigger_OnButtonSendMsg(std::ifstream& datafile):
@@ -33,6 +36,18 @@ public:
      Read(datafile);
    }
 
+  //this ctor is used when loading a binary map
+  Trigger_OnButtonSendMsg(int          id,
+                          unsigned int receiver,
+                          int          MessageToSend,
+                          Vector2D     pos,
+                          double       radius):
+
+      Trigger<entity_type>(id)
+  {
+    Init(receiver, MessageToSend, pos, radius);
+  }
+
   void Try(entity_type* pEnt);
 
   void Update();
@@ -54,7 +69,7 @@ template <class entity_type>
 void  Trigger_OnButtonSendMsg<entity_type>::Try(entity_type* pEnt)
 {
 
-  if (isTouchingTrigger(pEnt->Pos(), pEnt->BRadius()))
+  if (this->isTouchingTrigger(pEnt->Pos(), pEnt->BRadius()))
   {
       Dispatcher->DispatchMsg(SEND_MSG_IMMEDIATELY,
                               this->ID(),
@@ -75,33 +90,47 @@ void Trigger_OnButtonSendMsg<entity_type>::Render()
 {
  gdi->OrangePen();
 
-  double sz = BRadius();  
+  double sz = this->BRadius();  
 
-  gdi->Line(Pos().x - sz, Pos().y - sz, Pos().x + sz, Pos().y - sz);
-  gdi->Line(Pos().x + sz, Pos().y - sz, Pos().x + sz, Pos().y + sz);
-  gdi->Line(Pos().x + sz, Pos().y + sz, Pos().x - sz, Pos().y + sz);
-  gdi->Line(Pos().x - sz, Pos().y + sz, Pos().x - sz, Pos().y - sz);
+  gdi->Line(this->Pos().x - sz, this->Pos().y - sz, this->Pos().x + sz, this->Pos().y - sz);
+  gdi->Line(this->Pos().x + sz, this->Pos().y - sz, this->Pos().x + sz, this->Pos().y + sz);
+  gdi->Line(this->Pos().x + sz, this->Pos().y + sz, this->Pos().x - sz, this->Pos().y + sz);
+  gdi->Line(this->Pos().x - sz, this->Pos().y + sz, this->Pos().x - sz, this->Pos().y - sz);
 }
 
 template <class entity_type>
 void Trigger_OnButtonSendMsg<entity_type>::Read(std::ifstream& is)
 {
   //grab the id of the entity it messages
-  is >> m_iReceiver;
+  unsigned int receiver;
+  is >> receiver;
 
   //grab the message type
-  is >> m_iMessageToSend;
+  int MessageToSend;
+  is >> MessageToSend;
 
   //grab the position and radius
   double x,y,r;
   is >> x >> y >> r;
 
-  SetPos(Vector2D(x,y));
-  SetBRadius(r);
+  Init(receiver, MessageToSend, Vector2D(x,y), r);
+}
+
+template <class entity_type>
+void Trigger_OnButtonSendMsg<entity_type>::Init(unsigned int receiver,
+                                                int          MessageToSend,
+                                                Vector2D     pos,
+                                                double       radius)
+{
+  m_iReceiver      = receiver;
+  m_iMessageToSend = MessageToSend;
+
+  this->SetPos(pos);
+  this->SetBRadius(radius);
 
   //create and set this trigger's region of fluence
-  AddRectangularTriggerRegion(Pos()-Vector2D(BRadius(), BRadius()),   //top left corner
-                              Pos()+Vector2D(BRadius(), BRadius()));  //bottom right corner
+  this->AddRectangularTriggerRegion(this->Pos()-Vector2D(this->BRadius(), this->BRadius()),   //top left corner
+                              this->Pos()+Vector2D(this->BRadius(), this->BRadius()));  //bottom right corner
 }
 
 template <class entity_type>
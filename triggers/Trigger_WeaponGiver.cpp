@@ -16,6 +16,22 @@ Trigger_WeaponGiver::Trigger_WeaponGiver(std::ifstream& datafile):
 {
   Read(datafile);
 
+  CreateVertexBuffers();
+}
+
+
+Trigger_WeaponGiver::Trigger_WeaponGiver(int id, Vector2D pos, double radius, int GraphNodeIndex):
+
+          Trigger_Respawning<Raven_Bot>(id)
+{
+  Init(pos, radius, GraphNodeIndex);
+
+  CreateVertexBuffers();
+}
+
+
+void Trigger_WeaponGiver::CreateVertexBuffers()
+{
   //create the vertex buffer for the rocket shape
   const int NumRocketVerts = 8;
   const Vector2D rip[NumRocketVerts] = {Vector2D(0, 3),
@@ -69,8 +85,14 @@ void Trigger_WeaponGiver::Read(std::ifstream& in)
   
   in >>  x >> y  >> r >> GraphNodeIndex;
 
-  SetPos(Vector2D(x,y)); 
-  SetBRadius(r);
+  Init(Vector2D(x,y), r, GraphNodeIndex);
+}
+
+
+void Trigger_WeaponGiver::Init(Vector2D pos, double radius, int GraphNodeIndex)
+{
+  SetPos(pos); 
+  SetBRadius(radius);
   SetGraphNodeIndex(GraphNodeIndex);
 
   //create this trigger's region of fluence
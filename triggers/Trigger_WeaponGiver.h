@@ -27,12 +27,21 @@ private:
   std::vector<Vector2D>         m_vecRLVBTrans;
   std::vector<Vector2D>         m_vecGrenade;
   std::vector<Vector2D>         m_vecGrenadeTrans;
+
+  //sets up the trigger once its properties have been read
+  void Init(Vector2D pos, double radius, int GraphNodeIndex);
+
+  void CreateVertexBuffers();
   
 public:
 
   //this type of trigger is created when reading a map file
   Trigger_WeaponGiver(std::ifstream& datafile);
 
+  //this ctor is used when loading a binary map. The weapon type must be
+  //set with SetEntityType
+  Trigger_WeaponGiver(int id, Vector2D pos, double radius, int GraphNodeIndex);
+
   //if triggered, this trigger will call the PickupWeapon method of the
   //bot. PickupWeapon will instantiate a weapon of the appropriate type.
   void Try(Raven_Bot*);